@@ -0,0 +1,328 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ebtn.h"
+
+/*
+ * Benchmark of ebtn_process, prints CSV to stdout.
+ *
+ * Each case runs one button group for a number of 1 ms ticks, with buttons count, combo-buttons count,
+ * static, dynamic or bulk read registration and input activity as variables. Result is time per ebtn_process call
+ * and time per event. Build with the same config macros as the target to compare configs.
+ */
+
+#define BENCH_MAX_KEYNUM   (4096)
+#define BENCH_MAX_COMBONUM (64)
+#define BENCH_COMBO_KEY_ID (0x8000) /* key_id of first combo-button, after all buttons */
+#define BENCH_WARMUP_TICKS (100)
+#define BENCH_REPEAT       (5) /* Best of repeats is reported, against noise of other load */
+
+typedef enum
+{
+    BENCH_REG_STATIC = 0, /* Buttons in static array */
+    BENCH_REG_DYNAMIC,    /* Buttons registered by ebtn_register_bulk_ex */
+    BENCH_REG_BULK,       /* Buttons in static array, state read by ebtn_get_state_bulk_fn */
+} bench_reg_t;
+
+typedef enum
+{
+    BENCH_ACT_IDLE = 0, /* All buttons released */
+    BENCH_ACT_1PCT,     /* One of every 100 buttons clicks once a second */
+    BENCH_ACT_STORM,    /* All buttons toggle every 30 ms */
+} bench_act_t;
+
+typedef struct
+{
+    int btn_num;
+    int combo_num;
+    bench_reg_t reg;
+    bench_act_t act;
+} bench_case_t;
+
+static const char *const bench_reg_name[] = {"static", "dynamic", "bulk"};
+static const char *const bench_act_name[] = {"idle", "1pct", "storm"};
+
+static const ebtn_btn_param_t bench_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t bench_group;
+static ebtn_btn_t bench_btns[BENCH_MAX_KEYNUM];
+static ebtn_btn_dyn_t bench_btns_dyn[BENCH_MAX_KEYNUM];
+static ebtn_btn_combo_t bench_combos[BENCH_MAX_COMBONUM];
+static BIT_ARRAY_DEFINE(bench_combo_keys[BENCH_MAX_COMBONUM], BENCH_MAX_KEYNUM);
+
+static EBTN_STATE_STORAGE_DEFINE(bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+static ebtn_btn_t *bench_key_hash[EBTN_KEY_HASH_SIZE(BENCH_MAX_KEYNUM)];
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+static bit_array_t bench_combo_index[EBTN_COMBO_INDEX_STORAGE_SIZE(BENCH_MAX_KEYNUM, BENCH_MAX_COMBONUM)];
+static ebtn_btn_combo_t *bench_combo_ptr[BENCH_MAX_COMBONUM];
+#endif
+#ifdef EBTN_CONFIG_SOA
+static EBTN_SOA_STORAGE_DEFINE(bench_soa_storage, BENCH_MAX_KEYNUM);
+#endif
+
+static bench_act_t bench_act;
+static uint32_t bench_now;
+static unsigned long bench_evt_cnt;
+
+static uint8_t prv_bench_get_state(struct ebtn_btn *btn)
+{
+    uint32_t key = btn->key_id;
+
+    switch (bench_act)
+    {
+        case BENCH_ACT_1PCT:
+            return (key % 100) == 0 && ((bench_now + key * 7) % 1000) < 150;
+        case BENCH_ACT_STORM:
+            return ((bench_now + key * 3) % 60) < 30;
+        default:
+            return 0;
+    }
+}
+
+static void prv_bench_get_state_bulk(ebtn_t *ebtobj, bit_array_t *state, int word_begin, int word_end, void *arg)
+{
+    int w, b;
+
+    (void)ebtobj;
+    (void)arg;
+    /* Same input as prv_bench_get_state, key_id is key_idx of static buttons */
+    for (w = word_begin; w < word_end; w++)
+    {
+        bit_array_val_t val = 0;
+        uint32_t key = (uint32_t)w * BIT_ARRAY_BITS;
+
+        switch (bench_act)
+        {
+            case BENCH_ACT_1PCT:
+                for (b = 0; b < (int)BIT_ARRAY_BITS; b++, key++)
+                {
+                    val |= (bit_array_val_t)((key % 100) == 0 && ((bench_now + key * 7) % 1000) < 150) << b;
+                }
+                break;
+            case BENCH_ACT_STORM:
+                for (b = 0; b < (int)BIT_ARRAY_BITS; b++, key++)
+                {
+                    val |= (bit_array_val_t)(((bench_now + key * 3) % 60) < 30) << b;
+                }
+                break;
+            default:
+                break;
+        }
+        state[w] = val;
+    }
+}
+
+static void prv_bench_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    (void)btn;
+    (void)evt;
+    bench_evt_cnt++;
+}
+
+static double prv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static const char *prv_bench_config(void)
+{
+    static char config[128];
+    static const char *const names[] = {
+#ifdef EBTN_CONFIG_TIMER_16
+            "timer16",
+#endif
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+            "wheel",
+#endif
+#ifdef EBTN_CONFIG_SOA
+            "soa",
+#endif
+#ifdef EBTN_CONFIG_SIMD
+            "simd",
+#endif
+#ifdef EBTN_CONFIG_KEY_INDEX
+            "keyindex",
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+            "comboindex",
+#endif
+#ifdef BIT_ARRAY_CONFIG_64
+            "bit64",
+#endif
+#ifdef EBTN_CONFIG_STATS
+            "stats",
+#endif
+#ifdef EBTN_CONFIG_NO_KEEPALIVE
+            "nokeepalive",
+#endif
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+            "coalesce",
+#endif
+#ifdef EBTN_CONFIG_NO_MULTICLICK
+            "nomulticlick",
+#endif
+#ifdef EBTN_CONFIG_FIXED_PARAMS
+            "fixed",
+#endif
+            NULL,
+    };
+    size_t i;
+
+    strcpy(config, names[0] == NULL ? "default" : "");
+    for (i = 0; names[i] != NULL; i++)
+    {
+        if (i > 0)
+        {
+            strcat(config, "+");
+        }
+        strcat(config, names[i]);
+    }
+    return config;
+}
+
+static void prv_bench_setup(const bench_case_t *bc)
+{
+    int static_num = bc->reg != BENCH_REG_DYNAMIC ? bc->btn_num : 0;
+    int i;
+
+    for (i = 0; i < bc->btn_num; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &bench_param);
+        ebtn_btn_dyn_t btn_dyn = EBTN_BUTTON_DYN_INIT(i, &bench_param);
+        bench_btns[i] = btn;
+        bench_btns_dyn[i] = btn_dyn;
+    }
+    memset(bench_combo_keys, 0x00, sizeof(bench_combo_keys));
+    for (i = 0; i < bc->combo_num; i++)
+    {
+        ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_EXT_INIT(BENCH_COMBO_KEY_ID + i, &bench_param, bench_combo_keys[i]);
+        bench_combos[i] = combo;
+    }
+
+    ebtn_init_ex(&bench_group, bench_btns, static_num, bench_combos, bc->combo_num, prv_bench_get_state, prv_bench_event);
+    ebtn_set_state_storage_ex(&bench_group, bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+    ebtn_set_key_index_storage_ex(&bench_group, bench_key_hash, EBTN_ARRAY_SIZE(bench_key_hash));
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    ebtn_set_combo_index_storage_ex(&bench_group, bench_combo_index, bench_combo_ptr, BENCH_MAX_KEYNUM, BENCH_MAX_COMBONUM);
+#endif
+#ifdef EBTN_CONFIG_SOA
+    {
+        ebtn_soa_t soa = EBTN_SOA_INIT(bench_soa_storage);
+        ebtn_set_soa_storage_ex(&bench_group, &soa, BENCH_MAX_KEYNUM);
+    }
+#endif
+
+    if (bc->reg == BENCH_REG_DYNAMIC)
+    {
+        ebtn_register_bulk_ex(&bench_group, bench_btns_dyn, bc->btn_num);
+    }
+    else if (bc->reg == BENCH_REG_BULK)
+    {
+        ebtn_set_get_state_bulk_ex(&bench_group, prv_bench_get_state_bulk, NULL);
+    }
+
+    /* Every combo-button binds two neighbour buttons */
+    for (i = 0; i < bc->combo_num; i++)
+    {
+        ebtn_combo_btn_add_btn_by_idx_ex(&bench_group, &bench_combos[i], (2 * i) % bc->btn_num);
+        ebtn_combo_btn_add_btn_by_idx_ex(&bench_group, &bench_combos[i], (2 * i + 1) % bc->btn_num);
+    }
+}
+
+static void prv_bench_run(const bench_case_t *bc)
+{
+    int ticks = 4000000 / bc->btn_num;
+    double start, elapsed, best = 0;
+    unsigned long best_evt_cnt = 0;
+    int i, r;
+
+    if (ticks < 1000)
+    {
+        ticks = 1000;
+    }
+    if (ticks > 20000)
+    {
+        ticks = 20000;
+    }
+
+    bench_act = bc->act;
+    prv_bench_setup(bc);
+
+    for (bench_now = 0; bench_now < BENCH_WARMUP_TICKS; bench_now++)
+    {
+        ebtn_process_ex(&bench_group, (ebtn_time_t)bench_now);
+    }
+
+    for (r = 0; r < BENCH_REPEAT; r++)
+    {
+        bench_evt_cnt = 0;
+        start = prv_bench_now_ns();
+        for (i = 0; i < ticks; i++, bench_now++)
+        {
+            ebtn_process_ex(&bench_group, (ebtn_time_t)bench_now);
+        }
+        elapsed = prv_bench_now_ns() - start;
+        if (r == 0 || elapsed < best)
+        {
+            best = elapsed;
+            best_evt_cnt = bench_evt_cnt;
+        }
+    }
+
+    printf("%s,%d,%d,%s,%s,%d,%.1f,%lu,%.1f\n", prv_bench_config(), bc->btn_num, bc->combo_num, bench_reg_name[bc->reg], bench_act_name[bc->act], ticks,
+           best / ticks, best_evt_cnt, best_evt_cnt ? best / best_evt_cnt : 0.0);
+}
+
+int main(void)
+{
+    static const int btn_nums[] = {8, 64, 4096};
+    static const int combo_nums[] = {8, 64};
+    bench_case_t bc;
+    size_t n, c;
+    int reg, act;
+
+    printf("config,buttons,combos,registration,activity,ticks,ns_per_process,events,ns_per_event\n");
+
+    /* Scaling with buttons count, registration and activity */
+    for (n = 0; n < EBTN_ARRAY_SIZE(btn_nums); n++)
+    {
+        for (reg = BENCH_REG_STATIC; reg <= BENCH_REG_BULK; reg++)
+        {
+            for (act = BENCH_ACT_IDLE; act <= BENCH_ACT_STORM; act++)
+            {
+                bc.btn_num = btn_nums[n];
+                bc.combo_num = 0;
+                bc.reg = (bench_reg_t)reg;
+                bc.act = (bench_act_t)act;
+                prv_bench_run(&bc);
+            }
+        }
+    }
+
+    /* Scaling with combo-buttons count */
+    for (n = 1; n < EBTN_ARRAY_SIZE(btn_nums); n++)
+    {
+        for (c = 0; c < EBTN_ARRAY_SIZE(combo_nums); c++)
+        {
+            for (act = BENCH_ACT_IDLE; act <= BENCH_ACT_STORM; act++)
+            {
+                bc.btn_num = btn_nums[n];
+                bc.combo_num = combo_nums[c];
+                bc.reg = BENCH_REG_STATIC;
+                bc.act = (bench_act_t)act;
+                prv_bench_run(&bc);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ebtn.h"
+#include "ebtn_matrix.h"
+
+/*
+ * Benchmark of keyboard matrix scanning, prints CSV to stdout.
+ *
+ * A simulated matrix without diodes, pressed keys connect rows and columns, so three corners of a rectangle
+ * make the fourth one read active. Every case runs one 1 ms tick per scan with matrix size and input activity
+ * as variables, and compares ebtn_matrix_poll with a per-button get_state_fn selecting the row and reading
+ * the column of its own key. Result is time per tick.
+ */
+
+#define BENCH_MAX_ROWS   (32)
+#define BENCH_MAX_KEYNUM (BENCH_MAX_ROWS * EBTN_MATRIX_MAX_COLS)
+#define BENCH_TICKS      (20000)
+#define BENCH_REPEAT     (5) /* Best of repeats is reported, against noise of other load */
+
+typedef enum
+{
+    BENCH_ACT_IDLE = 0, /* All keys released */
+    BENCH_ACT_TYPING,   /* One key pressed at a time, next key every 50 ms */
+    BENCH_ACT_GHOST,    /* Two keys of a row held, a key under one of them pressed every 100 ms, making a ghost */
+} bench_act_t;
+
+typedef enum
+{
+    BENCH_MODE_MATRIX = 0, /* ebtn_matrix_poll, one select and read per row */
+    BENCH_MODE_PER_BUTTON, /* ebtn_process, one select and read per button */
+} bench_mode_t;
+
+static const char *const bench_act_name[] = {"idle", "typing", "ghost"};
+static const char *const bench_mode_name[] = {"matrix", "per_button"};
+
+static const ebtn_btn_param_t bench_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t bench_group;
+static ebtn_btn_t bench_btns[BENCH_MAX_KEYNUM];
+static EBTN_STATE_STORAGE_DEFINE(bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+static ebtn_btn_t *bench_key_hash[EBTN_KEY_HASH_SIZE(BENCH_MAX_KEYNUM)];
+#endif
+static BIT_ARRAY_DEFINE(bench_curr_state, BENCH_MAX_KEYNUM);
+static EBTN_MATRIX_STORAGE_DEFINE(bench_matrix_storage, BENCH_MAX_ROWS);
+static ebtn_matrix_t bench_matrix;
+
+static int bench_rows, bench_cols;
+static uint32_t bench_pressed[BENCH_MAX_ROWS]; /* Keys really pressed */
+static uint16_t bench_selected;
+static unsigned long bench_evt_cnt;
+
+/* Columns connected to the selected row, through pressed keys of other rows too */
+static uint32_t prv_bench_read_row(uint16_t row)
+{
+    uint32_t cols = bench_pressed[row];
+
+    for (int r = 0; r < bench_rows; r++)
+    {
+        if (r != row && (bench_pressed[r] & cols))
+        {
+            cols |= bench_pressed[r];
+        }
+    }
+    return cols;
+}
+
+static void prv_bench_select(struct ebtn_matrix *matrix, uint16_t row)
+{
+    (void)matrix;
+    bench_selected = row;
+}
+
+static uint32_t prv_bench_read(struct ebtn_matrix *matrix, uint16_t row)
+{
+    (void)matrix;
+    (void)row;
+    return prv_bench_read_row(bench_selected);
+}
+
+static uint8_t prv_bench_get_state(struct ebtn_btn *btn)
+{
+    uint16_t row = btn->key_id / bench_cols;
+
+    bench_selected = row;
+    return (prv_bench_read_row(bench_selected) >> (btn->key_id % bench_cols)) & 0x01;
+}
+
+static void prv_bench_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    (void)btn;
+    (void)evt;
+    bench_evt_cnt++;
+}
+
+static void prv_bench_input(bench_act_t act, uint32_t now)
+{
+    memset(bench_pressed, 0x00, sizeof(bench_pressed));
+    switch (act)
+    {
+        case BENCH_ACT_TYPING:
+            if ((now % 50) < 30)
+            {
+                uint32_t key = (now / 50) % (bench_rows * bench_cols);
+                bench_pressed[key / bench_cols] |= (uint32_t)1 << (key % bench_cols);
+            }
+            break;
+        case BENCH_ACT_GHOST:
+            bench_pressed[0] = 0x03;
+            if ((now % 100) >= 50)
+            {
+                bench_pressed[bench_rows - 1] = 0x01;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static double prv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void prv_bench_setup(bench_mode_t mode)
+{
+    int num = bench_rows * bench_cols;
+
+    for (int i = 0; i < num; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &bench_param);
+        bench_btns[i] = btn;
+    }
+
+    ebtn_init_ex(&bench_group, bench_btns, num, NULL, 0, mode == BENCH_MODE_PER_BUTTON ? prv_bench_get_state : NULL, prv_bench_event);
+    ebtn_set_state_storage_ex(&bench_group, bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+    ebtn_set_key_index_storage_ex(&bench_group, bench_key_hash, EBTN_ARRAY_SIZE(bench_key_hash));
+#endif
+
+    memset(bench_curr_state, 0x00, sizeof(bench_curr_state));
+    ebtn_matrix_init(&bench_matrix, &bench_group, bench_curr_state, 0, bench_rows, bench_cols, bench_matrix_storage, prv_bench_select, prv_bench_read);
+    ebtn_matrix_set_scan_rate(&bench_matrix, 1, 1);
+}
+
+static void prv_bench_run(bench_mode_t mode, bench_act_t act)
+{
+    double start, elapsed, best = 0;
+    unsigned long best_evt_cnt = 0;
+    uint32_t now = 0;
+
+    prv_bench_setup(mode);
+
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        bench_evt_cnt = 0;
+        start = prv_bench_now_ns();
+        for (int i = 0; i < BENCH_TICKS; i++, now++)
+        {
+            prv_bench_input(act, now);
+            if (mode == BENCH_MODE_MATRIX)
+            {
+                ebtn_matrix_poll(&bench_matrix, (ebtn_time_t)now);
+            }
+            else
+            {
+                ebtn_process_ex(&bench_group, (ebtn_time_t)now);
+            }
+        }
+        elapsed = prv_bench_now_ns() - start;
+        if (r == 0 || elapsed < best)
+        {
+            best = elapsed;
+            best_evt_cnt = bench_evt_cnt;
+        }
+    }
+
+    printf("%dx%d,%s,%s,%d,%.1f,%lu,%lu\n", bench_rows, bench_cols, bench_mode_name[mode], bench_act_name[act], BENCH_TICKS, best / BENCH_TICKS,
+           best_evt_cnt, (unsigned long)bench_matrix.ghost_scans);
+}
+
+int main(void)
+{
+    static const int sizes[] = {4, 8, 16, 32};
+    int mode, act;
+
+    printf("matrix,mode,activity,ticks,ns_per_tick,events,ghost_scans\n");
+
+    for (size_t n = 0; n < EBTN_ARRAY_SIZE(sizes); n++)
+    {
+        bench_rows = sizes[n];
+        bench_cols = sizes[n];
+        for (mode = BENCH_MODE_MATRIX; mode <= BENCH_MODE_PER_BUTTON; mode++)
+        {
+            for (act = BENCH_ACT_IDLE; act <= BENCH_ACT_GHOST; act++)
+            {
+                prv_bench_run((bench_mode_t)mode, (bench_act_t)act);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "ebtn.h"
+
+/*
+ * Benchmark of sharded processing, prints CSV to stdout.
+ *
+ * One large button group is processed by ebtn_process_sharded_ex with a simple worker pool of 1, 2, 4... threads,
+ * one shard per thread, and compared with single thread ebtn_process_with_curr_state_ex.
+ * Usage: ebtn_shard_bench [buttons] [ticks] [max_threads]
+ */
+
+#define BENCH_MAX_KEYNUM    (65535) /* Max number of static buttons of a button group */
+#define BENCH_MAX_THREADS   (64)
+#define BENCH_EVT_PER_SHARD (16384)
+#define BENCH_REPEAT        (3) /* Best of repeats is reported, against noise of other load */
+
+static const ebtn_btn_param_t bench_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t bench_group;
+static ebtn_btn_t bench_btns[BENCH_MAX_KEYNUM];
+static EBTN_STATE_STORAGE_DEFINE(bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_SOA
+static EBTN_SOA_STORAGE_DEFINE(bench_soa_storage, BENCH_MAX_KEYNUM);
+#endif
+static ebtn_shard_t bench_shards[BENCH_MAX_THREADS];
+static ebtn_shard_evt_t bench_shard_evts[BENCH_MAX_THREADS * BENCH_EVT_PER_SHARD];
+static BIT_ARRAY_DEFINE(bench_curr_state, BENCH_MAX_KEYNUM);
+static unsigned long bench_evt_cnt;
+
+/* Worker pool, calling thread runs shard 0, every worker one other shard */
+static pthread_t pool_threads[BENCH_MAX_THREADS];
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static int pool_worker_num;
+static int pool_gen;
+static int pool_done_cnt;
+static int pool_quit;
+static ebtn_t *pool_job;
+
+static void *prv_pool_worker(void *arg)
+{
+    int shard = (int)(long)arg;
+    int gen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool_lock);
+        while (pool_gen == gen && !pool_quit)
+        {
+            pthread_cond_wait(&pool_start, &pool_lock);
+        }
+        if (pool_quit)
+        {
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+        gen = pool_gen;
+        pthread_mutex_unlock(&pool_lock);
+
+        ebtn_process_shard_ex(pool_job, shard);
+
+        pthread_mutex_lock(&pool_lock);
+        if (++pool_done_cnt == pool_worker_num)
+        {
+            pthread_cond_signal(&pool_done);
+        }
+        pthread_mutex_unlock(&pool_lock);
+    }
+}
+
+static void prv_pool_run(ebtn_t *ebtobj, int shard_cnt, void *arg)
+{
+    (void)shard_cnt;
+    (void)arg;
+
+    pthread_mutex_lock(&pool_lock);
+    pool_job = ebtobj;
+    pool_done_cnt = 0;
+    pool_gen++;
+    pthread_cond_broadcast(&pool_start);
+    pthread_mutex_unlock(&pool_lock);
+
+    ebtn_process_shard_ex(ebtobj, 0);
+
+    pthread_mutex_lock(&pool_lock);
+    while (pool_done_cnt < pool_worker_num)
+    {
+        pthread_cond_wait(&pool_done, &pool_lock);
+    }
+    pthread_mutex_unlock(&pool_lock);
+}
+
+static void prv_pool_start(int threads)
+{
+    int i;
+
+    pool_worker_num = threads - 1;
+    pool_gen = 0;
+    pool_quit = 0;
+    for (i = 0; i < pool_worker_num; i++)
+    {
+        pthread_create(&pool_threads[i], NULL, prv_pool_worker, (void *)(long)(i + 1));
+    }
+}
+
+static void prv_pool_stop(void)
+{
+    int i;
+
+    pthread_mutex_lock(&pool_lock);
+    pool_quit = 1;
+    pthread_cond_broadcast(&pool_start);
+    pthread_mutex_unlock(&pool_lock);
+    for (i = 0; i < pool_worker_num; i++)
+    {
+        pthread_join(pool_threads[i], NULL);
+    }
+}
+
+static void prv_bench_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    (void)btn;
+    (void)evt;
+    bench_evt_cnt++;
+}
+
+static double prv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Every button toggles every 30 ms, with different phases */
+static void prv_bench_input(int btn_num, uint32_t now)
+{
+    int i;
+
+    for (i = 0; i < btn_num; i++)
+    {
+        bit_array_assign(bench_curr_state, i, ((now + (uint32_t)i * 3) % 60) < 30);
+    }
+}
+
+static void prv_bench_setup(int btn_num)
+{
+    int i;
+
+    for (i = 0; i < btn_num; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &bench_param);
+        bench_btns[i] = btn;
+    }
+
+    ebtn_init_ex(&bench_group, bench_btns, (uint16_t)btn_num, NULL, 0, NULL, prv_bench_event);
+    ebtn_set_state_storage_ex(&bench_group, bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_SOA
+    {
+        ebtn_soa_t soa = EBTN_SOA_INIT(bench_soa_storage);
+        ebtn_set_soa_storage_ex(&bench_group, &soa, BENCH_MAX_KEYNUM);
+    }
+#endif
+}
+
+/* Time of processing only, input update not counted */
+static double prv_bench_run(int btn_num, int ticks, int threads)
+{
+    double best = 0;
+    uint32_t now = 0;
+    int i, r;
+
+    prv_bench_setup(btn_num);
+    if (threads > 0)
+    {
+        ebtn_set_shards_ex(&bench_group, bench_shards, threads, bench_shard_evts, BENCH_EVT_PER_SHARD);
+        prv_pool_start(threads);
+    }
+
+    for (r = 0; r < BENCH_REPEAT; r++)
+    {
+        double elapsed = 0;
+
+        bench_evt_cnt = 0;
+        for (i = 0; i < ticks; i++, now++)
+        {
+            double start;
+
+            prv_bench_input(btn_num, now);
+            start = prv_bench_now_ns();
+            if (threads > 0)
+            {
+                ebtn_process_sharded_ex(&bench_group, bench_curr_state, (ebtn_time_t)now, threads > 1 ? prv_pool_run : NULL, NULL);
+            }
+            else
+            {
+                ebtn_process_with_curr_state_ex(&bench_group, bench_curr_state, (ebtn_time_t)now);
+            }
+            elapsed += prv_bench_now_ns() - start;
+        }
+        if (r == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    if (threads > 0)
+    {
+        prv_pool_stop();
+    }
+    return best / ticks;
+}
+
+int main(int argc, char **argv)
+{
+    int btn_num = argc > 1 ? atoi(argv[1]) : BENCH_MAX_KEYNUM;
+    int ticks = argc > 2 ? atoi(argv[2]) : 100;
+    int max_threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double serial, ns;
+    int threads;
+
+    if (btn_num < 1 || btn_num > BENCH_MAX_KEYNUM || ticks < 1 || max_threads < 1 || max_threads > BENCH_MAX_THREADS)
+    {
+        fprintf(stderr, "usage: %s [buttons <= %d] [ticks] [max_threads <= %d]\n", argv[0], BENCH_MAX_KEYNUM, BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    printf("threads,buttons,ticks,ns_per_process,speedup\n");
+
+    serial = prv_bench_run(btn_num, ticks, 0);
+    printf("serial,%d,%d,%.1f,1.00\n", btn_num, ticks, serial);
+
+    for (threads = 1; threads <= max_threads; threads *= 2)
+    {
+        ns = prv_bench_run(btn_num, ticks, threads);
+        printf("%d,%d,%d,%.1f,%.2f\n", threads, btn_num, ticks, ns, serial / ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ebtn.h"
+
+/*
+ * Benchmark of the timeout check kernels, build with EBTN_CONFIG_SOA and EBTN_CONFIG_SIMD.
+ *
+ * All buttons are held down, so every button is in process and waits for its next keep alive.
+ * Each kernel processes the same ticks, result is time per button per tick.
+ */
+
+#define BENCH_MAX_KEYNUM (4096)
+
+static const ebtn_btn_param_t bench_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 1000, 10);
+
+static ebtn_btn_t bench_btns[BENCH_MAX_KEYNUM];
+static ebtn_t bench_group;
+static EBTN_STATE_STORAGE_DEFINE(bench_state_storage, BENCH_MAX_KEYNUM);
+static EBTN_SOA_STORAGE_DEFINE(bench_soa_storage, BENCH_MAX_KEYNUM);
+static unsigned long bench_evt_cnt;
+
+static uint8_t prv_bench_get_state(struct ebtn_btn *btn)
+{
+    (void)btn;
+    return 1;
+}
+
+static void prv_bench_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    (void)btn;
+    (void)evt;
+    bench_evt_cnt++;
+}
+
+static double prv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double prv_bench_run(ebtn_simd_kernel_t kernel, int key_num, int ticks)
+{
+    ebtn_soa_t soa = EBTN_SOA_INIT(bench_soa_storage);
+    ebtn_time_t mstime = 0;
+    double start;
+    int i;
+
+    for (i = 0; i < key_num; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &bench_param);
+        bench_btns[i] = btn;
+    }
+
+    ebtn_init_ex(&bench_group, bench_btns, key_num, NULL, 0, prv_bench_get_state, prv_bench_event);
+    ebtn_set_state_storage_ex(&bench_group, bench_state_storage, BENCH_MAX_KEYNUM);
+    ebtn_set_soa_storage_ex(&bench_group, &soa, BENCH_MAX_KEYNUM);
+    if (!ebtn_simd_select_ex(&bench_group, kernel))
+    {
+        return -1;
+    }
+
+    /* Press all buttons and pass debounce */
+    for (i = 0; i < 100; i++)
+    {
+        ebtn_process_ex(&bench_group, ++mstime);
+    }
+
+    bench_evt_cnt = 0;
+    start = prv_bench_now_ns();
+    for (i = 0; i < ticks; i++)
+    {
+        ebtn_process_ex(&bench_group, ++mstime);
+    }
+    return (prv_bench_now_ns() - start) / ((double)ticks * key_num);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct
+    {
+        ebtn_simd_kernel_t kernel;
+        const char *name;
+    } kernels[] = {
+        {EBTN_SIMD_OFF, "scalar loop"}, {EBTN_SIMD_SCALAR, "scalar kernel"}, {EBTN_SIMD_SSE2, "sse2"}, {EBTN_SIMD_AVX2, "avx2"}, {EBTN_SIMD_NEON, "neon"},
+    };
+    int key_num = argc > 1 ? atoi(argv[1]) : BENCH_MAX_KEYNUM;
+    int ticks = argc > 2 ? atoi(argv[2]) : 2000;
+    double ns;
+    size_t i;
+
+    if (key_num <= 0 || key_num > BENCH_MAX_KEYNUM || ticks <= 0)
+    {
+        printf("usage: %s [key_num <= %d] [ticks]\n", argv[0], BENCH_MAX_KEYNUM);
+        return 1;
+    }
+
+    printf("buttons: %d, ticks: %d\n", key_num, ticks);
+    for (i = 0; i < EBTN_ARRAY_SIZE(kernels); i++)
+    {
+        ns = prv_bench_run(kernels[i].kernel, key_num, ticks);
+        if (ns < 0)
+        {
+            printf("%-14s: not supported\n", kernels[i].name);
+            continue;
+        }
+        printf("%-14s: %8.3f ns/button, %lu events\n", kernels[i].name, ns, bench_evt_cnt);
+    }
+
+    return 0;
+}
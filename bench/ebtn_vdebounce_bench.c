@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ebtn.h"
+#include "ebtn_vdebounce.h"
+
+/*
+ * Benchmark of vertical counter debounce, prints CSV to stdout.
+ *
+ * Raw input is sampled every 1 ms, a line bounces for 3 samples after every edge. Debounce of 4 samples
+ * by ebtn_vdebounce_update, feeding stable bitmap to buttons without debounce, is compared with
+ * the per-button debounce of 4 ms of ebtn_process_with_curr_state_ex on the raw bitmap.
+ * Result is time per sample and per line, `frontend` is ebtn_vdebounce_update alone.
+ */
+
+#define BENCH_MAX_KEYNUM (4096)
+#define BENCH_RING       (200) /* Raw samples are precomputed, input pattern repeats every 200 ms */
+#define BENCH_TICKS      (20000)
+#define BENCH_REPEAT     (5) /* Best of repeats is reported, against noise of other load */
+#define BENCH_SAMPLES    (4)
+
+typedef enum
+{
+    BENCH_ACT_IDLE = 0, /* All lines released */
+    BENCH_ACT_TYPING,   /* One of every 100 lines pressed for 100 ms every 200 ms, with bounce */
+    BENCH_ACT_CHATTER,  /* All lines pressed for 100 ms every 200 ms, with bounce */
+} bench_act_t;
+
+typedef enum
+{
+    BENCH_MODE_ENGINE = 0, /* Per-button debounce of ebtn_process_with_curr_state_ex */
+    BENCH_MODE_VCOUNTER,   /* ebtn_vdebounce_update, then ebtn_process_with_curr_state_ex without debounce */
+    BENCH_MODE_FRONTEND,   /* ebtn_vdebounce_update only */
+} bench_mode_t;
+
+static const char *const bench_act_name[] = {"idle", "typing", "chatter"};
+static const char *const bench_mode_name[] = {"engine", "vcounter", "frontend"};
+
+static const ebtn_btn_param_t bench_param_debounce = EBTN_PARAMS_INIT(BENCH_SAMPLES, BENCH_SAMPLES, 20, 300, 200, 500, 10);
+static const ebtn_btn_param_t bench_param_stable = EBTN_PARAMS_INIT(0, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t bench_group;
+static ebtn_btn_t bench_btns[BENCH_MAX_KEYNUM];
+static EBTN_STATE_STORAGE_DEFINE(bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+static ebtn_btn_t *bench_key_hash[EBTN_KEY_HASH_SIZE(BENCH_MAX_KEYNUM)];
+#endif
+#ifdef EBTN_CONFIG_SOA
+static EBTN_SOA_STORAGE_DEFINE(bench_soa_storage, BENCH_MAX_KEYNUM);
+#endif
+static EBTN_VDEBOUNCE_STORAGE_DEFINE(bench_vd_storage, BENCH_MAX_KEYNUM);
+static ebtn_vdebounce_t bench_vd;
+static bit_array_t bench_raw[BENCH_RING][BIT_ARRAY_BITMAP_SIZE(BENCH_MAX_KEYNUM)];
+static unsigned long bench_evt_cnt;
+
+static void prv_bench_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    (void)btn;
+    (void)evt;
+    bench_evt_cnt++;
+}
+
+static double prv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static const char *prv_bench_kernel(void)
+{
+#ifdef EBTN_CONFIG_SIMD
+    static const char *const names[] = {"auto", "off", "scalar", "sse2", "avx2", "neon"};
+    ebtn_simd_kernel_t kernel = (ebtn_simd_kernel_t)bench_vd.kernel;
+
+    return kernel == EBTN_SIMD_AVX2 || kernel == EBTN_SIMD_SSE2 ? names[kernel] : "scalar";
+#else
+    return "scalar";
+#endif
+}
+
+static void prv_bench_input(bench_act_t act, int num)
+{
+    memset(bench_raw, 0x00, sizeof(bench_raw));
+    if (act == BENCH_ACT_IDLE)
+    {
+        return;
+    }
+
+    for (int t = 0; t < BENCH_RING; t++)
+    {
+        for (int i = 0; i < num; i++)
+        {
+            int phase = (t + i * 7) % BENCH_RING;
+            int state = phase < 100;
+
+            if (act == BENCH_ACT_TYPING && (i % 100) != 0)
+            {
+                continue;
+            }
+            /* Bounce for 3 samples after press and release edges */
+            if ((phase < 3 || (phase >= 100 && phase < 103)) && ((t + i) & 0x01))
+            {
+                state = !state;
+            }
+            bit_array_assign(bench_raw[t], i, state);
+        }
+    }
+}
+
+static void prv_bench_setup(bench_mode_t mode, int num)
+{
+    const ebtn_btn_param_t *param = mode == BENCH_MODE_ENGINE ? &bench_param_debounce : &bench_param_stable;
+
+    for (int i = 0; i < num; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, param);
+        bench_btns[i] = btn;
+    }
+
+    ebtn_init_ex(&bench_group, bench_btns, num, NULL, 0, NULL, prv_bench_event);
+    ebtn_set_state_storage_ex(&bench_group, bench_state_storage, BENCH_MAX_KEYNUM);
+#ifdef EBTN_CONFIG_KEY_INDEX
+    ebtn_set_key_index_storage_ex(&bench_group, bench_key_hash, EBTN_ARRAY_SIZE(bench_key_hash));
+#endif
+#ifdef EBTN_CONFIG_SOA
+    {
+        ebtn_soa_t soa = EBTN_SOA_INIT(bench_soa_storage);
+        ebtn_set_soa_storage_ex(&bench_group, &soa, BENCH_MAX_KEYNUM);
+    }
+#endif
+    ebtn_vdebounce_init(&bench_vd, bench_vd_storage, num, BENCH_SAMPLES);
+}
+
+static void prv_bench_run(bench_mode_t mode, bench_act_t act, int num)
+{
+    double start, elapsed, best = 0;
+    unsigned long best_evt_cnt = 0;
+    uint32_t now = 0;
+
+    prv_bench_setup(mode, num);
+
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        bench_evt_cnt = 0;
+        start = prv_bench_now_ns();
+        for (int i = 0; i < BENCH_TICKS; i++, now++)
+        {
+            bit_array_t *raw = bench_raw[now % BENCH_RING];
+
+            switch (mode)
+            {
+                case BENCH_MODE_ENGINE:
+                    ebtn_process_with_curr_state_ex(&bench_group, raw, (ebtn_time_t)now);
+                    break;
+                case BENCH_MODE_VCOUNTER:
+                    ebtn_vdebounce_update(&bench_vd, raw);
+                    ebtn_process_with_curr_state_ex(&bench_group, ebtn_vdebounce_get_state(&bench_vd), (ebtn_time_t)now);
+                    break;
+                default:
+                    ebtn_vdebounce_update(&bench_vd, raw);
+                    break;
+            }
+        }
+        elapsed = prv_bench_now_ns() - start;
+        if (r == 0 || elapsed < best)
+        {
+            best = elapsed;
+            best_evt_cnt = bench_evt_cnt;
+        }
+    }
+
+    printf("%s,%d,%s,%s,%d,%.1f,%.3f,%lu\n", prv_bench_kernel(), num, bench_mode_name[mode], bench_act_name[act], BENCH_TICKS, best / BENCH_TICKS,
+           best / BENCH_TICKS / num, best_evt_cnt);
+}
+
+int main(void)
+{
+    static const int nums[] = {64, 1024, 4096};
+    int mode, act;
+
+    printf("kernel,lines,mode,activity,ticks,ns_per_sample,ns_per_line,events\n");
+
+    for (size_t n = 0; n < EBTN_ARRAY_SIZE(nums); n++)
+    {
+        for (act = BENCH_ACT_IDLE; act <= BENCH_ACT_CHATTER; act++)
+        {
+            prv_bench_input((bench_act_t)act, nums[n]);
+            for (mode = BENCH_MODE_ENGINE; mode <= BENCH_MODE_FRONTEND; mode++)
+            {
+                prv_bench_run((bench_mode_t)mode, (bench_act_t)act, nums[n]);
+            }
+        }
+    }
+
+    return 0;
+}
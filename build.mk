@@ -1,5 +1,7 @@
 SRC		+= .
 SRC		+= ebtn
+SRC		+= port/linux
 
 INCLUDE	+= .
 INCLUDE	+= ebtn
+INCLUDE	+= port/linux
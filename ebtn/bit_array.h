@@ -81,6 +81,25 @@ static inline bit_array_val_t _windows_popcount(bit_array_val_t w)
 #define POPCOUNT(x) (unsigned)__builtin_popcountll(x)
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define CTZ(x) (unsigned)__builtin_ctzll(x)
+#else
+// Count trailing zeros, `w` must not be zero
+static inline unsigned _windows_ctz(bit_array_val_t w)
+{
+    unsigned n = 0;
+
+    while (!(w & 1))
+    {
+        w >>= 1;
+        n++;
+    }
+    return n;
+}
+
+#define CTZ(x) _windows_ctz(x)
+#endif
+
 #define bits_in_top_word(nbits) ((nbits) ? BIT_ARRAY_BIT_INDEX((nbits)-1) + 1 : 0)
 
 static inline void _bit_array_mask_top_word(bit_array_t *target, int num_bits)
@@ -530,6 +549,32 @@ static inline void bit_array_not(bit_array_t *dest, const bit_array_t *src, int
     }
 }
 
+// Check if any bit is set in both arrays
+static inline int bit_array_is_overlap(const bit_array_t *src1, const bit_array_t *src2, int num_bits)
+{
+    for (int i = 0; i < BIT_ARRAY_BITMAP_SIZE(num_bits); i++)
+    {
+        if (src1[i] & src2[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Check if any bit is set
+static inline int bit_array_is_any_set(const bit_array_t *target, int num_bits)
+{
+    for (int i = 0; i < BIT_ARRAY_BITMAP_SIZE(num_bits); i++)
+    {
+        if (target[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 //
 // Shift array left/right.  If fill is zero, filled with 0, otherwise 1
 //
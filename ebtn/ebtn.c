@@ -1,26 +1,388 @@
+#include <stddef.h>
 #include <string.h>
 #include "ebtn.h"
 
+#ifdef EBTN_CONFIG_SIMD
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EBTN_SIMD_HAVE_X86
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define EBTN_SIMD_HAVE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 #define EBTN_FLAG_ONPRESS_SENT ((uint8_t)0x01) /*!< Flag indicates that on-press event has been sent */
 #define EBTN_FLAG_IN_PROCESS   ((uint8_t)0x02) /*!< Flag indicates that button in process */
+#define EBTN_FLAG_TIMER_DUE    ((uint8_t)0x04) /*!< Flag indicates that combo-button timer expired */
+#define EBTN_FLAG_COMBO_ACTIVE ((uint8_t)0x08) /*!< Flag indicates that all keys of combo-button are active */
+#define EBTN_FLAG_SEQ_START    ((uint8_t)0x10) /*!< Flag indicates that last on-press came after idle of time_click_multi_max */
+
+/* Access of input channel indexes, stats sequence and group generation shared by several contexts.
+ * EBTN_ATOMIC_LOAD/STORE are only used on uint16_t, EBTN_ATOMIC_INC only on ebtn_group_gen. */
+#if defined(__GNUC__) || defined(__clang__)
+#define EBTN_ATOMIC_LOAD(ptr)       __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define EBTN_ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define EBTN_ATOMIC_FENCE()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define EBTN_ATOMIC_INC(ptr)        __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+typedef uint32_t ebtn_atomic_gen_t;
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+static inline uint16_t prv_atomic_load_u16(const volatile uint16_t *ptr)
+{
+    uint16_t val = *ptr;
+
+    atomic_thread_fence(memory_order_acquire); /* Later reads are not moved before it */
+    return val;
+}
+
+static inline void prv_atomic_store_u16(volatile uint16_t *ptr, uint16_t val)
+{
+    atomic_thread_fence(memory_order_release); /* Earlier writes are not moved after it */
+    *ptr = val;
+}
+#define EBTN_ATOMIC_LOAD(ptr)       prv_atomic_load_u16(ptr)
+#define EBTN_ATOMIC_STORE(ptr, val) prv_atomic_store_u16((ptr), (val))
+#define EBTN_ATOMIC_FENCE()         atomic_thread_fence(memory_order_seq_cst)
+#define EBTN_ATOMIC_INC(ptr)        (atomic_fetch_add_explicit((ptr), 1, memory_order_relaxed) + 1)
+typedef atomic_uint_least32_t ebtn_atomic_gen_t;
+#else
+#if defined(EBTN_CONFIG_SHARD) || defined(EBTN_CONFIG_STATS)
+#error "EBTN_CONFIG_SHARD and EBTN_CONFIG_STATS need __atomic builtins or C11 atomics"
+#endif
+/* Single core target, producer of the input channel is an interrupt or a task on the same core,
+ * order of volatile access is kept by the compiler, edges are accessed as volatile too */
+static inline uint16_t prv_atomic_load_u16(const volatile uint16_t *ptr)
+{
+    return *ptr;
+}
+
+static inline void prv_atomic_store_u16(volatile uint16_t *ptr, uint16_t val)
+{
+    *ptr = val;
+}
+#define EBTN_ATOMIC_LOAD(ptr)       prv_atomic_load_u16(ptr)
+#define EBTN_ATOMIC_STORE(ptr, val) prv_atomic_store_u16((ptr), (val))
+#define EBTN_ATOMIC_FENCE()
+#define EBTN_ATOMIC_INC(ptr) (++*(ptr))
+typedef uint32_t ebtn_atomic_gen_t;
+#endif
 
 /* Default button group instance */
 static ebtn_t ebtn_default;
 
+/* Generation of button group init, unique for every init, dynamic buttons registered to a group carry it.
+ * Groups can be initialized by different threads, only changed by EBTN_ATOMIC_INC(). */
+static ebtn_atomic_gen_t ebtn_group_gen;
+
+#ifdef EBTN_CONFIG_SOA
+/* State field of button, in structure-of-arrays for buttons with key_idx, in button for combo-buttons */
+#define EBTN_BTN_VAL(ebtobj, btn, slot, field) (*((slot) >= 0 ? &(ebtobj)->soa.field[slot] : &(btn)->field))
+#else
+#define EBTN_BTN_VAL(ebtobj, btn, slot, field) ((btn)->field)
+#endif
+
+/* Button of key_idx, static or dynamic */
+#ifdef EBTN_CONFIG_SOA
+#define EBTN_KEY_BTN(ebtobj, idx) ((ebtobj)->soa.btn[idx])
+#else
+#define EBTN_KEY_BTN(ebtobj, idx) ((ebtobj)->btn_table[idx])
+#endif
+
+/* Event of button is enabled or not */
+#ifdef EBTN_CONFIG_FIXED_PARAMS
+#define EBTN_BTN_EVT_ENABLED(btn, mask) ((EBTN_FIXED_EVT_MASK & (mask)) != 0)
+#else
+#define EBTN_BTN_EVT_ENABLED(btn, mask) (((btn)->event_mask & (mask)) != 0)
+#endif
+
+#ifdef EBTN_CONFIG_FIXED_PARAMS
+/* Param of all buttons, constant to the compiler */
+static const ebtn_btn_param_t ebtn_fixed_param =
+        EBTN_PARAMS_INIT(EBTN_FIXED_TIME_DEBOUNCE, EBTN_FIXED_TIME_DEBOUNCE_RELEASE, EBTN_FIXED_TIME_CLICK_PRESSED_MIN, EBTN_FIXED_TIME_CLICK_PRESSED_MAX,
+                         EBTN_FIXED_TIME_CLICK_MULTI_MAX, EBTN_FIXED_TIME_KEEPALIVE_PERIOD, EBTN_FIXED_MAX_CONSECUTIVE);
+#endif
+
+/**
+ * \brief           Get param of button
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \return          Param of button
+ */
+static const ebtn_btn_param_t *prv_btn_get_param(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot)
+{
+#if defined(EBTN_CONFIG_FIXED_PARAMS)
+    (void)ebtobj;
+    (void)btn;
+    (void)slot;
+    return &ebtn_fixed_param;
+#elif defined(EBTN_CONFIG_SOA)
+    if (slot >= 0 && ebtobj->soa.param_idx[slot] != EBTN_SOA_PARAM_NONE)
+    {
+        return ebtobj->param_table[ebtobj->soa.param_idx[slot]];
+    }
+    return btn->param;
+#else
+    (void)ebtobj;
+    (void)slot;
+    return btn->param;
+#endif
+}
+
+/**
+ * \brief           Check button in process or not
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \return          `1` if in process, `0` otherwise
+ */
+static int prv_btn_is_in_process(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot)
+{
+#ifndef EBTN_CONFIG_SOA
+    (void)ebtobj;
+    (void)slot;
+#endif
+    return (EBTN_BTN_VAL(ebtobj, btn, slot, flags) & EBTN_FLAG_IN_PROCESS) != 0;
+}
+
+#ifdef EBTN_CONFIG_SOA
+/**
+ * \brief           Sync public state of button from structure-of-arrays
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ */
+static void prv_soa_sync_btn(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot)
+{
+    if (slot >= 0)
+    {
+        btn->flags = ebtobj->soa.flags[slot];
+        btn->click_cnt = ebtobj->soa.click_cnt[slot];
+    }
+}
+#endif
+
+#ifdef EBTN_CONFIG_STATS
+/**
+ * \brief           Start update of button statistics, readers retry until update end
+ *
+ * \param[in]       stats: Button statistics
+ */
+static void prv_stats_begin(ebtn_btn_stats_t *stats)
+{
+    EBTN_ATOMIC_STORE(&stats->seq, (uint16_t)(stats->seq + 1));
+    EBTN_ATOMIC_FENCE();
+}
+
+/**
+ * \brief           End update of button statistics
+ *
+ * \param[in]       stats: Button statistics
+ */
+static void prv_stats_end(ebtn_btn_stats_t *stats)
+{
+    EBTN_ATOMIC_STORE(&stats->seq, (uint16_t)(stats->seq + 1));
+}
+
+/**
+ * \brief           Add time to log2 histogram
+ *
+ * \param[in]       hist: Histogram of `EBTN_STATS_HIST_NUM` buckets
+ * \param[in]       time: Time in ms
+ */
+static void prv_stats_hist_add(uint32_t *hist, ebtn_time_sign_t time)
+{
+    uint32_t val = time > 0 ? (uint32_t)time : 0;
+    int idx = 0;
+
+    while (val != 0 && idx < EBTN_STATS_HIST_NUM - 1)
+    {
+        val >>= 1;
+        idx++;
+    }
+    hist[idx]++;
+}
+#endif
+
+#ifdef EBTN_CONFIG_EVT_RING
+/**
+ * \brief           Put event of button into the event ring
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance, public state already synced
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \param[in]       evt: Event to put
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_evt_ring_put(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot, ebtn_evt_t evt, ebtn_time_t mstime)
+{
+    ebtn_evt_record_t *record;
+    uint16_t used = (uint16_t)(ebtobj->evt_ring_head - ebtobj->evt_ring_tail);
+
+    if (used >= ebtobj->evt_ring_size)
+    {
+        ebtobj->evt_ring_stats.dropped++;
+        if (ebtobj->evt_ring_policy != EBTN_EVT_RING_DROP_OLDEST)
+        {
+            return;
+        }
+        ebtobj->evt_ring_tail++;
+        used--;
+    }
+
+    record = &ebtobj->evt_ring[ebtobj->evt_ring_head & (ebtobj->evt_ring_size - 1)];
+    record->time = mstime;
+    record->key_id = btn->key_id;
+    record->click_cnt = btn->click_cnt;
+    record->keepalive_cnt = btn->keepalive_cnt;
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+    record->keepalive_step = btn->keepalive_step;
+#endif
+    record->evt = (uint8_t)evt;
+    record->combo = (slot < 0);
+    ebtobj->evt_ring_head++;
+
+    ebtobj->evt_ring_stats.queued++;
+    if (used + 1 > ebtobj->evt_ring_stats.peak)
+    {
+        ebtobj->evt_ring_stats.peak = used + 1;
+    }
+}
+#endif
+
+/**
+ * \brief           Deliver event of button to event function, or event ring when not set
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance, public state already synced
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \param[in]       evt: Event to deliver
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_deliver_evt(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot, ebtn_evt_t evt, ebtn_time_t mstime)
+{
+#ifdef EBTN_CONFIG_EVT_RING
+    if (ebtobj->evt_fn == NULL)
+    {
+        prv_evt_ring_put(ebtobj, btn, slot, evt, mstime);
+        return;
+    }
+#else
+    (void)slot;
+    (void)mstime;
+#endif
+    ebtobj->evt_fn(btn, evt);
+}
+
+#ifdef EBTN_CONFIG_SHARD
+/**
+ * \brief           Buffer event of button in its shard, called by the worker of the shard
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance, public state already synced
+ * \param[in]       slot: Button internal key_idx
+ * \param[in]       evt: Event to buffer
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_shard_put(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot, ebtn_evt_t evt, ebtn_time_t mstime)
+{
+    ebtn_shard_t *shard = &ebtobj->shards[slot / ebtobj->shard_keynum];
+    ebtn_shard_evt_t *record;
+
+    if (shard->evt_cnt >= shard->evt_size)
+    {
+        shard->evt_dropped++;
+        return;
+    }
+
+    record = &shard->evts[shard->evt_cnt++];
+    record->btn = btn;
+    record->key_idx = slot;
+    record->time = mstime;
+    record->click_cnt = btn->click_cnt;
+    record->keepalive_cnt = btn->keepalive_cnt;
+    record->flags = btn->flags;
+    record->evt = (uint8_t)evt;
+}
+
+/**
+ * \brief           Deliver buffered event of shard, button shows its public state of when the event was generated
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       record: Buffered event
+ */
+static void prv_shard_deliver(ebtn_t *ebtobj, const ebtn_shard_evt_t *record)
+{
+    ebtn_btn_t *btn = record->btn;
+    uint16_t click_cnt = btn->click_cnt;
+    uint16_t keepalive_cnt = btn->keepalive_cnt;
+    uint8_t flags = btn->flags;
+
+    btn->click_cnt = record->click_cnt;
+    btn->keepalive_cnt = record->keepalive_cnt;
+    btn->flags = record->flags;
+    prv_deliver_evt(ebtobj, btn, record->key_idx, (ebtn_evt_t)record->evt, record->time);
+    btn->click_cnt = click_cnt;
+    btn->keepalive_cnt = keepalive_cnt;
+    btn->flags = flags;
+}
+#endif
+
+/**
+ * \brief           Send event of button
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \param[in]       evt: Event to send
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_send_evt(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot, ebtn_evt_t evt, ebtn_time_t mstime)
+{
+#ifdef EBTN_CONFIG_SOA
+    prv_soa_sync_btn(ebtobj, btn, slot);
+#endif
+#ifdef EBTN_CONFIG_STATS
+    prv_stats_begin(&btn->stats);
+    btn->stats.evt_cnt[evt]++;
+    prv_stats_end(&btn->stats);
+#endif
+#ifdef EBTN_CONFIG_SHARD
+    if (ebtobj->shard_active && slot >= 0)
+    {
+        prv_shard_put(ebtobj, btn, slot, evt, mstime);
+        return;
+    }
+#endif
+    prv_deliver_evt(ebtobj, btn, slot, evt, mstime);
+}
+
 /**
  * \brief           Process the button information and state
  *
+ * \param[in]       ebtobj: Button group instance
  * \param[in]       btn: Button instance to process
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
  * \param[in]       old_state: old state
  * \param[in]       new_state: new state
  * \param[in]       mstime: Current milliseconds system time
  */
-static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_state, ebtn_time_t mstime)
+static void prv_process_btn(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot, uint8_t old_state, uint8_t new_state, ebtn_time_t mstime)
 {
-    ebtn_t *ebtobj = &ebtn_default;
+#define BTN_VAL(field) EBTN_BTN_VAL(ebtobj, btn, slot, field)
+    const ebtn_btn_param_t *param = prv_btn_get_param(ebtobj, btn, slot);
+#ifdef EBTN_CONFIG_SOA
+    uint8_t flags = BTN_VAL(flags);
+    uint16_t click_cnt = BTN_VAL(click_cnt);
+#endif
 
     /* Check params set or not. */
-    if (btn->param == NULL)
+    if (param == NULL)
     {
         return;
     }
@@ -28,11 +390,21 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
     /* Button state has just changed */
     if (new_state != old_state)
     {
-        btn->time_state_change = mstime;
+#ifdef EBTN_CONFIG_STATS
+        prv_stats_begin(&btn->stats);
+        btn->stats.transitions++;
+        /* Press released before on-press, or release pressed again before on-release */
+        if (!!new_state == !!(BTN_VAL(flags) & EBTN_FLAG_ONPRESS_SENT))
+        {
+            btn->stats.bounces++;
+        }
+        prv_stats_end(&btn->stats);
+#endif
+        BTN_VAL(time_state_change) = mstime;
 
         if (new_state)
         {
-            btn->flags |= EBTN_FLAG_IN_PROCESS;
+            BTN_VAL(flags) |= EBTN_FLAG_IN_PROCESS;
         }
     }
     /* Button is still pressed */
@@ -43,7 +415,7 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
          *
          * This is when we detect valid press
          */
-        if (!(btn->flags & EBTN_FLAG_ONPRESS_SENT))
+        if (!(BTN_VAL(flags) & EBTN_FLAG_ONPRESS_SENT))
         {
             /*
              * Run if statement when:
@@ -51,32 +423,56 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
              * - Runtime mode is enabled -> user sets its own config for debounce
              * - Config debounce time for press is more than `0`
              */
-            if (ebtn_timer_sub(mstime, btn->time_state_change) >= btn->param->time_debounce)
+            if (ebtn_timer_sub(mstime, BTN_VAL(time_state_change)) >= param->time_debounce)
             {
+#ifndef EBTN_CONFIG_NO_MULTICLICK
+#ifdef EBTN_CONFIG_STATS
+                if (BTN_VAL(click_cnt) > 0)
+                {
+                    prv_stats_begin(&btn->stats);
+                    prv_stats_hist_add(btn->stats.click_gap_hist, ebtn_timer_sub(mstime, BTN_VAL(click_last_time)));
+                    prv_stats_end(&btn->stats);
+                }
+#endif
                 /*
                  * Check mutlti click limit reach or not.
                  */
-                if ((btn->click_cnt > 0) && (ebtn_timer_sub(mstime, btn->click_last_time) >= btn->param->time_click_multi_max))
+                if ((BTN_VAL(click_cnt) > 0) && (ebtn_timer_sub(mstime, BTN_VAL(click_last_time)) >= param->time_click_multi_max))
                 {
-                    if (btn->event_mask & EBTN_EVT_MASK_ONCLICK)
+                    if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
                     {
-                        ebtobj->evt_fn(btn, EBTN_EVT_ONCLICK);
+                        prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
                     }
-                    btn->click_cnt = 0;
+                    BTN_VAL(click_cnt) = 0;
                 }
+#endif
 
+#ifndef EBTN_CONFIG_NO_KEEPALIVE
                 /* Set keep alive time */
-                btn->keepalive_last_time = mstime;
+                BTN_VAL(keepalive_last_time) = mstime;
                 btn->keepalive_cnt = 0;
+#endif
+
+#ifdef EBTN_CONFIG_GESTURE
+                /* Press after idle starts a new gesture sequence */
+                if (ebtn_timer_sub(mstime, BTN_VAL(time_change)) >= param->time_click_multi_max)
+                {
+                    BTN_VAL(flags) |= EBTN_FLAG_SEQ_START;
+                }
+                else
+                {
+                    BTN_VAL(flags) &= ~EBTN_FLAG_SEQ_START;
+                }
+#endif
 
                 /* Start with new on-press */
-                btn->flags |= EBTN_FLAG_ONPRESS_SENT;
-                if (btn->event_mask & EBTN_EVT_MASK_ONPRESS)
+                BTN_VAL(flags) |= EBTN_FLAG_ONPRESS_SENT;
+                if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONPRESS))
                 {
-                    ebtobj->evt_fn(btn, EBTN_EVT_ONPRESS);
+                    prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONPRESS, mstime);
                 }
 
-                btn->time_change = mstime; /* Button state has now changed */
+                BTN_VAL(time_change) = mstime; /* Button state has now changed */
             }
         }
 
@@ -87,26 +483,48 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
          */
         else
         {
-            while ((btn->param->time_keepalive_period > 0) && (ebtn_timer_sub(mstime, btn->keepalive_last_time) >= btn->param->time_keepalive_period))
+#if defined(EBTN_CONFIG_KEEPALIVE_COALESCE) && !defined(EBTN_CONFIG_NO_KEEPALIVE)
+            /* All periods elapsed since last keep alive in one event */
+            if ((param->time_keepalive_period > 0) && (ebtn_timer_sub(mstime, BTN_VAL(keepalive_last_time)) >= param->time_keepalive_period))
+            {
+                uint32_t step = (uint32_t)ebtn_timer_sub(mstime, BTN_VAL(keepalive_last_time)) / param->time_keepalive_period;
+
+                if (step > 0xFFFF)
+                {
+                    step = 0xFFFF; /* Rest in next process */
+                }
+                BTN_VAL(keepalive_last_time) += (ebtn_time_t)(step * param->time_keepalive_period);
+                btn->keepalive_cnt += (uint16_t)step;
+                btn->keepalive_step = (uint16_t)step;
+                if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_KEEPALIVE))
+                {
+                    prv_send_evt(ebtobj, btn, slot, EBTN_EVT_KEEPALIVE, mstime);
+                }
+            }
+#elif !defined(EBTN_CONFIG_NO_KEEPALIVE)
+            while ((param->time_keepalive_period > 0) && (ebtn_timer_sub(mstime, BTN_VAL(keepalive_last_time)) >= param->time_keepalive_period))
             {
-                btn->keepalive_last_time += btn->param->time_keepalive_period;
+                BTN_VAL(keepalive_last_time) += param->time_keepalive_period;
                 ++btn->keepalive_cnt;
-                if (btn->event_mask & EBTN_EVT_MASK_KEEPALIVE)
+                if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_KEEPALIVE))
                 {
-                    ebtobj->evt_fn(btn, EBTN_EVT_KEEPALIVE);
+                    prv_send_evt(ebtobj, btn, slot, EBTN_EVT_KEEPALIVE, mstime);
                 }
             }
+#endif
 
+#ifndef EBTN_CONFIG_NO_MULTICLICK
             // Scene1: multi click end with a long press, need send onclick event.
-            if ((btn->click_cnt > 0) && (ebtn_timer_sub(mstime, btn->time_change) > btn->param->time_click_pressed_max))
+            if ((BTN_VAL(click_cnt) > 0) && (ebtn_timer_sub(mstime, BTN_VAL(time_change)) > param->time_click_pressed_max))
             {
-                if (btn->event_mask & EBTN_EVT_MASK_ONCLICK)
+                if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
                 {
-                    ebtobj->evt_fn(btn, EBTN_EVT_ONCLICK);
+                    prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
                 }
 
-                btn->click_cnt = 0;
+                BTN_VAL(click_cnt) = 0;
             }
+#endif
         }
     }
     /* Button is still released */
@@ -117,7 +535,7 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
          *
          * Do nothing if that was not the case
          */
-        if (btn->flags & EBTN_FLAG_ONPRESS_SENT)
+        if (BTN_VAL(flags) & EBTN_FLAG_ONPRESS_SENT)
         {
             /*
              * Run if statement when:
@@ -125,32 +543,50 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
              * - Runtime mode is enabled -> user sets its own config for debounce
              * - Config debounce time for release is more than `0`
              */
-            if (ebtn_timer_sub(mstime, btn->time_state_change) >= btn->param->time_debounce_release)
+            if (ebtn_timer_sub(mstime, BTN_VAL(time_state_change)) >= param->time_debounce_release)
             {
+#ifdef EBTN_CONFIG_STATS
+                prv_stats_begin(&btn->stats);
+                prv_stats_hist_add(btn->stats.press_hist, ebtn_timer_sub(mstime, BTN_VAL(time_change)));
+                prv_stats_end(&btn->stats);
+#endif
                 /* Handle on-release event */
-                btn->flags &= ~EBTN_FLAG_ONPRESS_SENT;
-                if (btn->event_mask & EBTN_EVT_MASK_ONRELEASE)
+                BTN_VAL(flags) &= ~EBTN_FLAG_ONPRESS_SENT;
+                if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONRELEASE))
                 {
-                    ebtobj->evt_fn(btn, EBTN_EVT_ONRELEASE);
+                    prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONRELEASE, mstime);
                 }
 
+#ifdef EBTN_CONFIG_NO_MULTICLICK
+                /* Check time validity for click event, send it right now */
+                if (ebtn_timer_sub(mstime, BTN_VAL(time_change)) >= param->time_click_pressed_min &&
+                    ebtn_timer_sub(mstime, BTN_VAL(time_change)) <= param->time_click_pressed_max)
+                {
+                    BTN_VAL(click_cnt) = 1;
+                    if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
+                    {
+                        prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
+                    }
+                    BTN_VAL(click_cnt) = 0;
+                }
+#else
                 /* Check time validity for click event */
-                if (ebtn_timer_sub(mstime, btn->time_change) >= btn->param->time_click_pressed_min &&
-                    ebtn_timer_sub(mstime, btn->time_change) <= btn->param->time_click_pressed_max)
+                if (ebtn_timer_sub(mstime, BTN_VAL(time_change)) >= param->time_click_pressed_min &&
+                    ebtn_timer_sub(mstime, BTN_VAL(time_change)) <= param->time_click_pressed_max)
                 {
-                    ++btn->click_cnt;
+                    ++BTN_VAL(click_cnt);
 
-                    btn->click_last_time = mstime;
+                    BTN_VAL(click_last_time) = mstime;
                 }
                 else
                 {
                     // Scene2: If last press was too short, and previous sequence of clicks was
                     // positive, send event to user.
-                    if ((btn->click_cnt > 0) && (ebtn_timer_sub(mstime, btn->time_change) < btn->param->time_click_pressed_min))
+                    if ((BTN_VAL(click_cnt) > 0) && (ebtn_timer_sub(mstime, BTN_VAL(time_change)) < param->time_click_pressed_min))
                     {
-                        if (btn->event_mask & EBTN_EVT_MASK_ONCLICK)
+                        if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
                         {
-                            ebtobj->evt_fn(btn, EBTN_EVT_ONCLICK);
+                            prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
                         }
                     }
                     /*
@@ -159,21 +595,22 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
                      *
                      * Reset clicks counter -> not valid sequence for click event.
                      */
-                    btn->click_cnt = 0;
+                    BTN_VAL(click_cnt) = 0;
                 }
 
                 // Scene3: this part will send on-click event immediately after release event, if
                 // maximum number of consecutive clicks has been reached.
-                if ((btn->click_cnt > 0) && (btn->click_cnt == btn->param->max_consecutive))
+                if ((BTN_VAL(click_cnt) > 0) && (BTN_VAL(click_cnt) == param->max_consecutive))
                 {
-                    if (btn->event_mask & EBTN_EVT_MASK_ONCLICK)
+                    if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
                     {
-                        ebtobj->evt_fn(btn, EBTN_EVT_ONCLICK);
+                        prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
                     }
-                    btn->click_cnt = 0;
+                    BTN_VAL(click_cnt) = 0;
                 }
+#endif
 
-                btn->time_change = mstime; /* Button state has now changed */
+                BTN_VAL(time_change) = mstime; /* Button state has now changed */
             }
         }
         else
@@ -186,389 +623,3186 @@ static void prv_process_btn(ebtn_btn_t *btn, uint8_t old_state, uint8_t new_stat
              * that is reported only after last click event happened,
              * including number of clicks made by user
              */
-            if (btn->click_cnt > 0)
+#ifndef EBTN_CONFIG_NO_MULTICLICK
+            if (BTN_VAL(click_cnt) > 0)
             {
-                if (ebtn_timer_sub(mstime, btn->click_last_time) >= btn->param->time_click_multi_max)
+                if (ebtn_timer_sub(mstime, BTN_VAL(click_last_time)) >= param->time_click_multi_max)
                 {
-                    if (btn->event_mask & EBTN_EVT_MASK_ONCLICK)
+                    if (EBTN_BTN_EVT_ENABLED(btn, EBTN_EVT_MASK_ONCLICK))
                     {
-                        ebtobj->evt_fn(btn, EBTN_EVT_ONCLICK);
+                        prv_send_evt(ebtobj, btn, slot, EBTN_EVT_ONCLICK, mstime);
                     }
-                    btn->click_cnt = 0;
+                    BTN_VAL(click_cnt) = 0;
                 }
             }
             else
+#endif
             {
                 // check button in process
-                if (btn->flags & EBTN_FLAG_IN_PROCESS)
+                if (BTN_VAL(flags) & EBTN_FLAG_IN_PROCESS)
                 {
-                    btn->flags &= ~EBTN_FLAG_IN_PROCESS;
+                    BTN_VAL(flags) &= ~EBTN_FLAG_IN_PROCESS;
                 }
             }
         }
     }
-}
-
-int ebtn_init(ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo, uint16_t btns_combo_cnt, ebtn_get_state_fn get_state_fn, ebtn_evt_fn evt_fn)
-{
-    ebtn_t *ebtobj = &ebtn_default;
 
-    if (evt_fn == NULL || get_state_fn == NULL /* Parameter is a must only in callback-only mode */
-    )
+#ifdef EBTN_CONFIG_SOA
+    /* Keep public state of button up to date */
+    if (BTN_VAL(flags) != flags || BTN_VAL(click_cnt) != click_cnt)
     {
-        return 0;
+        prv_soa_sync_btn(ebtobj, btn, slot);
     }
-
-    memset(ebtobj, 0x00, sizeof(*ebtobj));
-    ebtobj->btns = btns;
-    ebtobj->btns_cnt = btns_cnt;
-    ebtobj->btns_combo = btns_combo;
-    ebtobj->btns_combo_cnt = btns_combo_cnt;
-    ebtobj->evt_fn = evt_fn;
-    ebtobj->get_state_fn = get_state_fn;
-
-    return 1;
+#endif
+#undef BTN_VAL
 }
 
 /**
- * \brief           Get all button state with get_state_fn.
+ * \brief           Get absolute time which is `delta` after `time`.
+ * Keep in line with ebtn_timer_sub(), which lose one unit when time overflow.
  *
- * \param[out]       state_array: store the button state
+ * \param[in]       time: Absolute start time
+ * \param[in]       delta: Relative time
+ * \param[out]      deadline: Absolute time when ebtn_timer_sub(deadline, time) >= delta
+ * \return          `1` if deadline is reachable, `0` otherwise
  */
-static void ebtn_get_current_state(bit_array_t *state_array)
+static int prv_timer_add(ebtn_time_t time, uint32_t delta, ebtn_time_t *deadline)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    ebtn_btn_dyn_t *target;
-    int i;
+    ebtn_time_t res = (ebtn_time_t)(time + delta);
 
-    /* Process all buttons */
-    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    /* ebtn_timer_sub() is signed, delta larger than half range will never be reached */
+    if (delta > (MAX_TIME_VALUE >> 1))
     {
-        /* Get button state */
-        uint8_t new_state = ebtobj->get_state_fn(&ebtobj->btns[i]);
-        // save state
-        bit_array_assign(state_array, i, new_state);
+        return 0;
     }
 
-    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    if (res < time)
     {
-        /* Get button state */
-        uint8_t new_state = ebtobj->get_state_fn(&target->btn);
-
-        // save state
-        bit_array_assign(state_array, i, new_state);
+        res++;
     }
+    *deadline = res;
+    return 1;
 }
 
 /**
- * \brief           Process the button state
+ * \brief           Get the next time the button need to be processed without input change
  *
- * \param[in]       btn: Button instance to process
- * \param[in]       old_state: all button old state
- * \param[in]       curr_state: all button current state
- * \param[in]       idx: Button internal key_idx
- * \param[in]       mstime: Current milliseconds system time
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \param[in]       state: Button state of last process
+ * \param[out]      deadline: Absolute time of next process
+ * \return          `1` if deadline is valid, `0` if button is idle
  */
-static void ebtn_process_btn(ebtn_btn_t *btn, bit_array_t *old_state, bit_array_t *curr_state, int idx, ebtn_time_t mstime)
+static int prv_get_btn_deadline(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot, uint8_t state, ebtn_time_t *deadline)
 {
-    prv_process_btn(btn, bit_array_get(old_state, idx), bit_array_get(curr_state, idx), mstime);
-}
+#define BTN_VAL(field) EBTN_BTN_VAL(ebtobj, btn, slot, field)
+    const ebtn_btn_param_t *param = prv_btn_get_param(ebtobj, btn, slot);
+#ifndef EBTN_CONFIG_NO_MULTICLICK
+    ebtn_time_t next;
+#endif
+    int valid = 0;
+
+    if (param == NULL || !prv_btn_is_in_process(ebtobj, btn, slot))
+    {
+        return 0;
+    }
 
-/**
- * \brief           Process the combo-button state
- *
- * \param[in]       btn: Button instance to process
- * \param[in]       old_state: all button old state
- * \param[in]       curr_state: all button current state
- * \param[in]       comb_key: Combo key
- * \param[in]       mstime: Current milliseconds system time
- */
-static void ebtn_process_btn_combo(ebtn_btn_t *btn, bit_array_t *old_state, bit_array_t *curr_state, bit_array_t *comb_key, ebtn_time_t mstime)
-{
-    BIT_ARRAY_DEFINE(tmp_data, EBTN_MAX_KEYNUM) = {0};
+    if (state)
+    {
+        if (!(BTN_VAL(flags) & EBTN_FLAG_ONPRESS_SENT))
+        {
+            /* Wait for press debounce */
+            return prv_timer_add(BTN_VAL(time_state_change), param->time_debounce, deadline);
+        }
+
+#ifndef EBTN_CONFIG_NO_KEEPALIVE
+        /* Next keep alive */
+        if (param->time_keepalive_period > 0)
+        {
+            valid = prv_timer_add(BTN_VAL(keepalive_last_time), param->time_keepalive_period, deadline);
+        }
+#endif
+
+#ifndef EBTN_CONFIG_NO_MULTICLICK
+        /* Scene1: multi click end with a long press */
+        if ((BTN_VAL(click_cnt) > 0) && prv_timer_add(BTN_VAL(time_change), (uint32_t)param->time_click_pressed_max + 1, &next))
+        {
+            if (!valid || ebtn_timer_sub(next, *deadline) < 0)
+            {
+                *deadline = next;
+            }
+            valid = 1;
+        }
+#endif
+        return valid;
+    }
 
-    if (bit_array_num_bits_set(comb_key, EBTN_MAX_KEYNUM) == 0)
+    if (BTN_VAL(flags) & EBTN_FLAG_ONPRESS_SENT)
     {
-        return;
+        /* Wait for release debounce */
+        return prv_timer_add(BTN_VAL(time_state_change), param->time_debounce_release, deadline);
     }
-    bit_array_and(tmp_data, curr_state, comb_key, EBTN_MAX_KEYNUM);
-    uint8_t curr = bit_array_cmp(tmp_data, comb_key, EBTN_MAX_KEYNUM) == 0;
 
-    bit_array_and(tmp_data, old_state, comb_key, EBTN_MAX_KEYNUM);
-    uint8_t old = bit_array_cmp(tmp_data, comb_key, EBTN_MAX_KEYNUM) == 0;
+#ifndef EBTN_CONFIG_NO_MULTICLICK
+    if (BTN_VAL(click_cnt) > 0)
+    {
+        /* Wait for multi click timeout */
+        return prv_timer_add(BTN_VAL(click_last_time), param->time_click_multi_max, deadline);
+    }
+#endif
 
-    prv_process_btn(btn, old, curr, mstime);
+    /* Only in process flag need to be cleared, process it as soon as possible */
+    *deadline = BTN_VAL(time_change);
+    return 1;
+#undef BTN_VAL
 }
 
-void ebtn_process_with_curr_state(bit_array_t *curr_state, ebtn_time_t mstime)
+#ifdef EBTN_CONFIG_SIMD
+
+/* Kernel of button groups initialized later, only changed by ebtn_simd_select(), `EBTN_SIMD_AUTO` means best one supported by CPU */
+static ebtn_simd_kernel_t prv_simd_default;
+
+static bit_array_val_t prv_due_kernel_scalar(const ebtn_time_t *deadline, int num, ebtn_time_t mstime)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    ebtn_btn_dyn_t *target;
-    ebtn_btn_combo_dyn_t *target_combo;
+    bit_array_val_t mask = 0;
     int i;
 
-    /* Process all buttons */
-    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    for (i = 0; i < num; i++)
     {
-        ebtn_process_btn(&ebtobj->btns[i], ebtobj->old_state, curr_state, i, mstime);
+        if ((ebtn_time_t)(mstime - deadline[i]) <= (MAX_TIME_VALUE >> 1))
+        {
+            mask |= (bit_array_val_t)1 << i;
+        }
     }
+    return mask;
+}
 
-    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+/**
+ * \brief           Add result of scalar kernel for the buttons left by vector kernel
+ */
+static bit_array_val_t prv_due_kernel_tail(bit_array_val_t mask, const ebtn_time_t *deadline, int i, int num, ebtn_time_t mstime)
+{
+    if (i < num)
     {
-        ebtn_process_btn(&target->btn, ebtobj->old_state, curr_state, i, mstime);
+        mask |= prv_due_kernel_scalar(&deadline[i], num - i, mstime) << i;
     }
+    return mask;
+}
 
-    /* Process all comb buttons */
-    for (i = 0; i < ebtobj->btns_combo_cnt; ++i)
+#ifdef EBTN_SIMD_HAVE_X86
+__attribute__((target("sse2"))) static bit_array_val_t prv_due_kernel_sse2(const ebtn_time_t *deadline, int num, ebtn_time_t mstime)
+{
+    bit_array_val_t mask = 0;
+    int i = 0;
+
+#ifdef EBTN_CONFIG_TIMER_16
+    __m128i now = _mm_set1_epi16((short)mstime);
+    for (; i + 8 <= num; i += 8)
     {
-        ebtn_process_btn_combo(&ebtobj->btns_combo[i].btn, ebtobj->old_state, curr_state, ebtobj->btns_combo[i].comb_key, mstime);
+        __m128i diff = _mm_sub_epi16(now, _mm_loadu_si128((const __m128i *)&deadline[i]));
+        /* Sign bit of difference set means deadline not reached */
+        mask |= (bit_array_val_t)(~_mm_movemask_epi8(_mm_packs_epi16(diff, diff)) & 0xFF) << i;
     }
-
-    for (target_combo = ebtobj->btn_combo_dyn_head; target_combo; target_combo = target_combo->next)
+#else
+    __m128i now = _mm_set1_epi32((int)mstime);
+    for (; i + 4 <= num; i += 4)
     {
-        ebtn_process_btn_combo(&target_combo->btn.btn, ebtobj->old_state, curr_state, target_combo->btn.comb_key, mstime);
+        __m128i diff = _mm_sub_epi32(now, _mm_loadu_si128((const __m128i *)&deadline[i]));
+        /* Sign bit of difference set means deadline not reached */
+        mask |= (bit_array_val_t)(~_mm_movemask_ps(_mm_castsi128_ps(diff)) & 0xF) << i;
     }
-
-    bit_array_copy_all(ebtobj->old_state, curr_state, EBTN_MAX_KEYNUM);
+#endif
+    return prv_due_kernel_tail(mask, deadline, i, num, mstime);
 }
 
-void ebtn_process(ebtn_time_t mstime)
+__attribute__((target("avx2"))) static bit_array_val_t prv_due_kernel_avx2(const ebtn_time_t *deadline, int num, ebtn_time_t mstime)
 {
-    BIT_ARRAY_DEFINE(curr_state, EBTN_MAX_KEYNUM) = {0};
-
-    // Get Current State
-    ebtn_get_current_state(curr_state);
+    bit_array_val_t mask = 0;
+    int i = 0;
 
-    ebtn_process_with_curr_state(curr_state, mstime);
+#ifdef EBTN_CONFIG_TIMER_16
+    __m256i now = _mm256_set1_epi16((short)mstime);
+    for (; i + 16 <= num; i += 16)
+    {
+        __m256i diff = _mm256_sub_epi16(now, _mm256_loadu_si256((const __m256i *)&deadline[i]));
+        /* Pack is done in each 128 bits lane, gather low halves of both lanes */
+        __m256i sign = _mm256_permute4x64_epi64(_mm256_packs_epi16(diff, diff), 0xD8);
+        mask |= (bit_array_val_t)(~_mm256_movemask_epi8(sign) & 0xFFFF) << i;
+    }
+#else
+    __m256i now = _mm256_set1_epi32((int)mstime);
+    for (; i + 8 <= num; i += 8)
+    {
+        __m256i diff = _mm256_sub_epi32(now, _mm256_loadu_si256((const __m256i *)&deadline[i]));
+        mask |= (bit_array_val_t)(~_mm256_movemask_ps(_mm256_castsi256_ps(diff)) & 0xFF) << i;
+    }
+#endif
+    return prv_due_kernel_tail(mask, deadline, i, num, mstime);
 }
+#endif
 
-int ebtn_get_total_btn_cnt(void)
+#ifdef EBTN_SIMD_HAVE_NEON
+static bit_array_val_t prv_due_kernel_neon(const ebtn_time_t *deadline, int num, ebtn_time_t mstime)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    int total_cnt = 0;
-    ebtn_btn_dyn_t *curr = ebtobj->btn_dyn_head;
-
-    total_cnt += ebtobj->btns_cnt;
+    bit_array_val_t mask = 0;
+    int i = 0;
 
-    while (curr)
+#ifdef EBTN_CONFIG_TIMER_16
+    static const int16_t lane_shift[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    uint16x8_t now = vdupq_n_u16(mstime);
+    int16x8_t shift = vld1q_s16(lane_shift);
+    for (; i + 8 <= num; i += 8)
     {
-        total_cnt++;
-        curr = curr->next;
+        uint16x8_t sign = vshrq_n_u16(vsubq_u16(now, vld1q_u16(&deadline[i])), 15);
+        mask |= (bit_array_val_t)(~vaddvq_u16(vshlq_u16(sign, shift)) & 0xFF) << i;
     }
-    return total_cnt;
+#else
+    static const int32_t lane_shift[4] = {0, 1, 2, 3};
+    uint32x4_t now = vdupq_n_u32(mstime);
+    int32x4_t shift = vld1q_s32(lane_shift);
+    for (; i + 4 <= num; i += 4)
+    {
+        uint32x4_t sign = vshrq_n_u32(vsubq_u32(now, vld1q_u32(&deadline[i])), 31);
+        mask |= (bit_array_val_t)(~vaddvq_u32(vshlq_u32(sign, shift)) & 0xF) << i;
+    }
+#endif
+    return prv_due_kernel_tail(mask, deadline, i, num, mstime);
 }
+#endif
 
-int ebtn_get_btn_index_by_key_id(uint16_t key_id)
+/**
+ * \brief           Get the function of a timeout check kernel, no state is changed
+ *
+ * \param[in,out]   kernel: Kernel to get, `EBTN_SIMD_AUTO` is replaced by the best one supported by CPU
+ * \param[out]      fn: Kernel function, `NULL` for `EBTN_SIMD_OFF`
+ * \return          `1` on success, `0` if kernel not supported by CPU or not compiled
+ */
+static int prv_simd_resolve(ebtn_simd_kernel_t *kernel, ebtn_simd_due_fn *fn)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    int i = 0;
-    ebtn_btn_dyn_t *target;
+    static const ebtn_simd_kernel_t prefer[] = {EBTN_SIMD_AVX2, EBTN_SIMD_NEON, EBTN_SIMD_SSE2, EBTN_SIMD_SCALAR};
+    ebtn_simd_kernel_t k;
 
-    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    if (*kernel == EBTN_SIMD_AUTO)
     {
-        if (ebtobj->btns[i].key_id == key_id)
+        for (size_t i = 0; i < EBTN_ARRAY_SIZE(prefer); i++)
         {
-            return i;
+            k = prefer[i];
+            if (prv_simd_resolve(&k, fn))
+            {
+                *kernel = k;
+                return 1;
+            }
         }
+        return 0;
     }
 
-    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    switch (*kernel)
     {
-        if (target->btn.key_id == key_id)
-        {
-            return i;
-        }
+        case EBTN_SIMD_OFF:
+            *fn = NULL;
+            break;
+        case EBTN_SIMD_SCALAR:
+            *fn = prv_due_kernel_scalar;
+            break;
+#ifdef EBTN_SIMD_HAVE_X86
+        case EBTN_SIMD_SSE2:
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("sse2"))
+            {
+                return 0;
+            }
+            *fn = prv_due_kernel_sse2;
+            break;
+        case EBTN_SIMD_AVX2:
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx2"))
+            {
+                return 0;
+            }
+            *fn = prv_due_kernel_avx2;
+            break;
+#endif
+#ifdef EBTN_SIMD_HAVE_NEON
+        case EBTN_SIMD_NEON:
+            *fn = prv_due_kernel_neon;
+            break;
+#endif
+        default:
+            return 0;
     }
 
-    return -1;
+    return 1;
+}
+
+int ebtn_simd_select_ex(ebtn_t *ebtobj, ebtn_simd_kernel_t kernel)
+{
+    ebtn_simd_due_fn fn;
+
+    if (ebtobj == NULL || !prv_simd_resolve(&kernel, &fn))
+    {
+        return 0;
+    }
+    ebtobj->due_kernel = fn;
+    ebtobj->due_kernel_id = (uint8_t)kernel;
+
+    return 1;
+}
+
+int ebtn_simd_select(ebtn_simd_kernel_t kernel)
+{
+    if (!ebtn_simd_select_ex(&ebtn_default, kernel))
+    {
+        return 0;
+    }
+    prv_simd_default = kernel;
+
+    return 1;
+}
+
+ebtn_simd_kernel_t ebtn_simd_get_ex(ebtn_t *ebtobj)
+{
+    return (ebtn_simd_kernel_t)ebtobj->due_kernel_id;
+}
+
+ebtn_simd_kernel_t ebtn_simd_get(void)
+{
+    ebtn_simd_kernel_t kernel = prv_simd_default;
+    ebtn_simd_due_fn fn;
+
+    prv_simd_resolve(&kernel, &fn);
+    return kernel;
+}
+
+/**
+ * \brief           Update deadline of button in structure-of-arrays
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx
+ * \param[in]       state: Button state of last process
+ * \param[in]       mstime: Time of last process
+ */
+static void prv_soa_update_deadline(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot, uint8_t state, ebtn_time_t mstime)
+{
+    if (!prv_get_btn_deadline(ebtobj, btn, slot, state, &ebtobj->soa.deadline[slot]))
+    {
+        /* No timeout, check it again after half time range */
+        ebtobj->soa.deadline[slot] = (ebtn_time_t)(mstime + (MAX_TIME_VALUE >> 1));
+    }
+}
+
+#ifndef EBTN_CONFIG_TIMER_WHEEL
+/**
+ * \brief           Get buttons in process need to be processed of a bitmap word, by timeout check kernel
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       word: Word index of the in process bitmap
+ * \param[in]       mstime: Current milliseconds system time
+ * \return          Bitmask of buttons need to be processed
+ */
+static bit_array_val_t prv_get_due_mask(ebtn_t *ebtobj, int word, ebtn_time_t mstime)
+{
+    bit_array_val_t in_process = ebtobj->in_process[word];
+    int base = word * BIT_ARRAY_BITS;
+    int num = ebtobj->key_num - base;
+
+    if (in_process == 0 || ebtobj->due_kernel == NULL)
+    {
+        return in_process;
+    }
+    if (num > (int)BIT_ARRAY_BITS)
+    {
+        num = BIT_ARRAY_BITS;
+    }
+    return in_process & ebtobj->due_kernel(&ebtobj->soa.deadline[base], num, mstime);
+}
+#endif
+
+#endif
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+
+#define EBTN_TIMER_WHEEL_LEVEL_SIZE(_level) ((uint32_t)1 << (EBTN_TIMER_WHEEL_SLOT_BITS * (_level)))
+
+/**
+ * \brief           Remove timer from timer wheel, do nothing if not scheduled
+ *
+ * \param[in]       wheel: Timer wheel instance
+ * \param[in]       timer: Timer to remove
+ */
+static void prv_timer_wheel_remove(ebtn_timer_wheel_t *wheel, ebtn_timer_t *timer)
+{
+    if (timer->pprev == NULL)
+    {
+        return;
+    }
+
+    *timer->pprev = timer->next;
+    if (timer->next)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+    wheel->cnt--;
+}
+
+/**
+ * \brief           Insert timer to timer wheel, level is selected by the time to expire.
+ *
+ * \param[in]       wheel: Timer wheel instance
+ * \param[in]       timer: Timer to insert, `expire` must be after wheel time
+ */
+static void prv_timer_wheel_insert(ebtn_timer_wheel_t *wheel, ebtn_timer_t *timer)
+{
+    uint32_t delta = (ebtn_time_t)(timer->expire - wheel->time);
+    ebtn_timer_t **head;
+    int level = 0;
+    int slot;
+
+    while ((level < EBTN_TIMER_WHEEL_LEVELS - 1) && (delta >= EBTN_TIMER_WHEEL_LEVEL_SIZE(level + 1)))
+    {
+        level++;
+    }
+    slot = (timer->expire >> (EBTN_TIMER_WHEEL_SLOT_BITS * level)) & (EBTN_TIMER_WHEEL_SLOTS - 1);
+
+    head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (*head)
+    {
+        (*head)->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+
+    wheel->slot_mask[level] |= (uint64_t)1 << slot;
+    wheel->cnt++;
+}
+
+/**
+ * \brief           Pop the first timer of a slot
+ *
+ * \param[in]       wheel: Timer wheel instance
+ * \param[in]       level: Wheel level
+ * \param[in]       slot: Slot of the level
+ * \return          First timer of the slot, `NULL` if slot is empty
+ */
+static ebtn_timer_t *prv_timer_wheel_pop(ebtn_timer_wheel_t *wheel, int level, int slot)
+{
+    ebtn_timer_t *timer = wheel->slots[level][slot];
+
+    if (timer == NULL)
+    {
+        wheel->slot_mask[level] &= ~((uint64_t)1 << slot);
+        return NULL;
+    }
+
+    prv_timer_wheel_remove(wheel, timer);
+    return timer;
+}
+
+/**
+ * \brief           Mark the button of expired timer to be processed
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       timer: Expired timer
+ */
+static void prv_timer_expired(ebtn_t *ebtobj, ebtn_timer_t *timer)
+{
+    ebtn_btn_t *btn;
+
+    if (timer->key_idx >= 0)
+    {
+        bit_array_set(ebtobj->timer_due, timer->key_idx);
+        return;
+    }
+
+    btn = (ebtn_btn_t *)((char *)timer - offsetof(ebtn_btn_t, timer));
+    if (!(btn->flags & EBTN_FLAG_TIMER_DUE))
+    {
+        btn->flags |= EBTN_FLAG_TIMER_DUE;
+        ebtobj->combo_due_cnt++;
+    }
+}
+
+/**
+ * \brief           Run timer wheel for the time of `wheel->time`, cascade upper levels and expire lowest level.
+ *
+ * \param[in]       ebtobj: Button group instance
+ */
+static void prv_timer_wheel_run(ebtn_t *ebtobj)
+{
+    ebtn_timer_wheel_t *wheel = &ebtobj->timer_wheel;
+    ebtn_timer_t *timer;
+    int level, slot;
+
+    /* Cascade upper levels when reach the boundary, from top to bottom */
+    for (level = EBTN_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        if ((wheel->time & (EBTN_TIMER_WHEEL_LEVEL_SIZE(level) - 1)) != 0)
+        {
+            continue;
+        }
+
+        slot = (wheel->time >> (EBTN_TIMER_WHEEL_SLOT_BITS * level)) & (EBTN_TIMER_WHEEL_SLOTS - 1);
+        while ((timer = prv_timer_wheel_pop(wheel, level, slot)) != NULL)
+        {
+            prv_timer_wheel_insert(wheel, timer);
+        }
+    }
+
+    slot = wheel->time & (EBTN_TIMER_WHEEL_SLOTS - 1);
+    while ((timer = prv_timer_wheel_pop(wheel, 0, slot)) != NULL)
+    {
+        prv_timer_expired(ebtobj, timer);
+    }
+}
+
+/**
+ * \brief           Advance timer wheel to current time, all expired timers mark their button to be processed.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_timer_wheel_advance(ebtn_t *ebtobj, ebtn_time_t mstime)
+{
+    ebtn_timer_wheel_t *wheel = &ebtobj->timer_wheel;
+
+    if (!wheel->started)
+    {
+        wheel->time = mstime;
+        wheel->started = 1;
+        return;
+    }
+
+    while (wheel->time != mstime)
+    {
+        uint32_t remain = (ebtn_time_t)(mstime - wheel->time);
+        uint32_t step = 1;
+        int level;
+
+        if (wheel->cnt == 0)
+        {
+            memset(wheel->slot_mask, 0x00, sizeof(wheel->slot_mask));
+            wheel->time = mstime;
+            break;
+        }
+
+        /* Skip empty lower levels, jump to the next boundary of upper level */
+        for (level = 0; (level < EBTN_TIMER_WHEEL_LEVELS - 1) && (wheel->slot_mask[level] == 0); level++)
+        {
+            step = EBTN_TIMER_WHEEL_LEVEL_SIZE(level + 1) - (wheel->time & (EBTN_TIMER_WHEEL_LEVEL_SIZE(level + 1) - 1));
+        }
+        if (step > remain)
+        {
+            wheel->time = mstime;
+            break;
+        }
+
+        wheel->time += step;
+        prv_timer_wheel_run(ebtobj);
+    }
+}
+
+/**
+ * \brief           Schedule button timer with the next deadline of the button
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       idx: Button internal key_idx, `-1` for combo-button
+ * \param[in]       state: Button state of this process
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_timer_schedule(ebtn_t *ebtobj, ebtn_btn_t *btn, int idx, uint8_t state, ebtn_time_t mstime)
+{
+    ebtn_time_t next;
+
+    prv_timer_wheel_remove(&ebtobj->timer_wheel, &btn->timer);
+
+    if (!prv_get_btn_deadline(ebtobj, btn, idx, state, &next))
+    {
+        return;
+    }
+
+    /* Already due, process it in next process */
+    if ((ebtn_time_t)(next - mstime) == 0 || (ebtn_time_t)(next - mstime) > (MAX_TIME_VALUE >> 1))
+    {
+        next = (ebtn_time_t)(mstime + 1);
+    }
+
+    btn->timer.expire = next;
+    btn->timer.key_idx = idx;
+    prv_timer_wheel_insert(&ebtobj->timer_wheel, &btn->timer);
+}
+
+/**
+ * \brief           Reset button timer of new added button, button in process is processed in next process.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       idx: Button internal key_idx, `-1` for combo-button
+ */
+static void prv_timer_reset(ebtn_t *ebtobj, ebtn_btn_t *btn, int idx)
+{
+    btn->timer.next = NULL;
+    btn->timer.pprev = NULL;
+    btn->timer.key_idx = idx;
+    btn->flags &= ~EBTN_FLAG_TIMER_DUE;
+
+    if (ebtn_is_btn_in_process(btn))
+    {
+        prv_timer_expired(ebtobj, &btn->timer);
+    }
+}
+
+#endif
+
+/**
+ * \brief           Attach state storage to the button group, all state is cleared and
+ *                  in process state of the static buttons is restored.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       storage: State storage of `EBTN_STATE_STORAGE_SIZE(max_keynum)` words
+ * \param[in]       max_keynum: Max number of buttons of the storage
+ */
+static void prv_state_storage_attach(ebtn_t *ebtobj, bit_array_t *storage, int max_keynum)
+{
+    int words = BIT_ARRAY_BITMAP_SIZE(max_keynum);
+    int i;
+
+    memset(storage, 0x00, EBTN_STATE_STORAGE_SIZE(max_keynum) * sizeof(bit_array_t));
+    ebtobj->key_capacity = max_keynum;
+    ebtobj->old_state = &storage[0 * words];
+    ebtobj->in_process = &storage[1 * words];
+    ebtobj->curr_state = &storage[2 * words];
+    ebtobj->changed = &storage[3 * words];
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    ebtobj->timer_due = &storage[4 * words];
+    memset(&ebtobj->timer_wheel, 0x00, sizeof(ebtobj->timer_wheel));
+    ebtobj->combo_due_cnt = 0;
+#endif
+#ifndef EBTN_CONFIG_SOA
+    {
+        /* Button table follows the bitmaps, aligned up for pointers within the extra room of EBTN_STATE_BTN_TABLE_SIZE */
+        uintptr_t table = (uintptr_t)&storage[EBTN_STATE_BITMAP_NUM * words];
+
+        table = (table + sizeof(ebtn_btn_t *) - 1) & ~(uintptr_t)(sizeof(ebtn_btn_t *) - 1);
+        ebtobj->btn_table = (ebtn_btn_t **)table;
+    }
+#endif
+    ebtobj->combo_in_process_cnt = 0;
+    ebtobj->curr_state_synced = 1;
+
+    if (ebtobj->btns_cnt > max_keynum)
+    {
+        return;
+    }
+
+    /* Buttons may be reused from last init, keep their in process state */
+    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    {
+#ifndef EBTN_CONFIG_SOA
+        ebtobj->btn_table[i] = &ebtobj->btns[i];
+#endif
+        bit_array_assign(ebtobj->in_process, i, ebtn_is_btn_in_process(&ebtobj->btns[i]));
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+        prv_timer_reset(ebtobj, &ebtobj->btns[i], i);
+#endif
+    }
+    for (i = 0; i < ebtobj->btns_combo_cnt; ++i)
+    {
+        ebtobj->combo_in_process_cnt += ebtn_is_btn_in_process(&ebtobj->btns_combo[i].btn);
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+        prv_timer_reset(ebtobj, &ebtobj->btns_combo[i].btn, -1);
+#endif
+    }
+}
+
+/**
+ * \brief           Check storage of the button group cover all buttons
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \return          `1` if storage is enough, `0` otherwise
+ */
+static int prv_storage_is_valid(ebtn_t *ebtobj)
+{
+#ifdef EBTN_CONFIG_SOA
+    if (ebtobj->key_num > ebtobj->soa_capacity)
+    {
+        return 0;
+    }
+#endif
+    return ebtobj->key_num <= ebtobj->key_capacity;
+}
+
+#ifdef EBTN_CONFIG_SOA
+#ifndef EBTN_CONFIG_FIXED_PARAMS
+/**
+ * \brief           Get index of param in the shared param table, add it if not exist
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       param: Param of button
+ * \return          Index of param, `EBTN_SOA_PARAM_NONE` if table is full
+ */
+static uint8_t prv_soa_param_idx(ebtn_t *ebtobj, const ebtn_btn_param_t *param)
+{
+    uint8_t i;
+
+    for (i = 0; i < ebtobj->param_num; i++)
+    {
+        if (ebtobj->param_table[i] == param)
+        {
+            return i;
+        }
+    }
+
+    if (ebtobj->param_num >= EBTN_SOA_PARAM_NUM)
+    {
+        return EBTN_SOA_PARAM_NONE;
+    }
+    ebtobj->param_table[ebtobj->param_num] = param;
+    return ebtobj->param_num++;
+}
+#endif
+
+/**
+ * \brief           Load state of button to structure-of-arrays
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx
+ */
+static void prv_soa_load(ebtn_t *ebtobj, ebtn_btn_t *btn, int slot)
+{
+    ebtobj->soa.btn[slot] = btn;
+    ebtobj->soa.time_change[slot] = btn->time_change;
+    ebtobj->soa.time_state_change[slot] = btn->time_state_change;
+    ebtobj->soa.keepalive_last_time[slot] = btn->keepalive_last_time;
+    ebtobj->soa.click_last_time[slot] = btn->click_last_time;
+    ebtobj->soa.click_cnt[slot] = btn->click_cnt;
+    ebtobj->soa.flags[slot] = btn->flags;
+#ifdef EBTN_CONFIG_FIXED_PARAMS
+    ebtobj->soa.param_idx[slot] = EBTN_SOA_PARAM_NONE; /* Not used */
+#else
+    ebtobj->soa.param_idx[slot] = prv_soa_param_idx(ebtobj, btn->param);
+#endif
+#ifdef EBTN_CONFIG_SIMD
+    prv_soa_update_deadline(ebtobj, btn, slot, bit_array_get(ebtobj->old_state, slot), btn->time_change);
+#endif
+}
+
+/**
+ * \brief           Store state of button from structure-of-arrays back to button
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       slot: Button internal key_idx
+ */
+static void prv_soa_store(ebtn_t *ebtobj, int slot)
+{
+    ebtn_btn_t *btn = ebtobj->soa.btn[slot];
+
+    btn->time_change = ebtobj->soa.time_change[slot];
+    btn->time_state_change = ebtobj->soa.time_state_change[slot];
+    btn->keepalive_last_time = ebtobj->soa.keepalive_last_time[slot];
+    btn->click_last_time = ebtobj->soa.click_last_time[slot];
+    btn->click_cnt = ebtobj->soa.click_cnt[slot];
+    btn->flags = ebtobj->soa.flags[slot];
+}
+
+/**
+ * \brief           Attach structure-of-arrays storage, load state of all buttons in capacity
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       soa: Structure-of-arrays storage
+ * \param[in]       max_keynum: Max number of buttons of the storage
+ */
+static void prv_soa_attach(ebtn_t *ebtobj, const ebtn_soa_t *soa, int max_keynum)
+{
+    ebtn_btn_dyn_t *target;
+    int i;
+
+    ebtobj->soa = *soa;
+    ebtobj->soa_capacity = max_keynum;
+
+    for (i = 0; i < ebtobj->btns_cnt && i < max_keynum; ++i)
+    {
+        prv_soa_load(ebtobj, &ebtobj->btns[i], i);
+    }
+    for (target = ebtobj->btn_dyn_head; target && i < max_keynum; target = target->next, i++)
+    {
+        prv_soa_load(ebtobj, &target->btn, i);
+    }
+}
+
+int ebtn_set_soa_storage_ex(ebtn_t *ebtobj, const ebtn_soa_t *soa, int max_keynum)
+{
+    int i;
+
+    if (ebtobj == NULL || soa == NULL || max_keynum < ebtobj->key_num)
+    {
+        return 0;
+    }
+
+    /* Buttons in capacity of current storage hold state in it */
+    for (i = 0; i < ebtobj->key_num && i < ebtobj->soa_capacity; ++i)
+    {
+        prv_soa_store(ebtobj, i);
+    }
+    prv_soa_attach(ebtobj, soa, max_keynum);
+
+    return 1;
+}
+
+int ebtn_set_soa_storage(const ebtn_soa_t *soa, int max_keynum)
+{
+    return ebtn_set_soa_storage_ex(&ebtn_default, soa, max_keynum);
+}
+#endif
+
+/**
+ * \brief           Get combo-button key bitmap and number of bits can be used
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       combo: Combo-button instance
+ * \param[out]      num_bits: Number of bits of the key bitmap in use
+ * \return          Key bitmap of combo-button
+ */
+static bit_array_t *prv_combo_get_key(ebtn_t *ebtobj, ebtn_btn_combo_t *combo, int *num_bits)
+{
+    if (combo->comb_key_ext)
+    {
+        *num_bits = ebtobj->key_num;
+        return combo->comb_key_ext;
+    }
+
+    *num_bits = ebtobj->key_num < EBTN_MAX_KEYNUM ? ebtobj->key_num : EBTN_MAX_KEYNUM;
+    return combo->comb_key;
+}
+
+/**
+ * \brief           Get combo-button state from all button state
+ *
+ * \param[in]       state: All button state
+ * \param[in]       comb_key: Combo key
+ * \param[in]       num_bits: Number of bits of the combo key
+ * \return          `1` if all keys of combo-button are active, `0` otherwise
+ */
+static uint8_t prv_combo_get_state(const bit_array_t *state, const bit_array_t *comb_key, int num_bits)
+{
+    for (int i = 0; i < (int)BIT_ARRAY_BITMAP_SIZE(num_bits); i++)
+    {
+        if ((state[i] & comb_key[i]) != comb_key[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+/**
+ * \brief           Add combo-button to the combo index
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       combo: Combo-button to add
+ * \param[in]       cidx: Combo index of combo-button
+ */
+static void prv_combo_index_insert(ebtn_t *ebtobj, ebtn_btn_combo_t *combo, int cidx)
+{
+    int row_words = BIT_ARRAY_BITMAP_SIZE(ebtobj->combo_index_capacity);
+    int num_bits;
+    bit_array_t *comb_key = prv_combo_get_key(ebtobj, combo, &num_bits);
+    int i;
+
+    ebtobj->combo_ptr[cidx] = combo;
+    combo->key_cnt = 0;
+    combo->key_active_cnt = 0;
+    for (i = 0; i < (int)BIT_ARRAY_BITMAP_SIZE(num_bits); i++)
+    {
+        bit_array_val_t keys = comb_key[i];
+
+        while (keys)
+        {
+            int idx = i * BIT_ARRAY_BITS + CTZ(keys);
+
+            keys &= keys - 1;
+            if (idx >= num_bits)
+            {
+                break;
+            }
+            bit_array_set(&ebtobj->combo_key_map[idx * row_words], cidx);
+            combo->key_cnt++;
+            combo->key_active_cnt += bit_array_get(ebtobj->old_state, idx);
+        }
+    }
+
+    if (combo->key_cnt && combo->key_active_cnt == combo->key_cnt)
+    {
+        combo->btn.flags |= EBTN_FLAG_COMBO_ACTIVE;
+    }
+    else
+    {
+        combo->btn.flags &= ~EBTN_FLAG_COMBO_ACTIVE;
+    }
+}
+#endif
+
+/**
+ * \brief           Re-evaluate all registered combo-buttons, and rebuild the combo index with `EBTN_CONFIG_COMBO_INDEX`
+ *
+ * Keys of combo-buttons may be changed since last build, combo-button becomes active without
+ * key changed is set in process, and all combo-buttons in process are processed in next process.
+ *
+ * \param[in]       ebtobj: Button group instance
+ */
+static void prv_combo_rebuild(ebtn_t *ebtobj)
+{
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    int row_words = BIT_ARRAY_BITMAP_SIZE(ebtobj->combo_index_capacity);
+#endif
+    ebtn_btn_combo_dyn_t *target = ebtobj->btn_combo_dyn_head;
+    ebtn_btn_combo_t *combo;
+    uint8_t active;
+    int num_bits;
+    bit_array_t *comb_key;
+    int i;
+
+    ebtobj->combo_dirty = 0;
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    ebtobj->combo_index_valid = ebtobj->combo_num <= ebtobj->combo_index_capacity && ebtobj->key_num <= ebtobj->combo_index_keynum;
+    if (ebtobj->combo_index_valid)
+    {
+        memset(ebtobj->combo_key_map, 0x00, (ebtobj->key_num + 2) * row_words * sizeof(bit_array_t));
+        ebtobj->combo_touched = &ebtobj->combo_key_map[ebtobj->key_num * row_words];
+        ebtobj->combo_in_process = &ebtobj->combo_touched[row_words];
+    }
+#endif
+
+    for (i = 0; i < ebtobj->btns_combo_cnt || target != NULL; i++)
+    {
+        if (i < ebtobj->btns_combo_cnt)
+        {
+            combo = &ebtobj->btns_combo[i];
+        }
+        else
+        {
+            combo = &target->btn;
+            target = target->next;
+        }
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+        if (ebtobj->combo_index_valid)
+        {
+            prv_combo_index_insert(ebtobj, combo, i);
+            active = (combo->btn.flags & EBTN_FLAG_COMBO_ACTIVE) != 0;
+        }
+        else
+#endif
+        {
+            comb_key = prv_combo_get_key(ebtobj, combo, &num_bits);
+            active = bit_array_is_any_set(comb_key, num_bits) && prv_combo_get_state(ebtobj->old_state, comb_key, num_bits);
+        }
+
+        if (active && prv_btn_get_param(ebtobj, &combo->btn, -1) != NULL && !ebtn_is_btn_in_process(&combo->btn))
+        {
+            combo->btn.flags |= EBTN_FLAG_IN_PROCESS;
+            ebtobj->combo_in_process_cnt++;
+        }
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+        if (ebtn_is_btn_in_process(&combo->btn))
+        {
+            prv_timer_wheel_remove(&ebtobj->timer_wheel, &combo->btn.timer);
+            prv_timer_expired(ebtobj, &combo->btn.timer);
+        }
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+        if (ebtobj->combo_index_valid)
+        {
+            bit_array_assign(ebtobj->combo_in_process, i, ebtn_is_btn_in_process(&combo->btn));
+        }
+#endif
+    }
+}
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+int ebtn_set_combo_index_storage_ex(ebtn_t *ebtobj, bit_array_t *storage, ebtn_btn_combo_t **combos, int max_keynum, int max_combonum)
+{
+    if (ebtobj == NULL || storage == NULL || combos == NULL || max_keynum <= 0 || max_combonum <= 0)
+    {
+        return 0;
+    }
+
+    ebtobj->combo_key_map = storage;
+    ebtobj->combo_ptr = combos;
+    ebtobj->combo_index_keynum = max_keynum;
+    ebtobj->combo_index_capacity = max_combonum;
+    prv_combo_rebuild(ebtobj);
+
+    return 1;
+}
+
+int ebtn_set_combo_index_storage(bit_array_t *storage, ebtn_btn_combo_t **combos, int max_keynum, int max_combonum)
+{
+    return ebtn_set_combo_index_storage_ex(&ebtn_default, storage, combos, max_keynum, max_combonum);
+}
+#endif
+
+#ifdef EBTN_CONFIG_KEY_INDEX
+/**
+ * \brief           Get start position of key_id in the key index hash table
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       key_id: key_id to hash
+ * \return          Position in key_hash
+ */
+static uint16_t prv_key_index_hash(ebtn_t *ebtobj, uint16_t key_id)
+{
+    return (uint16_t)((((uint32_t)key_id * 0x9E3779B1UL) >> 16) % ebtobj->key_hash_size);
+}
+
+/**
+ * \brief           Add button to the key index, first button of duplicated key_id is kept
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button to add
+ */
+static void prv_key_index_insert(ebtn_t *ebtobj, ebtn_btn_t *btn)
+{
+    uint16_t pos;
+
+    if (btn->key_id < EBTN_KEY_ID_DIRECT_NUM)
+    {
+        if (ebtobj->key_direct[btn->key_id] == NULL)
+        {
+            ebtobj->key_direct[btn->key_id] = btn;
+        }
+        return;
+    }
+
+    if (ebtobj->key_hash_cnt >= ebtobj->key_hash_size)
+    {
+        ebtobj->key_hash_overflow = 1;
+        return;
+    }
+
+    for (pos = prv_key_index_hash(ebtobj, btn->key_id); ebtobj->key_hash[pos] != NULL; pos = (pos + 1) % ebtobj->key_hash_size)
+    {
+        if (ebtobj->key_hash[pos]->key_id == btn->key_id)
+        {
+            return;
+        }
+    }
+    ebtobj->key_hash[pos] = btn;
+    ebtobj->key_hash_cnt++;
+}
+
+/**
+ * \brief           Rebuild the key index from all registered buttons
+ *
+ * \param[in]       ebtobj: Button group instance
+ */
+static void prv_key_index_build(ebtn_t *ebtobj)
+{
+    ebtn_btn_dyn_t *target;
+    int i;
+
+    memset(ebtobj->key_direct, 0x00, sizeof(ebtobj->key_direct));
+    memset(ebtobj->key_hash, 0x00, ebtobj->key_hash_size * sizeof(ebtobj->key_hash[0]));
+    ebtobj->key_hash_cnt = 0;
+    ebtobj->key_hash_overflow = 0;
+
+    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    {
+        prv_key_index_insert(ebtobj, &ebtobj->btns[i]);
+    }
+    for (target = ebtobj->btn_dyn_head; target; target = target->next)
+    {
+        prv_key_index_insert(ebtobj, &target->btn);
+    }
+}
+
+#endif
+
+/**
+ * \brief           Find button by key_id, through the key index with EBTN_CONFIG_KEY_INDEX
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       key_id: key_id to find
+ * \return          First button of key_id, `NULL` if not found
+ */
+static ebtn_btn_t *prv_key_index_find(ebtn_t *ebtobj, uint16_t key_id)
+{
+    ebtn_btn_dyn_t *target;
+    int i;
+
+#ifdef EBTN_CONFIG_KEY_INDEX
+    uint16_t pos;
+    uint16_t n;
+
+    if (key_id < EBTN_KEY_ID_DIRECT_NUM)
+    {
+        return ebtobj->key_direct[key_id];
+    }
+
+    for (pos = prv_key_index_hash(ebtobj, key_id), n = 0; n < ebtobj->key_hash_size && ebtobj->key_hash[pos] != NULL;
+         pos = (pos + 1) % ebtobj->key_hash_size, n++)
+    {
+        if (ebtobj->key_hash[pos]->key_id == key_id)
+        {
+            return ebtobj->key_hash[pos];
+        }
+    }
+
+    if (!ebtobj->key_hash_overflow)
+    {
+        return NULL;
+    }
+
+#endif
+    /* No key index, or hash table is full and some buttons are not indexed */
+    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    {
+        if (ebtobj->btns[i].key_id == key_id)
+        {
+            return &ebtobj->btns[i];
+        }
+    }
+    for (target = ebtobj->btn_dyn_head; target; target = target->next)
+    {
+        if (target->btn.key_id == key_id)
+        {
+            return &target->btn;
+        }
+    }
+    return NULL;
+}
+
+#ifdef EBTN_CONFIG_KEY_INDEX
+int ebtn_set_key_index_storage_ex(ebtn_t *ebtobj, ebtn_btn_t **storage, uint16_t size)
+{
+    if (ebtobj == NULL || storage == NULL || size == 0)
+    {
+        return 0;
+    }
+
+    ebtobj->key_hash = storage;
+    ebtobj->key_hash_size = size;
+    prv_key_index_build(ebtobj);
+
+    return 1;
+}
+
+int ebtn_set_key_index_storage(ebtn_btn_t **storage, uint16_t size)
+{
+    return ebtn_set_key_index_storage_ex(&ebtn_default, storage, size);
+}
+#endif
+
+int ebtn_set_state_storage_ex(ebtn_t *ebtobj, bit_array_t *storage, int max_keynum)
+{
+    if (ebtobj == NULL || storage == NULL || max_keynum < ebtobj->btns_cnt || ebtobj->btn_dyn_head != NULL)
+    {
+        return 0;
+    }
+
+    prv_state_storage_attach(ebtobj, storage, max_keynum);
+    ebtobj->combo_dirty = 1;
+
+    return 1;
+}
+
+int ebtn_set_state_storage(bit_array_t *storage, int max_keynum)
+{
+    return ebtn_set_state_storage_ex(&ebtn_default, storage, max_keynum);
+}
+
+int ebtn_set_get_state_bulk_ex(ebtn_t *ebtobj, ebtn_get_state_bulk_fn get_state_bulk_fn, void *arg)
+{
+    if (ebtobj == NULL)
+    {
+        return 0;
+    }
+
+    ebtobj->state_providers = NULL;
+    if (get_state_bulk_fn != NULL)
+    {
+        ebtobj->state_provider.fn = get_state_bulk_fn;
+        ebtobj->state_provider.arg = arg;
+        ebtobj->state_provider.word_begin = 0;
+        ebtobj->state_provider.word_end = 0;
+        ebtobj->state_provider.next = NULL;
+        ebtobj->state_providers = &ebtobj->state_provider;
+    }
+
+    return 1;
+}
+
+int ebtn_set_get_state_bulk(ebtn_get_state_bulk_fn get_state_bulk_fn, void *arg)
+{
+    return ebtn_set_get_state_bulk_ex(&ebtn_default, get_state_bulk_fn, arg);
+}
+
+/**
+ * \brief           Get one past last state word of a provider range, open range ends after any word
+ *
+ * \param[in]       provider: Bulk state provider
+ * \return          One past last state word
+ */
+static int prv_state_provider_end(const ebtn_state_provider_t *provider)
+{
+    return provider->word_end != 0 ? provider->word_end : (int)UINT16_MAX + 1;
+}
+
+int ebtn_add_state_provider_ex(ebtn_t *ebtobj, ebtn_state_provider_t *provider)
+{
+    ebtn_state_provider_t *target;
+
+    if (ebtobj == NULL || provider == NULL || provider->fn == NULL || provider->word_begin >= prv_state_provider_end(provider))
+    {
+        return 0;
+    }
+
+    for (target = ebtobj->state_providers; target; target = target->next)
+    {
+        if (target == provider
+            || (provider->word_begin < prv_state_provider_end(target) && target->word_begin < prv_state_provider_end(provider)))
+        {
+            return 0; /* already added, or words overlap. */
+        }
+    }
+
+    provider->next = ebtobj->state_providers;
+    ebtobj->state_providers = provider;
+
+    return 1;
+}
+
+int ebtn_add_state_provider(ebtn_state_provider_t *provider)
+{
+    return ebtn_add_state_provider_ex(&ebtn_default, provider);
+}
+
+int ebtn_init_ex(ebtn_t *ebtobj, ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo, uint16_t btns_combo_cnt, ebtn_get_state_fn get_state_fn,
+                 ebtn_evt_fn evt_fn)
+{
+    if (ebtobj == NULL /* get_state_fn can be NULL for edge-fed or bulk read button group, see ebtn_feed_edge_ex() */
+    )
+    {
+        return 0;
+    }
+#ifndef EBTN_CONFIG_EVT_RING
+    if (evt_fn == NULL) /* Events are queued in event ring when not set */
+    {
+        return 0;
+    }
+#endif
+
+    memset(ebtobj, 0x00, sizeof(*ebtobj));
+    ebtobj->btns = btns;
+    ebtobj->btns_cnt = btns_cnt;
+    ebtobj->btns_combo = btns_combo;
+    ebtobj->btns_combo_cnt = btns_combo_cnt;
+    ebtobj->evt_fn = evt_fn;
+    ebtobj->get_state_fn = get_state_fn;
+    ebtobj->key_num = btns_cnt;
+    do
+    {
+        ebtobj->group_gen = (uint32_t)EBTN_ATOMIC_INC(&ebtn_group_gen);
+    } while (ebtobj->group_gen == 0); /* `0` means not registered */
+#ifdef EBTN_CONFIG_KEY_INDEX
+    ebtobj->key_hash = ebtobj->key_hash_storage;
+    ebtobj->key_hash_size = EBTN_KEY_HASH_NUM;
+    prv_key_index_build(ebtobj);
+#endif
+
+    /* More buttons than EBTN_MAX_KEYNUM need caller storage, see ebtn_set_state_storage_ex() */
+    prv_state_storage_attach(ebtobj, ebtobj->state_storage, EBTN_MAX_KEYNUM);
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    ebtobj->combo_num = btns_combo_cnt;
+    ebtobj->combo_key_map = ebtobj->combo_index_storage;
+    ebtobj->combo_ptr = ebtobj->combo_ptr_storage;
+    ebtobj->combo_index_keynum = EBTN_MAX_KEYNUM;
+    ebtobj->combo_index_capacity = EBTN_MAX_COMBONUM;
+#endif
+    ebtobj->combo_dirty = 1;
+
+#ifdef EBTN_CONFIG_SOA
+    {
+        ebtn_soa_t soa = EBTN_SOA_INIT(ebtobj->soa_storage);
+        prv_soa_attach(ebtobj, &soa, EBTN_MAX_KEYNUM);
+    }
+#endif
+#ifdef EBTN_CONFIG_SIMD
+    ebtn_simd_select_ex(ebtobj, prv_simd_default);
+#endif
+
+#ifdef EBTN_CONFIG_EVT_RING
+    ebtobj->evt_ring = ebtobj->evt_ring_storage;
+    ebtobj->evt_ring_size = EBTN_EVT_RING_SIZE;
+#endif
+
+    return 1;
+}
+
+int ebtn_init(ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo, uint16_t btns_combo_cnt, ebtn_get_state_fn get_state_fn, ebtn_evt_fn evt_fn)
+{
+    return ebtn_init_ex(&ebtn_default, btns, btns_cnt, btns_combo, btns_combo_cnt, get_state_fn, evt_fn);
+}
+
+int ebtn_input_channel_init(ebtn_input_channel_t *ch, ebtn_input_edge_t *storage, uint16_t size)
+{
+    if (ch == NULL || storage == NULL || size == 0 || (size & (size - 1)) != 0)
+    {
+        return 0;
+    }
+
+    memset(ch, 0x00, sizeof(*ch));
+    ch->edges = storage;
+    ch->size = size;
+
+    return 1;
+}
+
+int ebtn_input_channel_push(ebtn_input_channel_t *ch, uint16_t key_id, uint8_t state, ebtn_time_t time)
+{
+    uint16_t head = ch->head;
+    volatile ebtn_input_edge_t *edge;
+
+    if ((uint16_t)(head - EBTN_ATOMIC_LOAD(&ch->tail)) >= ch->size)
+    {
+        ch->dropped++;
+        return 0;
+    }
+
+    edge = &ch->edges[head & (ch->size - 1)];
+    edge->time = time;
+    edge->key_id = key_id;
+    edge->state = state;
+    EBTN_ATOMIC_STORE(&ch->head, (uint16_t)(head + 1)); /* Publish edge after it is written */
+
+    return 1;
+}
+
+/**
+ * \brief           Read the oldest input edge without removing it, called by consumer only
+ *
+ * \param[in]       ch: Input channel instance
+ * \param[out]      edge: Input edge
+ * \return          `1` on success, `0` if channel is empty
+ */
+static int prv_input_channel_peek(ebtn_input_channel_t *ch, ebtn_input_edge_t *edge)
+{
+    uint16_t tail = ch->tail;
+    const volatile ebtn_input_edge_t *slot;
+
+    if (tail == EBTN_ATOMIC_LOAD(&ch->head))
+    {
+        return 0;
+    }
+
+    slot = &ch->edges[tail & (ch->size - 1)];
+    edge->time = slot->time;
+    edge->key_id = slot->key_id;
+    edge->state = slot->state;
+
+    return 1;
+}
+
+/**
+ * \brief           Remove the oldest input edge got by prv_input_channel_peek(), called by consumer only
+ *
+ * \param[in]       ch: Input channel instance
+ */
+static void prv_input_channel_skip(ebtn_input_channel_t *ch)
+{
+    EBTN_ATOMIC_STORE(&ch->tail, (uint16_t)(ch->tail + 1)); /* Release slot after it is read */
+}
+
+int ebtn_input_channel_pop(ebtn_input_channel_t *ch, ebtn_input_edge_t *edge)
+{
+    if (!prv_input_channel_peek(ch, edge))
+    {
+        return 0;
+    }
+    prv_input_channel_skip(ch);
+
+    return 1;
+}
+
+int ebtn_input_channel_drain_ex(ebtn_t *ebtobj, ebtn_input_channel_t *ch, bit_array_t *curr_state)
+{
+    bit_array_t *drained = ebtobj->changed; /* Only used in process, keys drained in between */
+    ebtn_input_edge_t edge;
+    int cnt = 0;
+    int idx;
+
+    if (curr_state == ebtobj->curr_state)
+    {
+        ebtobj->curr_state_synced = 0;
+    }
+
+    /* At most one channel of edges, producer pushing meanwhile can not keep consumer here */
+    while (cnt < ch->size && prv_input_channel_peek(ch, &edge))
+    {
+        idx = ebtn_get_btn_index_by_key_id_ex(ebtobj, edge.key_id);
+        if (idx >= 0)
+        {
+            if (bit_array_get(drained, idx))
+            {
+                break; /* Second edge of a key waits for next process, or a short press would be lost */
+            }
+            bit_array_set(drained, idx);
+            bit_array_assign(curr_state, idx, edge.state != 0);
+        }
+        prv_input_channel_skip(ch);
+        cnt++;
+    }
+
+    memset(drained, 0x00, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num) * sizeof(bit_array_t));
+
+    return cnt;
+}
+
+int ebtn_input_channel_drain(ebtn_input_channel_t *ch, bit_array_t *curr_state)
+{
+    return ebtn_input_channel_drain_ex(&ebtn_default, ch, curr_state);
+}
+
+/**
+ * \brief           Process timeouts of an edge-fed button group at their deadlines, until time of the next edge
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Time in ms of the next edge
+ */
+static void prv_feed_timeouts(ebtn_t *ebtobj, ebtn_time_t mstime)
+{
+    ebtn_time_t deadline;
+
+    /* Deadline at last fed time is already due, it is processed with the edge */
+    while (ebtobj->feed_time_valid && ebtn_get_next_deadline_ex(ebtobj, ebtobj->feed_time, &deadline) && deadline != ebtobj->feed_time &&
+           ebtn_timer_sub(mstime, deadline) > 0)
+    {
+        ebtn_feed_time_ex(ebtobj, deadline);
+    }
+}
+
+int ebtn_input_channel_feed_ex(ebtn_t *ebtobj, ebtn_input_channel_t *ch)
+{
+    ebtn_input_edge_t edge;
+    int cnt = 0;
+
+    /* At most one channel of edges, producer pushing meanwhile can not keep consumer here */
+    while (cnt < ch->size && ebtn_input_channel_pop(ch, &edge))
+    {
+        cnt++;
+        ebtn_feed_edge_ex(ebtobj, edge.key_id, edge.state, edge.time);
+    }
+
+    return cnt;
+}
+
+int ebtn_input_channel_feed(ebtn_input_channel_t *ch)
+{
+    return ebtn_input_channel_feed_ex(&ebtn_default, ch);
+}
+
+#ifdef EBTN_CONFIG_EVT_RING
+int ebtn_set_evt_ring_storage_ex(ebtn_t *ebtobj, ebtn_evt_record_t *storage, uint16_t size)
+{
+    if (ebtobj == NULL || storage == NULL || size == 0 || (size & (size - 1)) != 0)
+    {
+        return 0;
+    }
+
+    ebtobj->evt_ring = storage;
+    ebtobj->evt_ring_size = size;
+    ebtobj->evt_ring_head = 0;
+    ebtobj->evt_ring_tail = 0;
+
+    return 1;
+}
+
+int ebtn_set_evt_ring_storage(ebtn_evt_record_t *storage, uint16_t size)
+{
+    return ebtn_set_evt_ring_storage_ex(&ebtn_default, storage, size);
+}
+
+int ebtn_events_drain_ex(ebtn_t *ebtobj, ebtn_evt_record_t *buf, int max)
+{
+    int cnt = 0;
+
+    if (ebtobj == NULL || buf == NULL)
+    {
+        return 0;
+    }
+
+    while (cnt < max && ebtobj->evt_ring_tail != ebtobj->evt_ring_head)
+    {
+        buf[cnt++] = ebtobj->evt_ring[ebtobj->evt_ring_tail & (ebtobj->evt_ring_size - 1)];
+        ebtobj->evt_ring_tail++;
+    }
+
+    return cnt;
+}
+
+int ebtn_events_drain(ebtn_evt_record_t *buf, int max)
+{
+    return ebtn_events_drain_ex(&ebtn_default, buf, max);
+}
+
+int ebtn_events_pending_ex(ebtn_t *ebtobj)
+{
+    return (uint16_t)(ebtobj->evt_ring_head - ebtobj->evt_ring_tail);
+}
+
+int ebtn_events_pending(void)
+{
+    return ebtn_events_pending_ex(&ebtn_default);
+}
+
+void ebtn_events_set_policy_ex(ebtn_t *ebtobj, ebtn_evt_ring_policy_t policy)
+{
+    ebtobj->evt_ring_policy = (uint8_t)policy;
+}
+
+void ebtn_events_set_policy(ebtn_evt_ring_policy_t policy)
+{
+    ebtn_events_set_policy_ex(&ebtn_default, policy);
+}
+
+void ebtn_events_get_stats_ex(ebtn_t *ebtobj, ebtn_evt_ring_stats_t *stats, int reset)
+{
+    if (stats != NULL)
+    {
+        *stats = ebtobj->evt_ring_stats;
+    }
+    if (reset)
+    {
+        memset(&ebtobj->evt_ring_stats, 0x00, sizeof(ebtobj->evt_ring_stats));
+    }
+}
+
+void ebtn_events_get_stats(ebtn_evt_ring_stats_t *stats, int reset)
+{
+    ebtn_events_get_stats_ex(&ebtn_default, stats, reset);
+}
+#endif
+
+/**
+ * \brief           Get all button state with get_state_fn.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[out]      state_array: store the button state
+ */
+static void ebtn_get_current_state(ebtn_t *ebtobj, bit_array_t *state_array)
+{
+    ebtn_btn_dyn_t *target;
+    int i;
+
+    /* Process all buttons */
+    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    {
+        /* Get button state */
+        uint8_t new_state = ebtobj->get_state_fn(&ebtobj->btns[i]);
+        // save state
+        bit_array_assign(state_array, i, new_state);
+    }
+
+    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    {
+        /* Get button state */
+        uint8_t new_state = ebtobj->get_state_fn(&target->btn);
+
+        // save state
+        bit_array_assign(state_array, i, new_state);
+    }
+}
+
+/**
+ * \brief           Get all button state with bulk state providers, every provider is called once for its words.
+ * Words not covered by any provider keep last state.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[out]      state_array: store the button state
+ */
+static void ebtn_get_current_state_bulk(ebtn_t *ebtobj, bit_array_t *state_array)
+{
+    const ebtn_state_provider_t *provider;
+    int words = BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num);
+    int tail = ebtobj->key_num % BIT_ARRAY_BITS;
+    int word_end;
+
+    if (ebtobj->key_num == 0)
+    {
+        return;
+    }
+
+    if (ebtobj->state_providers != &ebtobj->state_provider)
+    {
+        bit_array_copy_all(state_array, ebtobj->old_state, ebtobj->key_num); /* some words may not be covered. */
+    }
+
+    for (provider = ebtobj->state_providers; provider; provider = provider->next)
+    {
+        word_end = prv_state_provider_end(provider);
+        if (word_end > words)
+        {
+            word_end = words;
+        }
+        if (provider->word_begin < word_end)
+        {
+            provider->fn(ebtobj, state_array, provider->word_begin, word_end, provider->arg);
+        }
+    }
+
+    /* Bits over key_num must stay 0, or they are seen as changed buttons */
+    if (tail)
+    {
+        state_array[words - 1] &= BIT_ARRAY_SUB_MASK(tail);
+    }
+}
+
+/**
+ * \brief           Process the button state
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance to process
+ * \param[in]       old_state: all button old state
+ * \param[in]       curr_state: all button current state
+ * \param[in]       idx: Button internal key_idx
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void ebtn_process_btn(ebtn_t *ebtobj, ebtn_btn_t *btn, bit_array_t *old_state, bit_array_t *curr_state, int idx, ebtn_time_t mstime)
+{
+    prv_process_btn(ebtobj, btn, idx, bit_array_get(old_state, idx), bit_array_get(curr_state, idx), mstime);
+
+    bit_array_assign(ebtobj->in_process, idx, prv_btn_is_in_process(ebtobj, btn, idx));
+#ifdef EBTN_CONFIG_SIMD
+    prv_soa_update_deadline(ebtobj, btn, idx, bit_array_get(curr_state, idx), mstime);
+#endif
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    bit_array_clear(ebtobj->timer_due, idx);
+    prv_timer_schedule(ebtobj, btn, idx, bit_array_get(curr_state, idx), mstime);
+#endif
+}
+
+/**
+ * \brief           Process the combo-button state
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       combo: Combo-button instance to process
+ * \param[in]       touched: Some keys of combo-button changed in this process
+ * \param[in]       old: Old combo-button state
+ * \param[in]       curr: Current combo-button state
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void ebtn_process_btn_combo(ebtn_t *ebtobj, ebtn_btn_combo_t *combo, int touched, uint8_t old, uint8_t curr, ebtn_time_t mstime)
+{
+    ebtn_btn_t *btn = &combo->btn;
+    int in_process = ebtn_is_btn_in_process(btn);
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    /* Nothing to do when combo timer not expired and none of its keys changed. */
+    if (!(btn->flags & EBTN_FLAG_TIMER_DUE) && !touched)
+    {
+        return;
+    }
+    if (btn->flags & EBTN_FLAG_TIMER_DUE)
+    {
+        btn->flags &= ~EBTN_FLAG_TIMER_DUE;
+        ebtobj->combo_due_cnt--;
+    }
+#else
+    /* Nothing to do when combo is idle and none of its keys changed. */
+    if (!in_process && !touched)
+    {
+        return;
+    }
+#endif
+
+    prv_process_btn(ebtobj, btn, -1, old, curr, mstime);
+
+    ebtobj->combo_in_process_cnt += ebtn_is_btn_in_process(btn) - in_process;
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_schedule(ebtobj, btn, -1, curr, mstime);
+#endif
+}
+
+/**
+ * \brief           Process the combo-button state from its key bitmap, used when combo index not valid
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       combo: Combo-button instance to process
+ * \param[in]       curr_state: all button current state
+ * \param[in]       changed: all button changed state, old_state ^ curr_state
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_process_combo_scan(ebtn_t *ebtobj, ebtn_btn_combo_t *combo, bit_array_t *curr_state, bit_array_t *changed, ebtn_time_t mstime)
+{
+    int num_bits;
+    bit_array_t *comb_key = prv_combo_get_key(ebtobj, combo, &num_bits);
+    int touched = bit_array_is_overlap(changed, comb_key, num_bits);
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    if (!(combo->btn.flags & EBTN_FLAG_TIMER_DUE) && !touched)
+#else
+    if (!ebtn_is_btn_in_process(&combo->btn) && !touched)
+#endif
+    {
+        return;
+    }
+
+    if (!bit_array_is_any_set(comb_key, num_bits))
+    {
+        return;
+    }
+
+    ebtn_process_btn_combo(ebtobj, combo, touched, prv_combo_get_state(ebtobj->old_state, comb_key, num_bits),
+                           prv_combo_get_state(curr_state, comb_key, num_bits), mstime);
+}
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+/**
+ * \brief           Process combo-buttons with keys changed or in process through the combo index
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: all button current state
+ * \param[in]       changed: all button changed state, old_state ^ curr_state
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_process_combo_indexed(ebtn_t *ebtobj, bit_array_t *curr_state, bit_array_t *changed, ebtn_time_t mstime)
+{
+    int row_words = BIT_ARRAY_BITMAP_SIZE(ebtobj->combo_index_capacity);
+    int words = BIT_ARRAY_BITMAP_SIZE(ebtobj->combo_num);
+    int i, j;
+
+    /* Update active key count of combo-buttons of every changed key */
+    for (i = 0; i < (int)BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num); i++)
+    {
+        bit_array_val_t keys = changed[i];
+
+        while (keys)
+        {
+            int idx = i * BIT_ARRAY_BITS + CTZ(keys);
+            bit_array_t *row = &ebtobj->combo_key_map[idx * row_words];
+            uint16_t delta = bit_array_get(curr_state, idx) ? 1 : (uint16_t)-1;
+
+            keys &= keys - 1;
+            for (j = 0; j < words; j++)
+            {
+                bit_array_val_t combos = row[j];
+
+                ebtobj->combo_touched[j] |= combos;
+                while (combos)
+                {
+                    ebtobj->combo_ptr[j * BIT_ARRAY_BITS + CTZ(combos)]->key_active_cnt += delta;
+                    combos &= combos - 1;
+                }
+            }
+        }
+    }
+
+    /* Process in combo index order, same as static array then dynamic list */
+    for (j = 0; j < words; j++)
+    {
+        bit_array_val_t touched = ebtobj->combo_touched[j];
+        bit_array_val_t combos = touched | ebtobj->combo_in_process[j];
+
+        ebtobj->combo_touched[j] = 0;
+        while (combos)
+        {
+            int cidx = j * BIT_ARRAY_BITS + CTZ(combos);
+            ebtn_btn_combo_t *combo = ebtobj->combo_ptr[cidx];
+            uint8_t old = (combo->btn.flags & EBTN_FLAG_COMBO_ACTIVE) != 0;
+            uint8_t curr = combo->key_active_cnt == combo->key_cnt;
+
+            combos &= combos - 1;
+            if (combo->key_cnt == 0)
+            {
+                continue;
+            }
+            if (curr)
+            {
+                combo->btn.flags |= EBTN_FLAG_COMBO_ACTIVE;
+            }
+            else
+            {
+                combo->btn.flags &= ~EBTN_FLAG_COMBO_ACTIVE;
+            }
+
+            ebtn_process_btn_combo(ebtobj, combo, (touched >> (cidx % BIT_ARRAY_BITS)) & 1, old, curr, mstime);
+            bit_array_assign(ebtobj->combo_in_process, cidx, ebtn_is_btn_in_process(&combo->btn));
+        }
+    }
+}
+#endif
+
+/**
+ * \brief           Get buttons of a state bitmap word which need process even input not change
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       word: Word of state bitmap
+ * \param[in]       mstime: Current milliseconds system time
+ * \return          Bitmask of buttons of the word
+ */
+static bit_array_val_t prv_get_pending_mask(ebtn_t *ebtobj, int word, ebtn_time_t mstime)
+{
+#if defined(EBTN_CONFIG_TIMER_WHEEL)
+    (void)mstime;
+    return ebtobj->timer_due[word];
+#elif defined(EBTN_CONFIG_SIMD)
+    return prv_get_due_mask(ebtobj, word, mstime);
+#else
+    (void)mstime;
+    return ebtobj->in_process[word];
+#endif
+}
+
+/**
+ * \brief           Process buttons of a range of state bitmap words, only buttons which changed state or still in process, in key_idx order
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: all button current state
+ * \param[in]       word_begin: First word of range
+ * \param[in]       word_end: Word after last word of range
+ * \param[in]       mstime: Current milliseconds system time
+ * \return          `1` if some button of range changed state, `0` otherwise
+ */
+static int prv_process_btn_words(ebtn_t *ebtobj, bit_array_t *curr_state, int word_begin, int word_end, ebtn_time_t mstime)
+{
+    bit_array_t *changed = ebtobj->changed;
+    int changed_any = 0;
+    int i;
+
+    for (i = word_begin; i < word_end; i++)
+    {
+        bit_array_val_t active;
+
+        changed[i] = ebtobj->old_state[i] ^ curr_state[i];
+        active = changed[i] | prv_get_pending_mask(ebtobj, i, mstime);
+
+        changed_any |= (changed[i] != 0);
+        while (active)
+        {
+            int idx = i * BIT_ARRAY_BITS + CTZ(active);
+            active &= active - 1;
+
+            /* Button of key_idx by table, no list walk for dynamic buttons */
+            ebtn_process_btn(ebtobj, EBTN_KEY_BTN(ebtobj, idx), ebtobj->old_state, curr_state, idx, mstime);
+        }
+    }
+
+    return changed_any;
+}
+
+/**
+ * \brief           Process combo-buttons after all buttons processed, old_state is still state of last process
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: all button current state
+ * \param[in]       changed_any: Some button changed state in this process
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_process_combos(ebtn_t *ebtobj, bit_array_t *curr_state, int changed_any, ebtn_time_t mstime)
+{
+    bit_array_t *changed = ebtobj->changed;
+    ebtn_btn_combo_dyn_t *target_combo;
+    int i;
+
+    if (ebtobj->combo_dirty)
+    {
+        prv_combo_rebuild(ebtobj);
+    }
+
+    /* Process comb buttons, only when some key changed or some combo still in process */
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    if (changed_any || ebtobj->combo_due_cnt)
+#else
+    if (changed_any || ebtobj->combo_in_process_cnt)
+#endif
+    {
+#ifdef EBTN_CONFIG_COMBO_INDEX
+        if (ebtobj->combo_index_valid)
+        {
+            prv_process_combo_indexed(ebtobj, curr_state, changed, mstime);
+        }
+        else
+#endif
+        {
+            for (i = 0; i < ebtobj->btns_combo_cnt; ++i)
+            {
+                prv_process_combo_scan(ebtobj, &ebtobj->btns_combo[i], curr_state, changed, mstime);
+            }
+
+            for (target_combo = ebtobj->btn_combo_dyn_head; target_combo; target_combo = target_combo->next)
+            {
+                prv_process_combo_scan(ebtobj, &target_combo->btn, curr_state, changed, mstime);
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Process combo-buttons after all buttons processed, and keep current state as old state
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: all button current state
+ * \param[in]       changed_any: Some button changed state in this process
+ * \param[in]       mstime: Current milliseconds system time
+ */
+static void prv_process_finish(ebtn_t *ebtobj, bit_array_t *curr_state, int changed_any, ebtn_time_t mstime)
+{
+    prv_process_combos(ebtobj, curr_state, changed_any, mstime);
+
+    bit_array_copy_all(ebtobj->old_state, curr_state, ebtobj->key_num);
+    /* Changed state is clear between processes, a fed edge only sets its own bit */
+    memset(ebtobj->changed, 0x00, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num) * sizeof(bit_array_t));
+    ebtobj->curr_state_synced = curr_state == ebtobj->curr_state;
+}
+
+void ebtn_process_with_curr_state_ex(ebtn_t *ebtobj, bit_array_t *curr_state, ebtn_time_t mstime)
+{
+    int changed_any;
+
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return; /* state storage is not enough. */
+    }
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_wheel_advance(ebtobj, mstime);
+#endif
+
+    changed_any = prv_process_btn_words(ebtobj, curr_state, 0, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num), mstime);
+
+    prv_process_finish(ebtobj, curr_state, changed_any, mstime);
+}
+
+void ebtn_process_with_curr_state(bit_array_t *curr_state, ebtn_time_t mstime)
+{
+    ebtn_process_with_curr_state_ex(&ebtn_default, curr_state, mstime);
+}
+
+#ifdef EBTN_CONFIG_SHARD
+int ebtn_set_shards_ex(ebtn_t *ebtobj, ebtn_shard_t *shards, int shard_cnt, ebtn_shard_evt_t *evts, uint16_t evts_per_shard)
+{
+    int i;
+
+    if (shard_cnt < 0 || (shard_cnt > 0 && (shards == NULL || evts == NULL || evts_per_shard == 0)))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < shard_cnt; i++)
+    {
+        memset(&shards[i], 0x00, sizeof(shards[i]));
+        shards[i].evts = &evts[i * evts_per_shard];
+        shards[i].evt_size = evts_per_shard;
+    }
+    ebtobj->shards = shards;
+    ebtobj->shard_cnt = shard_cnt;
+
+    return 1;
+}
+
+int ebtn_set_shards(ebtn_shard_t *shards, int shard_cnt, ebtn_shard_evt_t *evts, uint16_t evts_per_shard)
+{
+    return ebtn_set_shards_ex(&ebtn_default, shards, shard_cnt, evts, evts_per_shard);
+}
+
+void ebtn_process_shard_ex(ebtn_t *ebtobj, int shard)
+{
+    ebtn_shard_t *sh = &ebtobj->shards[shard];
+    int begin = shard * ebtobj->shard_keynum;
+    int end = begin + ebtobj->shard_keynum;
+
+    sh->changed_any = 0;
+    if (begin >= ebtobj->key_num)
+    {
+        return;
+    }
+    if (end > ebtobj->key_num)
+    {
+        end = ebtobj->key_num;
+    }
+
+    sh->changed_any = (uint8_t)prv_process_btn_words(ebtobj, ebtobj->shard_curr_state, begin / BIT_ARRAY_BITS, BIT_ARRAY_BITMAP_SIZE(end),
+                                                     ebtobj->shard_time);
+}
+
+void ebtn_process_sharded_ex(ebtn_t *ebtobj, bit_array_t *curr_state, ebtn_time_t mstime, ebtn_shard_run_fn run_fn, void *arg)
+{
+    int changed_any = 0;
+    int keynum;
+    int i, j;
+
+    if (ebtobj->shard_cnt == 0)
+    {
+        ebtn_process_with_curr_state_ex(ebtobj, curr_state, mstime);
+        return;
+    }
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return; /* state storage is not enough. */
+    }
+
+    /* Split buttons into shards of whole cache lines of the state bitmaps */
+    keynum = (ebtobj->key_num + ebtobj->shard_cnt - 1) / ebtobj->shard_cnt;
+    keynum = (keynum + EBTN_SHARD_ALIGN_KEYNUM - 1) / EBTN_SHARD_ALIGN_KEYNUM * EBTN_SHARD_ALIGN_KEYNUM;
+    ebtobj->shard_keynum = keynum > 0 ? keynum : EBTN_SHARD_ALIGN_KEYNUM;
+    ebtobj->shard_curr_state = curr_state;
+    ebtobj->shard_time = mstime;
+    for (i = 0; i < ebtobj->shard_cnt; i++)
+    {
+        ebtobj->shards[i].evt_cnt = 0;
+    }
+
+    ebtobj->shard_active = 1;
+    if (run_fn != NULL)
+    {
+        run_fn(ebtobj, ebtobj->shard_cnt, arg);
+    }
+    else
+    {
+        for (i = 0; i < ebtobj->shard_cnt; i++)
+        {
+            ebtn_process_shard_ex(ebtobj, i);
+        }
+    }
+    ebtobj->shard_active = 0;
+
+    /* Shards in order are buttons in key_idx order, same event order as single thread processing */
+    for (i = 0; i < ebtobj->shard_cnt; i++)
+    {
+        ebtn_shard_t *sh = &ebtobj->shards[i];
+
+        for (j = 0; j < sh->evt_cnt; j++)
+        {
+            prv_shard_deliver(ebtobj, &sh->evts[j]);
+        }
+        changed_any |= sh->changed_any;
+    }
+
+    prv_process_finish(ebtobj, curr_state, changed_any, mstime);
+}
+
+void ebtn_process_sharded(bit_array_t *curr_state, ebtn_time_t mstime, ebtn_shard_run_fn run_fn, void *arg)
+{
+    ebtn_process_sharded_ex(&ebtn_default, curr_state, mstime, run_fn, arg);
+}
+#endif
+
+void ebtn_process_ex(ebtn_t *ebtobj, ebtn_time_t mstime)
+{
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return; /* state storage is not enough. */
+    }
+
+    // Get Current State, edge-fed button group without get_state_fn keeps last fed state
+    if (ebtobj->state_providers != NULL)
+    {
+        ebtn_get_current_state_bulk(ebtobj, ebtobj->curr_state);
+    }
+    else if (ebtobj->get_state_fn != NULL)
+    {
+        ebtn_get_current_state(ebtobj, ebtobj->curr_state);
+    }
+    else
+    {
+        bit_array_copy_all(ebtobj->curr_state, ebtobj->old_state, ebtobj->key_num);
+    }
+
+    ebtn_process_with_curr_state_ex(ebtobj, ebtobj->curr_state, mstime);
+}
+
+/**
+ * \brief           Get time of fed edge or timeout, never earlier than the last one
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Time in ms of the edge or timeout
+ * \return          Time to process with
+ */
+static ebtn_time_t prv_feed_get_time(ebtn_t *ebtobj, ebtn_time_t mstime)
+{
+    if (ebtobj->feed_time_valid && ebtn_timer_sub(mstime, ebtobj->feed_time) < 0)
+    {
+        mstime = ebtobj->feed_time; /* Edge arrived after a later timeout was processed */
+    }
+    ebtobj->feed_time = mstime;
+    ebtobj->feed_time_valid = 1;
+
+    return mstime;
+}
+
+/**
+ * \brief           Process a fed edge or timeout, only the fed button and buttons which need process even input not change.
+ * curr_state of the button group is kept equal to old_state, instead of copied for every edge.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       idx: key_idx of fed button, `-1` for timeout
+ * \param[in]       state: New input state of fed button
+ * \param[in]       mstime: Time in ms of the edge or timeout
+ */
+static void prv_process_fed(ebtn_t *ebtobj, int idx, uint8_t state, ebtn_time_t mstime)
+{
+    bit_array_t *changed = ebtobj->changed;
+    int changed_any = 0;
+    int i;
+
+    if (!ebtobj->curr_state_synced)
+    {
+        bit_array_copy_all(ebtobj->curr_state, ebtobj->old_state, ebtobj->key_num);
+        ebtobj->curr_state_synced = 1;
+    }
+    if (idx >= 0 && bit_array_get(ebtobj->old_state, idx) != state)
+    {
+        bit_array_assign(ebtobj->curr_state, idx, state);
+        bit_array_set(changed, idx);
+        changed_any = 1;
+    }
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_wheel_advance(ebtobj, mstime);
+#endif
+
+    for (i = 0; i < (int)BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num); i++)
+    {
+        bit_array_val_t active = changed[i] | prv_get_pending_mask(ebtobj, i, mstime);
+
+        while (active)
+        {
+            int key_idx = i * BIT_ARRAY_BITS + CTZ(active);
+            active &= active - 1;
+
+            ebtn_process_btn(ebtobj, EBTN_KEY_BTN(ebtobj, key_idx), ebtobj->old_state, ebtobj->curr_state, key_idx, mstime);
+        }
+    }
+
+    prv_process_combos(ebtobj, ebtobj->curr_state, changed_any, mstime);
+
+    if (changed_any)
+    {
+        bit_array_assign(ebtobj->old_state, idx, state);
+        bit_array_clear(changed, idx);
+    }
+}
+
+int ebtn_feed_edge_ex(ebtn_t *ebtobj, uint16_t key_id, uint8_t state, ebtn_time_t mstime)
+{
+    int idx = ebtn_get_btn_index_by_key_id_ex(ebtobj, key_id);
+
+    if (idx < 0 || !prv_storage_is_valid(ebtobj))
+    {
+        return 0;
+    }
+
+    /* Edges read in one batch have no ebtn_feed_time() between them, process timeouts due before this edge */
+    prv_feed_timeouts(ebtobj, mstime);
+    mstime = prv_feed_get_time(ebtobj, mstime);
+    prv_process_fed(ebtobj, idx, state != 0, mstime);
+
+    return 1;
+}
+
+int ebtn_feed_edge(uint16_t key_id, uint8_t state, ebtn_time_t mstime)
+{
+    return ebtn_feed_edge_ex(&ebtn_default, key_id, state, mstime);
+}
+
+void ebtn_feed_time_ex(ebtn_t *ebtobj, ebtn_time_t mstime)
+{
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return; /* state storage is not enough. */
+    }
+
+    mstime = prv_feed_get_time(ebtobj, mstime);
+    prv_process_fed(ebtobj, -1, 0, mstime);
+}
+
+void ebtn_feed_time(ebtn_time_t mstime)
+{
+    ebtn_feed_time_ex(&ebtn_default, mstime);
+}
+
+void ebtn_process(ebtn_time_t mstime)
+{
+    ebtn_process_ex(&ebtn_default, mstime);
+}
+
+int ebtn_get_total_btn_cnt_ex(ebtn_t *ebtobj)
+{
+    return ebtobj->key_num;
+}
+
+int ebtn_get_total_btn_cnt(void)
+{
+    return ebtn_get_total_btn_cnt_ex(&ebtn_default);
+}
+
+int ebtn_get_btn_index_by_key_id_ex(ebtn_t *ebtobj, uint16_t key_id)
+{
+    ebtn_btn_t *btn = prv_key_index_find(ebtobj, key_id);
+
+    if (btn == NULL)
+    {
+        return -1;
+    }
+
+    if (btn >= ebtobj->btns && btn < ebtobj->btns + ebtobj->btns_cnt)
+    {
+        return btn - ebtobj->btns;
+    }
+
+    return ((ebtn_btn_dyn_t *)((char *)btn - offsetof(ebtn_btn_dyn_t, btn)))->key_idx;
+}
+
+int ebtn_get_btn_index_by_key_id(uint16_t key_id)
+{
+    return ebtn_get_btn_index_by_key_id_ex(&ebtn_default, key_id);
+}
+
+ebtn_btn_t *ebtn_get_btn_by_key_id_ex(ebtn_t *ebtobj, uint16_t key_id)
+{
+    return prv_key_index_find(ebtobj, key_id);
 }
 
 ebtn_btn_t *ebtn_get_btn_by_key_id(uint16_t key_id)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    int i = 0;
-    ebtn_btn_dyn_t *target;
+    return ebtn_get_btn_by_key_id_ex(&ebtn_default, key_id);
+}
+
+int ebtn_get_btn_index_by_btn_ex(ebtn_t *ebtobj, ebtn_btn_t *btn)
+{
+    return ebtn_get_btn_index_by_key_id_ex(ebtobj, btn->key_id);
+}
+
+int ebtn_get_btn_index_by_btn(ebtn_btn_t *btn)
+{
+    return ebtn_get_btn_index_by_btn_ex(&ebtn_default, btn);
+}
+
+int ebtn_get_btn_index_by_btn_dyn_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *btn)
+{
+    return ebtn_get_btn_index_by_key_id_ex(ebtobj, btn->btn.key_id);
+}
+
+int ebtn_get_btn_index_by_btn_dyn(ebtn_btn_dyn_t *btn)
+{
+    return ebtn_get_btn_index_by_btn_dyn_ex(&ebtn_default, btn);
+}
+
+void ebtn_combo_btn_add_btn_by_idx_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, int idx)
+{
+    ebtobj->combo_dirty = 1;
+    if (btn->comb_key_ext)
+    {
+        bit_array_set(btn->comb_key_ext, idx);
+    }
+    else if (idx < EBTN_MAX_KEYNUM)
+    {
+        bit_array_set(btn->comb_key, idx);
+    }
+}
+
+void ebtn_combo_btn_add_btn_by_idx(ebtn_btn_combo_t *btn, int idx)
+{
+    ebtn_combo_btn_add_btn_by_idx_ex(&ebtn_default, btn, idx);
+}
+
+void ebtn_combo_btn_remove_btn_by_idx_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, int idx)
+{
+    ebtobj->combo_dirty = 1;
+    if (btn->comb_key_ext)
+    {
+        bit_array_clear(btn->comb_key_ext, idx);
+    }
+    else if (idx < EBTN_MAX_KEYNUM)
+    {
+        bit_array_clear(btn->comb_key, idx);
+    }
+}
+
+void ebtn_combo_btn_remove_btn_by_idx(ebtn_btn_combo_t *btn, int idx)
+{
+    ebtn_combo_btn_remove_btn_by_idx_ex(&ebtn_default, btn, idx);
+}
+
+void ebtn_combo_btn_add_btn_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, uint16_t key_id)
+{
+    int idx = ebtn_get_btn_index_by_key_id_ex(ebtobj, key_id);
+    if (idx < 0)
+    {
+        return;
+    }
+    ebtn_combo_btn_add_btn_by_idx_ex(ebtobj, btn, idx);
+}
+
+void ebtn_combo_btn_add_btn(ebtn_btn_combo_t *btn, uint16_t key_id)
+{
+    ebtn_combo_btn_add_btn_ex(&ebtn_default, btn, key_id);
+}
+
+void ebtn_combo_btn_remove_btn_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, uint16_t key_id)
+{
+    int idx = ebtn_get_btn_index_by_key_id_ex(ebtobj, key_id);
+    if (idx < 0)
+    {
+        return;
+    }
+    ebtn_combo_btn_remove_btn_by_idx_ex(ebtobj, btn, idx);
+}
+
+void ebtn_combo_btn_remove_btn(ebtn_btn_combo_t *btn, uint16_t key_id)
+{
+    ebtn_combo_btn_remove_btn_ex(&ebtn_default, btn, key_id);
+}
+
+int ebtn_is_btn_active(const ebtn_btn_t *btn)
+{
+    return btn != NULL && (btn->flags & EBTN_FLAG_ONPRESS_SENT);
+}
+
+int ebtn_is_btn_in_process(const ebtn_btn_t *btn)
+{
+    return btn != NULL && (btn->flags & EBTN_FLAG_IN_PROCESS);
+}
+
+#ifdef EBTN_CONFIG_STATS
+int ebtn_get_btn_stats(const ebtn_btn_t *btn, ebtn_btn_stats_t *stats)
+{
+    uint16_t seq;
+
+    if (btn == NULL || stats == NULL)
+    {
+        return 0;
+    }
+
+    /* Copy again when an update was in progress or happened during copy */
+    do
+    {
+        seq = EBTN_ATOMIC_LOAD(&btn->stats.seq);
+        memcpy(stats, (const void *)&btn->stats, sizeof(*stats));
+        EBTN_ATOMIC_FENCE();
+    } while ((seq & 1) != 0 || EBTN_ATOMIC_LOAD(&btn->stats.seq) != seq);
+
+    return 1;
+}
+
+void ebtn_reset_btn_stats(ebtn_btn_t *btn)
+{
+    if (btn == NULL)
+    {
+        return;
+    }
+
+    prv_stats_begin(&btn->stats);
+    memset((uint8_t *)&btn->stats + offsetof(ebtn_btn_stats_t, transitions), 0x00, sizeof(btn->stats) - offsetof(ebtn_btn_stats_t, transitions));
+    prv_stats_end(&btn->stats);
+}
+#endif
+
+#ifdef EBTN_CONFIG_GESTURE
+#define EBTN_GESTURE_STATE_START (0)      /* Start of all patterns */
+#define EBTN_GESTURE_STATE_HELD  (1)      /* Pattern matched by keep alive, wait for release */
+#define EBTN_GESTURE_STATE_NONE  (0xFFFF) /* No pattern continues, only while compiling */
+
+/**
+ * \brief           Check state is the end of a pattern with no longer pattern, only while compiling
+ *
+ * \param[in]       table: Transition table
+ * \param[in]       state: State to check
+ * \return          `1` if pattern is matched on entering the state, `0` otherwise
+ */
+static int prv_gesture_is_final(const ebtn_gesture_trans_t *table, int state)
+{
+    const ebtn_gesture_trans_t *trans = &table[state * EBTN_GESTURE_SYM_NUM];
+
+    return trans[EBTN_GESTURE_SYM_END].match != 0 && trans[EBTN_GESTURE_SYM_SHORT].next == EBTN_GESTURE_STATE_NONE &&
+           trans[EBTN_GESTURE_SYM_LONG].next == EBTN_GESTURE_STATE_NONE && trans[EBTN_GESTURE_SYM_HOLD].next == EBTN_GESTURE_STATE_NONE;
+}
+
+int ebtn_gesture_compile(ebtn_gesture_t *gesture, ebtn_gesture_trans_t *table, uint16_t max_states, const char *const *patterns, int pattern_cnt)
+{
+    ebtn_gesture_trans_t *trans;
+    const char *c;
+    int state_cnt = 2;
+    int state, next, sym, i;
+
+    if (gesture == NULL || table == NULL || patterns == NULL || max_states < 2 || pattern_cnt <= 0 || pattern_cnt >= 0xFFFF)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < EBTN_GESTURE_TABLE_SIZE(2); i++)
+    {
+        table[i].next = EBTN_GESTURE_STATE_NONE;
+        table[i].match = 0;
+    }
+
+    /* Tree of patterns from the start state */
+    for (i = 0; i < pattern_cnt; i++)
+    {
+        if (patterns[i] == NULL || patterns[i][0] == '\0')
+        {
+            return 0;
+        }
+
+        state = EBTN_GESTURE_STATE_START;
+        for (c = patterns[i]; *c != '\0'; c++)
+        {
+            switch (*c)
+            {
+                case '.':
+                    sym = EBTN_GESTURE_SYM_SHORT;
+                    break;
+                case '-':
+                    sym = EBTN_GESTURE_SYM_LONG;
+                    break;
+                case '_':
+                    sym = EBTN_GESTURE_SYM_HOLD;
+                    break;
+                default:
+                    return 0;
+            }
+
+            trans = &table[state * EBTN_GESTURE_SYM_NUM];
+            if (trans[sym].next == EBTN_GESTURE_STATE_NONE)
+            {
+                if (state_cnt >= max_states)
+                {
+                    return 0;
+                }
+                for (next = 0; next < EBTN_GESTURE_SYM_NUM; next++)
+                {
+                    table[state_cnt * EBTN_GESTURE_SYM_NUM + next].next = EBTN_GESTURE_STATE_NONE;
+                    table[state_cnt * EBTN_GESTURE_SYM_NUM + next].match = 0;
+                }
+                table[state_cnt * EBTN_GESTURE_SYM_NUM + EBTN_GESTURE_SYM_END].next = (uint16_t)sym; /* Incoming symbol, only while compiling */
+                trans[sym].next = (uint16_t)state_cnt++;
+            }
+            state = trans[sym].next;
+        }
+
+        /* End of sequence reports pattern of the state */
+        if (table[state * EBTN_GESTURE_SYM_NUM + EBTN_GESTURE_SYM_END].match != 0)
+        {
+            return 0;
+        }
+        table[state * EBTN_GESTURE_SYM_NUM + EBTN_GESTURE_SYM_END].match = (uint16_t)(i + 1);
+    }
+
+    /*
+     * Resolve all transitions, states in creation order, children are resolved after parent.
+     * Final state is never entered, its pattern is reported by the transition to it.
+     */
+    for (state = 0; state < state_cnt; state++)
+    {
+        trans = &table[state * EBTN_GESTURE_SYM_NUM];
+        if (state == EBTN_GESTURE_STATE_HELD)
+        {
+            trans[EBTN_GESTURE_SYM_SHORT] = table[EBTN_GESTURE_SYM_SHORT];
+            trans[EBTN_GESTURE_SYM_LONG].next = EBTN_GESTURE_STATE_START;
+            trans[EBTN_GESTURE_SYM_HOLD].next = EBTN_GESTURE_STATE_HELD;
+            trans[EBTN_GESTURE_SYM_END].next = EBTN_GESTURE_STATE_START;
+            continue;
+        }
+
+        for (sym = EBTN_GESTURE_SYM_SHORT; sym < EBTN_GESTURE_SYM_END; sym++)
+        {
+            next = trans[sym].next;
+            if (next != EBTN_GESTURE_STATE_NONE)
+            {
+                if (prv_gesture_is_final(table, next))
+                {
+                    trans[sym].match = table[next * EBTN_GESTURE_SYM_NUM + EBTN_GESTURE_SYM_END].match;
+                    trans[sym].next = sym == EBTN_GESTURE_SYM_HOLD ? EBTN_GESTURE_STATE_HELD : EBTN_GESTURE_STATE_START;
+                }
+            }
+            else if (sym == EBTN_GESTURE_SYM_HOLD)
+            {
+                trans[sym].next = (uint16_t)state; /* Holding longer than pattern */
+            }
+            else if (state == EBTN_GESTURE_STATE_START)
+            {
+                trans[sym].next = EBTN_GESTURE_STATE_START;
+            }
+            else if (sym == EBTN_GESTURE_SYM_LONG && trans[EBTN_GESTURE_SYM_END].match != 0 && trans[EBTN_GESTURE_SYM_END].next == EBTN_GESTURE_SYM_HOLD)
+            {
+                trans[sym].next = (uint16_t)state; /* Release of the hold, pattern of the state still waits */
+            }
+            else if (trans[EBTN_GESTURE_SYM_END].match != 0)
+            {
+                /* Symbol ends the pattern of the state, then start again with it */
+                trans[sym].next = table[sym].next;
+                trans[sym].match = trans[EBTN_GESTURE_SYM_END].match;
+            }
+            else
+            {
+                trans[sym] = table[sym]; /* Start again with this symbol */
+            }
+        }
+        trans[EBTN_GESTURE_SYM_END].next = EBTN_GESTURE_STATE_START;
+    }
+
+    gesture->table = table;
+    gesture->state_size = max_states;
+    gesture->state_cnt = (uint16_t)state_cnt;
+
+    return 1;
+}
+
+int ebtn_gesture_feed(const ebtn_gesture_t *gesture, ebtn_btn_t *btn, ebtn_evt_t evt)
+{
+    const ebtn_gesture_trans_t *trans;
+    int sym;
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+    int step;
+#endif
+
+    switch (evt)
+    {
+        case EBTN_EVT_ONRELEASE:
+            sym = btn->keepalive_cnt > 0 ? EBTN_GESTURE_SYM_LONG : EBTN_GESTURE_SYM_SHORT;
+            break;
+        case EBTN_EVT_KEEPALIVE:
+            sym = EBTN_GESTURE_SYM_HOLD;
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+            /* One hold of every coalesced period, first match is reported */
+            for (step = 1; step < btn->keepalive_step; step++)
+            {
+                trans = &gesture->table[btn->gesture_state * EBTN_GESTURE_SYM_NUM + sym];
+                btn->gesture_state = trans->next;
+                if (trans->match != 0)
+                {
+                    return (int)trans->match - 1;
+                }
+            }
+#endif
+            break;
+        case EBTN_EVT_ONPRESS:
+            /* No on-click after long press, sequence ends when next press comes after idle */
+            if (!(btn->flags & EBTN_FLAG_SEQ_START))
+            {
+                return -1;
+            }
+            sym = EBTN_GESTURE_SYM_END;
+            break;
+        case EBTN_EVT_ONCLICK:
+            /* On-click of multi click ended by long press is sent while pressed, not the end */
+            if (ebtn_is_btn_active(btn))
+            {
+                return -1;
+            }
+            sym = EBTN_GESTURE_SYM_END;
+            break;
+        default:
+            return -1;
+    }
+
+    trans = &gesture->table[btn->gesture_state * EBTN_GESTURE_SYM_NUM + sym];
+    btn->gesture_state = trans->next;
+
+    return (int)trans->match - 1;
+}
+
+void ebtn_gesture_reset(ebtn_btn_t *btn)
+{
+    if (btn != NULL)
+    {
+        btn->gesture_state = EBTN_GESTURE_STATE_START;
+    }
+}
+#endif
+
+int ebtn_is_in_process_ex(ebtn_t *ebtobj)
+{
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return 0; /* state storage is not enough. */
+    }
+
+    return bit_array_is_any_set(ebtobj->in_process, ebtobj->key_num) || ebtobj->combo_in_process_cnt > 0;
+}
+
+int ebtn_is_in_process(void)
+{
+    return ebtn_is_in_process_ex(&ebtn_default);
+}
 
-    for (i = 0; i < ebtobj->btns_cnt; ++i)
+/**
+ * \brief           Update the earliest deadline with the button deadline
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button instance
+ * \param[in]       slot: Button internal key_idx, `-1` for combo-button
+ * \param[in]       state: Button state of last process
+ * \param[in]       mstime: Current milliseconds system time
+ * \param[in,out]   deadline: Earliest deadline so far
+ * \param[in,out]   valid: `1` if deadline is valid
+ */
+static void prv_update_deadline(ebtn_t *ebtobj, const ebtn_btn_t *btn, int slot, uint8_t state, ebtn_time_t mstime, ebtn_time_t *deadline, int *valid)
+{
+    ebtn_time_t next = 0;
+
+    if (!prv_get_btn_deadline(ebtobj, btn, slot, state, &next))
     {
-        if (ebtobj->btns[i].key_id == key_id)
+        return;
+    }
+
+    /* Already due, process it now */
+    if ((ebtn_time_t)(next - mstime) > (MAX_TIME_VALUE >> 1))
+    {
+        next = mstime;
+    }
+
+    if (!*valid || (ebtn_time_t)(next - mstime) < (ebtn_time_t)(*deadline - mstime))
+    {
+        *deadline = next;
+    }
+    *valid = 1;
+}
+
+int ebtn_get_next_deadline_ex(ebtn_t *ebtobj, ebtn_time_t mstime, ebtn_time_t *deadline)
+{
+    ebtn_btn_combo_dyn_t *target_combo;
+    bit_array_t *comb_key;
+    int valid = 0;
+    int num_bits;
+    int i;
+
+    if (!prv_storage_is_valid(ebtobj))
+    {
+        return 0; /* state storage is not enough. */
+    }
+
+    /* Only buttons in process have timer running */
+    for (i = 0; i < (int)BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num); i++)
+    {
+        bit_array_val_t active = ebtobj->in_process[i];
+
+        while (active)
         {
-            return &ebtobj->btns[i];
+            int idx = i * BIT_ARRAY_BITS + CTZ(active);
+            active &= active - 1;
+
+            prv_update_deadline(ebtobj, EBTN_KEY_BTN(ebtobj, idx), idx, bit_array_get(ebtobj->old_state, idx), mstime, deadline, &valid);
         }
     }
 
-    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    if (ebtobj->combo_in_process_cnt)
     {
-        if (target->btn.key_id == key_id)
+        for (i = 0; i < ebtobj->btns_combo_cnt; ++i)
         {
-            return &target->btn;
+            if (ebtn_is_btn_in_process(&ebtobj->btns_combo[i].btn))
+            {
+                comb_key = prv_combo_get_key(ebtobj, &ebtobj->btns_combo[i], &num_bits);
+                prv_update_deadline(ebtobj, &ebtobj->btns_combo[i].btn, -1, prv_combo_get_state(ebtobj->old_state, comb_key, num_bits), mstime, deadline, &valid);
+            }
+        }
+
+        for (target_combo = ebtobj->btn_combo_dyn_head; target_combo; target_combo = target_combo->next)
+        {
+            if (ebtn_is_btn_in_process(&target_combo->btn.btn))
+            {
+                comb_key = prv_combo_get_key(ebtobj, &target_combo->btn, &num_bits);
+                prv_update_deadline(ebtobj, &target_combo->btn.btn, -1, prv_combo_get_state(ebtobj->old_state, comb_key, num_bits), mstime, deadline, &valid);
+            }
         }
     }
 
-    return NULL;
+    return valid;
 }
 
-int ebtn_get_btn_index_by_btn(ebtn_btn_t *btn)
+int ebtn_get_next_deadline(ebtn_time_t mstime, ebtn_time_t *deadline)
 {
-    return ebtn_get_btn_index_by_key_id(btn->key_id);
+    return ebtn_get_next_deadline_ex(&ebtn_default, mstime, deadline);
 }
 
-int ebtn_get_btn_index_by_btn_dyn(ebtn_btn_dyn_t *btn)
+/**
+ * \brief           Check room of dynamic buttons
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       cnt: Number of dynamic buttons to add
+ * \return          `1` if all buttons fit in storage, `0` otherwise
+ */
+static int prv_btn_dyn_has_room(ebtn_t *ebtobj, int cnt)
 {
-    return ebtn_get_btn_index_by_key_id(btn->btn.key_id);
+    if (ebtobj->key_num + cnt > ebtobj->key_capacity)
+    {
+        return 0;
+    }
+#ifdef EBTN_CONFIG_SOA
+    if (ebtobj->key_num + cnt > ebtobj->soa_capacity)
+    {
+        return 0;
+    }
+#endif
+    return 1;
 }
 
-void ebtn_combo_btn_add_btn_by_idx(ebtn_btn_combo_t *btn, int idx)
+/**
+ * \brief           Check dynamic button is linked to the list of the button group.
+ * Generation of a button copied from a registered one, or of a stale button, may equal the generation of the group.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic button
+ * \return          `1` if linked, `0` otherwise
+ */
+static int prv_btn_dyn_is_linked(ebtn_t *ebtobj, const ebtn_btn_dyn_t *button)
 {
-    bit_array_set(btn->comb_key, idx);
+    ebtn_btn_dyn_t *target;
+
+    if (button->group_gen != ebtobj->group_gen)
+    {
+        return 0;
+    }
+    for (target = ebtobj->btn_dyn_head; target; target = target->next)
+    {
+        if (target == button)
+        {
+            return 1;
+        }
+    }
+    return 0;
 }
 
-void ebtn_combo_btn_remove_btn_by_idx(ebtn_btn_combo_t *btn, int idx)
+/**
+ * \brief           Check dynamic combo-button is linked to the list of the button group
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic combo-button
+ * \return          `1` if linked, `0` otherwise
+ */
+static int prv_combo_dyn_is_linked(ebtn_t *ebtobj, const ebtn_btn_combo_dyn_t *button)
 {
-    bit_array_clear(btn->comb_key, idx);
+    ebtn_btn_combo_dyn_t *target;
+
+    if (button->group_gen != ebtobj->group_gen)
+    {
+        return 0;
+    }
+    for (target = ebtobj->btn_combo_dyn_head; target; target = target->next)
+    {
+        if (target == button)
+        {
+            return 1;
+        }
+    }
+    return 0;
 }
 
-void ebtn_combo_btn_add_btn(ebtn_btn_combo_t *btn, uint16_t key_id)
+/**
+ * \brief           Check buttons to remove are linked at their key_idx, key_idx of buttons are set to `-1` on success.
+ * A stale or copied button may carry key_idx of another linked button.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       buttons: Buttons to remove, key_idx checked in range
+ * \param[in]       cnt: Number of buttons
+ * \param[in]       removed: Removed key_idx
+ * \return          `1` if all buttons are linked, `0` otherwise
+ */
+static int prv_btn_dyn_check_removed(ebtn_t *ebtobj, ebtn_btn_dyn_t *const *buttons, int cnt, const bit_array_t *removed)
 {
-    int idx = ebtn_get_btn_index_by_key_id(key_id);
-    if (idx < 0)
+    ebtn_btn_dyn_t *target;
+    int i;
+
+    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
     {
-        return;
+        if (bit_array_get(removed, i))
+        {
+            target->key_idx = -1;
+        }
     }
-    ebtn_combo_btn_add_btn_by_idx(btn, idx);
+
+    for (i = 0; i < cnt; i++)
+    {
+        if (buttons[i]->key_idx != -1)
+        {
+            break;
+        }
+    }
+    if (i == cnt)
+    {
+        return 1;
+    }
+
+    /* Restore key_idx of linked buttons */
+    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    {
+        target->key_idx = i;
+    }
+    return 0;
 }
 
-void ebtn_combo_btn_remove_btn(ebtn_btn_combo_t *btn, uint16_t key_id)
+/**
+ * \brief           Append dynamic button to the tail of list, with next key_idx
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic button, not registered
+ */
+static void prv_btn_dyn_append(ebtn_t *ebtobj, ebtn_btn_dyn_t *button)
 {
-    int idx = ebtn_get_btn_index_by_key_id(key_id);
-    if (idx < 0)
+    button->next = NULL;
+    if (ebtobj->btn_dyn_tail == NULL)
     {
-        return;
+        ebtobj->btn_dyn_head = button;
     }
-    ebtn_combo_btn_remove_btn_by_idx(btn, idx);
+    else
+    {
+        ebtobj->btn_dyn_tail->next = button;
+    }
+    ebtobj->btn_dyn_tail = button;
+    button->group_gen = ebtobj->group_gen;
+
+    button->key_idx = ebtobj->key_num;
+#ifdef EBTN_CONFIG_KEY_INDEX
+    prv_key_index_insert(ebtobj, &button->btn);
+#endif
+#ifdef EBTN_CONFIG_SOA
+    prv_soa_load(ebtobj, &button->btn, ebtobj->key_num);
+#else
+    ebtobj->btn_table[ebtobj->key_num] = &button->btn;
+#endif
+    bit_array_assign(ebtobj->in_process, ebtobj->key_num, ebtn_is_btn_in_process(&button->btn));
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_reset(ebtobj, &button->btn, ebtobj->key_num);
+#endif
+    ebtobj->key_num++;
+    ebtobj->combo_dirty = 1;
 }
 
-int ebtn_is_btn_active(const ebtn_btn_t *btn)
+/**
+ * \brief           Remove bits of removed key_idx, following bits move down
+ *
+ * \param[in]       bits: Bitmap to compact
+ * \param[in]       removed: Removed key_idx
+ * \param[in]       first: First removed key_idx, bits before it not changed
+ * \param[in]       num: Number of bits of bitmap
+ */
+static void prv_bitmap_compact(bit_array_t *bits, const bit_array_t *removed, int first, int num)
 {
-    return btn != NULL && (btn->flags & EBTN_FLAG_ONPRESS_SENT);
+    int i, w;
+
+    for (i = first, w = first; i < num; i++)
+    {
+        if (!bit_array_get(removed, i))
+        {
+            bit_array_assign(bits, w++, bit_array_get(bits, i));
+        }
+    }
+    for (; w < num; w++)
+    {
+        bit_array_clear(bits, w);
+    }
 }
 
-int ebtn_is_btn_in_process(const ebtn_btn_t *btn)
+#ifdef EBTN_CONFIG_SOA
+/**
+ * \brief           Move button state of structure-of-arrays to a lower key_idx
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       from: Current key_idx
+ * \param[in]       to: New key_idx
+ */
+static void prv_soa_move(ebtn_t *ebtobj, int from, int to)
 {
-    return btn != NULL && (btn->flags & EBTN_FLAG_IN_PROCESS);
+    ebtobj->soa.btn[to] = ebtobj->soa.btn[from];
+    ebtobj->soa.time_change[to] = ebtobj->soa.time_change[from];
+    ebtobj->soa.time_state_change[to] = ebtobj->soa.time_state_change[from];
+    ebtobj->soa.keepalive_last_time[to] = ebtobj->soa.keepalive_last_time[from];
+    ebtobj->soa.click_last_time[to] = ebtobj->soa.click_last_time[from];
+    ebtobj->soa.click_cnt[to] = ebtobj->soa.click_cnt[from];
+    ebtobj->soa.flags[to] = ebtobj->soa.flags[from];
+    ebtobj->soa.param_idx[to] = ebtobj->soa.param_idx[from];
+#ifdef EBTN_CONFIG_SIMD
+    ebtobj->soa.deadline[to] = ebtobj->soa.deadline[from];
+#endif
 }
+#endif
 
-int ebtn_is_in_process(void)
+int ebtn_register_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *button)
+{
+    if (!button)
+    {
+        return 0;
+    }
+
+    if (!prv_btn_dyn_has_room(ebtobj, 1))
+    {
+        return 0; /* reach max cnt. */
+    }
+
+    if (prv_btn_dyn_is_linked(ebtobj, button))
+    {
+        return 0; /* already exist. */
+    }
+
+    prv_btn_dyn_append(ebtobj, button);
+
+    return 1;
+}
+
+int ebtn_register(ebtn_btn_dyn_t *button)
+{
+    return ebtn_register_ex(&ebtn_default, button);
+}
+
+int ebtn_register_bulk_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *buttons, int cnt)
 {
-    ebtn_t *ebtobj = &ebtn_default;
-    ebtn_btn_dyn_t *target;
-    ebtn_btn_combo_dyn_t *target_combo;
     int i;
 
-    /* Process all buttons */
-    for (i = 0; i < ebtobj->btns_cnt; ++i)
+    if (buttons == NULL || cnt <= 0 || !prv_btn_dyn_has_room(ebtobj, cnt))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < cnt; i++)
     {
-        if (ebtn_is_btn_in_process(&ebtobj->btns[i]))
+        if (prv_btn_dyn_is_linked(ebtobj, &buttons[i]))
         {
-            return 1;
+            return 0; /* already exist. */
         }
     }
 
-    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt; target; target = target->next, i++)
+    for (i = 0; i < cnt; i++)
+    {
+        prv_btn_dyn_append(ebtobj, &buttons[i]);
+    }
+
+    return 1;
+}
+
+int ebtn_register_bulk(ebtn_btn_dyn_t *buttons, int cnt)
+{
+    return ebtn_register_bulk_ex(&ebtn_default, buttons, cnt);
+}
+
+int ebtn_unregister_bulk_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *const *buttons, int cnt)
+{
+    bit_array_t *removed = ebtobj->changed; /* Only used in process, removed key_idx in between */
+    ebtn_btn_dyn_t *target, *next, *prev = NULL;
+    ebtn_btn_combo_dyn_t *target_combo;
+    bit_array_t *comb_key;
+    int first = ebtobj->key_num;
+    int num_bits;
+    int i, w;
+
+    if (buttons == NULL || cnt <= 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < cnt; i++)
     {
-        if (ebtn_is_btn_in_process(&target->btn))
+        if (buttons[i] == NULL || buttons[i]->group_gen != ebtobj->group_gen || buttons[i]->key_idx < ebtobj->btns_cnt ||
+            buttons[i]->key_idx >= ebtobj->key_num)
         {
-            return 1;
+            return 0; /* not exist. */
         }
     }
 
-    /* Process all comb buttons */
-    for (i = 0; i < ebtobj->btns_combo_cnt; ++i)
+    memset(removed, 0x00, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num) * sizeof(bit_array_t));
+    for (i = 0; i < cnt; i++)
     {
-        if (ebtn_is_btn_in_process(&ebtobj->btns_combo[i].btn))
+        bit_array_set(removed, buttons[i]->key_idx);
+        if (buttons[i]->key_idx < first)
         {
-            return 1;
+            first = buttons[i]->key_idx;
         }
     }
+    if (!prv_btn_dyn_check_removed(ebtobj, buttons, cnt, removed))
+    {
+        memset(removed, 0x00, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num) * sizeof(bit_array_t));
+        return 0; /* not exist. */
+    }
 
-    for (target_combo = ebtobj->btn_combo_dyn_head; target_combo; target_combo = target_combo->next)
+    /* Unlink removed buttons, kept buttons move down to keep key_idx compact */
+    for (target = ebtobj->btn_dyn_head, i = ebtobj->btns_cnt, w = ebtobj->btns_cnt; target; target = next, i++)
     {
-        if (ebtn_is_btn_in_process(&target_combo->btn.btn))
+        next = target->next;
+        if (bit_array_get(removed, i))
         {
-            return 1;
+#ifdef EBTN_CONFIG_SOA
+            prv_soa_store(ebtobj, i);
+#endif
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+            prv_timer_wheel_remove(&ebtobj->timer_wheel, &target->btn.timer);
+#endif
+            if (prev == NULL)
+            {
+                ebtobj->btn_dyn_head = next;
+            }
+            else
+            {
+                prev->next = next;
+            }
+            target->next = NULL;
+            target->key_idx = -1;
+            target->group_gen = 0;
+            continue;
+        }
+
+        if (w != i)
+        {
+            target->key_idx = w;
+#ifdef EBTN_CONFIG_SOA
+            prv_soa_move(ebtobj, i, w);
+#else
+            ebtobj->btn_table[w] = ebtobj->btn_table[i];
+#endif
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+            target->btn.timer.key_idx = w;
+#endif
         }
+        prev = target;
+        w++;
     }
+    ebtobj->btn_dyn_tail = prev;
 
-    return 0;
+    prv_bitmap_compact(ebtobj->old_state, removed, first, ebtobj->key_num);
+    prv_bitmap_compact(ebtobj->in_process, removed, first, ebtobj->key_num);
+    prv_bitmap_compact(ebtobj->curr_state, removed, first, ebtobj->key_num);
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_bitmap_compact(ebtobj->timer_due, removed, first, ebtobj->key_num);
+#endif
+
+    /* Keys of combo-buttons follow the key_idx, removed keys are unbound */
+    for (i = 0; i < ebtobj->btns_combo_cnt; i++)
+    {
+        comb_key = prv_combo_get_key(ebtobj, &ebtobj->btns_combo[i], &num_bits);
+        prv_bitmap_compact(comb_key, removed, first, num_bits);
+    }
+    for (target_combo = ebtobj->btn_combo_dyn_head; target_combo; target_combo = target_combo->next)
+    {
+        comb_key = prv_combo_get_key(ebtobj, &target_combo->btn, &num_bits);
+        prv_bitmap_compact(comb_key, removed, first, num_bits);
+    }
+
+    memset(removed, 0x00, BIT_ARRAY_BITMAP_SIZE(ebtobj->key_num) * sizeof(bit_array_t));
+    ebtobj->key_num = w;
+#ifdef EBTN_CONFIG_KEY_INDEX
+    prv_key_index_build(ebtobj);
+#endif
+    ebtobj->combo_dirty = 1;
+
+    return 1;
 }
 
-int ebtn_register(ebtn_btn_dyn_t *button)
+int ebtn_unregister_bulk(ebtn_btn_dyn_t *const *buttons, int cnt)
+{
+    return ebtn_unregister_bulk_ex(&ebtn_default, buttons, cnt);
+}
+
+int ebtn_unregister_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *button)
 {
-    ebtn_t *ebtobj = &ebtn_default;
+    return ebtn_unregister_bulk_ex(ebtobj, &button, 1);
+}
 
-    ebtn_btn_dyn_t *curr = ebtobj->btn_dyn_head;
-    ebtn_btn_dyn_t *last = NULL;
+int ebtn_unregister(ebtn_btn_dyn_t *button)
+{
+    return ebtn_unregister_ex(&ebtn_default, button);
+}
 
+int ebtn_combo_register_ex(ebtn_t *ebtobj, ebtn_btn_combo_dyn_t *button)
+{
     if (!button)
     {
         return 0;
     }
 
-    if (ebtn_get_total_btn_cnt() >= EBTN_MAX_KEYNUM)
+    if (prv_combo_dyn_is_linked(ebtobj, button))
     {
-        return 0; /* reach max cnt. */
+        return 0; /* already exist. */
     }
 
-    if (curr == NULL)
+    button->next = NULL;
+    if (ebtobj->btn_combo_dyn_tail == NULL)
     {
-        ebtobj->btn_dyn_head = button;
-        return 1;
+        ebtobj->btn_combo_dyn_head = button;
     }
-
-    while (curr)
+    else
     {
-        if (curr == button)
-        {
-            return 0; /* already exist. */
-        }
-        last = curr;
-        curr = curr->next;
+        ebtobj->btn_combo_dyn_tail->next = button;
     }
-
-    last->next = button;
+    ebtobj->btn_combo_dyn_tail = button;
+    button->group_gen = ebtobj->group_gen;
+
+    ebtobj->combo_in_process_cnt += ebtn_is_btn_in_process(&button->btn.btn);
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_reset(ebtobj, &button->btn.btn, -1);
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    ebtobj->combo_num++;
+#endif
+    ebtobj->combo_dirty = 1;
 
     return 1;
 }
 
 int ebtn_combo_register(ebtn_btn_combo_dyn_t *button)
 {
-    ebtn_t *ebtobj = &ebtn_default;
+    return ebtn_combo_register_ex(&ebtn_default, button);
+}
 
+int ebtn_combo_unregister_ex(ebtn_t *ebtobj, ebtn_btn_combo_dyn_t *button)
+{
     ebtn_btn_combo_dyn_t *curr = ebtobj->btn_combo_dyn_head;
     ebtn_btn_combo_dyn_t *last = NULL;
 
-    if (!button)
+    if (!button || button->group_gen != ebtobj->group_gen)
     {
-        return 0;
+        return 0; /* not exist. */
     }
 
+    while (curr != NULL && curr != button)
+    {
+        last = curr;
+        curr = curr->next;
+    }
     if (curr == NULL)
     {
-        ebtobj->btn_combo_dyn_head = button;
-        return 1;
+        return 0; /* not exist. */
     }
 
-    while (curr)
+    if (last == NULL)
     {
-        if (curr == button)
-        {
-            return 0; /* already exist. */
-        }
-        last = curr;
-        curr = curr->next;
+        ebtobj->btn_combo_dyn_head = button->next;
+    }
+    else
+    {
+        last->next = button->next;
+    }
+    if (ebtobj->btn_combo_dyn_tail == button)
+    {
+        ebtobj->btn_combo_dyn_tail = last;
     }
+    button->next = NULL;
+    button->group_gen = 0;
 
-    last->next = button;
+    ebtobj->combo_in_process_cnt -= ebtn_is_btn_in_process(&button->btn.btn);
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    prv_timer_wheel_remove(&ebtobj->timer_wheel, &button->btn.btn.timer);
+    if (button->btn.btn.flags & EBTN_FLAG_TIMER_DUE)
+    {
+        button->btn.btn.flags &= ~EBTN_FLAG_TIMER_DUE;
+        ebtobj->combo_due_cnt--;
+    }
+#endif
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    ebtobj->combo_num--;
+#endif
+    ebtobj->combo_dirty = 1;
 
     return 1;
 }
+
+int ebtn_combo_unregister(ebtn_btn_combo_dyn_t *button)
+{
+    return ebtn_combo_unregister_ex(&ebtn_default, button);
+}
@@ -23,11 +23,227 @@ typedef int32_t ebtn_time_sign_t;
 #define MAX_TIME_VALUE (0xffffffff)
 #endif
 
+// #define EBTN_CONFIG_TIMER_WHEEL
+
+// Use hierarchical timer wheel to schedule button timeout, only buttons whose timer expired are processed,
+// instead of checking all buttons in process on every process.
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+#ifndef EBTN_TIMER_WHEEL_SLOT_BITS
+#define EBTN_TIMER_WHEEL_SLOT_BITS (6) /*!< Slots of each level is `1 << EBTN_TIMER_WHEEL_SLOT_BITS`, max is 6 */
+#endif
+#ifndef EBTN_TIMER_WHEEL_LEVELS
+#define EBTN_TIMER_WHEEL_LEVELS (3) /*!< Number of wheel levels, must cover max timeout of ebtn_btn_param_t */
+#endif
+#define EBTN_TIMER_WHEEL_SLOTS (1 << EBTN_TIMER_WHEEL_SLOT_BITS)
+
+#if EBTN_TIMER_WHEEL_SLOT_BITS > 6
+#error "EBTN_TIMER_WHEEL_SLOT_BITS must not be larger than 6"
+#endif
+#if (EBTN_TIMER_WHEEL_SLOT_BITS * EBTN_TIMER_WHEEL_LEVELS) < 17
+#error "EBTN_TIMER_WHEEL_SLOT_BITS * EBTN_TIMER_WHEEL_LEVELS must cover 17 bits timeout"
+#endif
+#endif
+
+// #define EBTN_CONFIG_SOA
+
+// Keep hot state of buttons in structure-of-arrays of the button group, indexed by key_idx, params are referenced by index
+// of a shared param table. Processing streams through these arrays instead of dereferencing every button.
+// In this mode time fields of ebtn_btn_t are not updated, flags and click_cnt are synced before every event.
+// Param of button is bound when registered.
+#ifdef EBTN_CONFIG_SOA
+#ifndef EBTN_SOA_PARAM_NUM
+#define EBTN_SOA_PARAM_NUM (8) /*!< Number of different params of the shared param table */
+#endif
+#define EBTN_SOA_PARAM_NONE (0xFF) /*!< Param not in the shared param table, use param of button */
+#endif
+
+// #define EBTN_CONFIG_SIMD
+
+// Check timeout of buttons in process in bulk by SIMD kernel (SSE2/AVX2/NEON with runtime dispatch, scalar fallback),
+// only buttons whose next deadline is reached go through the event path. Needs EBTN_CONFIG_SOA, not used with EBTN_CONFIG_TIMER_WHEEL.
+#if defined(EBTN_CONFIG_SIMD) && !defined(EBTN_CONFIG_SOA)
+#error "EBTN_CONFIG_SIMD needs EBTN_CONFIG_SOA"
+#endif
+
+// #define EBTN_CONFIG_EVT_RING
+
+// Button group initialized without evt_fn puts events into a ring of compact records instead of calling evt_fn,
+// records are fetched in bulk by ebtn_events_drain_ex(). Process and drain must run in the same context or be locked by caller.
+#ifdef EBTN_CONFIG_EVT_RING
+#ifndef EBTN_EVT_RING_SIZE
+#define EBTN_EVT_RING_SIZE (32) /*!< Number of records of the built-in event ring, must be power of 2 */
+#endif
+#if (EBTN_EVT_RING_SIZE & (EBTN_EVT_RING_SIZE - 1)) != 0
+#error "EBTN_EVT_RING_SIZE must be power of 2"
+#endif
+#endif
+
+// #define EBTN_CONFIG_STATS
+
+// Keep runtime statistics of every button: raw transitions, rejected bounces, sent events by type, and log2 histograms
+// of press duration and inter-click gap. Read by ebtn_get_btn_stats() from any context while processing runs.
+#ifdef EBTN_CONFIG_STATS
+#ifndef EBTN_STATS_HIST_NUM
+#define EBTN_STATS_HIST_NUM (16) /*!< Number of histogram buckets, bucket `i` counts `[2^(i-1), 2^i)` ms, last bucket counts all longer */
+#endif
+#endif
+
+// #define EBTN_CONFIG_NO_KEEPALIVE
+
+// Remove keep alive handling from processing, EBTN_EVT_KEEPALIVE is never sent and time_keepalive_period is ignored.
+
+// #define EBTN_CONFIG_KEEPALIVE_COALESCE
+
+// Send one EBTN_EVT_KEEPALIVE for all keep alive periods elapsed since last process instead of one per period, when
+// processing is called late. keepalive_cnt advances by all periods, keepalive_step of button is the number of periods.
+
+// #define EBTN_CONFIG_NO_MULTICLICK
+
+// Remove multi-click handling from processing, every valid click sends EBTN_EVT_ONCLICK with click_cnt `1` right after
+// on-release, time_click_multi_max and max_consecutive are ignored.
+
+// #define EBTN_CONFIG_FIXED_PARAMS
+
+// All buttons and combo-buttons use the compile-time params below instead of their param and event_mask,
+// processing works with constants instead of loading them, and param of button can be `NULL`.
+#ifdef EBTN_CONFIG_FIXED_PARAMS
+#ifndef EBTN_FIXED_TIME_DEBOUNCE
+#define EBTN_FIXED_TIME_DEBOUNCE (20) /*!< time_debounce of all buttons */
+#endif
+#ifndef EBTN_FIXED_TIME_DEBOUNCE_RELEASE
+#define EBTN_FIXED_TIME_DEBOUNCE_RELEASE (0) /*!< time_debounce_release of all buttons */
+#endif
+#ifndef EBTN_FIXED_TIME_CLICK_PRESSED_MIN
+#define EBTN_FIXED_TIME_CLICK_PRESSED_MIN (20) /*!< time_click_pressed_min of all buttons */
+#endif
+#ifndef EBTN_FIXED_TIME_CLICK_PRESSED_MAX
+#define EBTN_FIXED_TIME_CLICK_PRESSED_MAX (300) /*!< time_click_pressed_max of all buttons */
+#endif
+#ifndef EBTN_FIXED_TIME_CLICK_MULTI_MAX
+#define EBTN_FIXED_TIME_CLICK_MULTI_MAX (200) /*!< time_click_multi_max of all buttons */
+#endif
+#ifndef EBTN_FIXED_TIME_KEEPALIVE_PERIOD
+#define EBTN_FIXED_TIME_KEEPALIVE_PERIOD (500) /*!< time_keepalive_period of all buttons */
+#endif
+#ifndef EBTN_FIXED_MAX_CONSECUTIVE
+#define EBTN_FIXED_MAX_CONSECUTIVE (10) /*!< max_consecutive of all buttons */
+#endif
+#ifndef EBTN_FIXED_EVT_MASK
+#define EBTN_FIXED_EVT_MASK (EBTN_EVT_MASK_ALL) /*!< event_mask of all buttons */
+#endif
+#endif
+
+// #define EBTN_CONFIG_SHARD
+
+// Split buttons of a button group into key_idx ranges (shards) processed in parallel by a caller worker pool, see
+// ebtn_process_sharded_ex(). Combo-buttons are processed after all shards and events are delivered in key_idx order,
+// same as single thread processing. Not used with EBTN_CONFIG_TIMER_WHEEL.
+#ifdef EBTN_CONFIG_SHARD
+#ifndef EBTN_SHARD_ALIGN_KEYNUM
+#define EBTN_SHARD_ALIGN_KEYNUM (512) /*!< Number of key_idx of a shard is multiple of it, 512 bits is one cache line of state bitmap */
+#endif
+#ifndef EBTN_CACHE_LINE_SIZE
+#define EBTN_CACHE_LINE_SIZE (64) /*!< Cache line size in bytes */
+#endif
+#if (EBTN_SHARD_ALIGN_KEYNUM % 64) != 0
+#error "EBTN_SHARD_ALIGN_KEYNUM must be multiple of 64"
+#endif
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+#error "EBTN_CONFIG_SHARD is not used with EBTN_CONFIG_TIMER_WHEEL"
+#endif
+#endif
+
+// #define EBTN_CONFIG_GESTURE
+
+// Match press patterns of a button, like short-short-long or hold then click, with a transition table compiled from
+// pattern strings by ebtn_gesture_compile(). Event callback feeds events to ebtn_gesture_feed(), one table lookup per
+// event, every button keeps its own match state.
+
 /* Forward declarations */
 struct ebtn_btn;
 struct ebtn;
 
+// Default max key number, size of the built-in state bitmaps and of the inline combo-button key bitmap.
+// Larger button group can use caller storage, see ebtn_set_state_storage_ex().
+#ifndef EBTN_MAX_KEYNUM
 #define EBTN_MAX_KEYNUM (64)
+#endif
+
+// Number of state bitmaps of a button group: old_state, in_process, curr_state, changed (and timer_due)
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+#define EBTN_STATE_BITMAP_NUM (5)
+#else
+#define EBTN_STATE_BITMAP_NUM (4)
+#endif
+
+// Number of bit array variables of the key_idx to button table of the state storage, with room to align it for pointers.
+// With EBTN_CONFIG_SOA button of key_idx is kept in the structure-of-arrays instead.
+#ifdef EBTN_CONFIG_SOA
+#define EBTN_STATE_BTN_TABLE_SIZE(max_keynum) (0)
+#else
+#define EBTN_STATE_BTN_TABLE_SIZE(max_keynum) ((((max_keynum) + 1) * sizeof(struct ebtn_btn *) + sizeof(bit_array_t) - 1) / sizeof(bit_array_t))
+#endif
+
+/**
+ * \brief           Number of bit array variables of the state storage for @a max_keynum buttons.
+ *
+ * \param           max_keynum: Max number of buttons in the button group.
+ */
+#define EBTN_STATE_STORAGE_SIZE(max_keynum) (EBTN_STATE_BITMAP_NUM * BIT_ARRAY_BITMAP_SIZE(max_keynum) + EBTN_STATE_BTN_TABLE_SIZE(max_keynum))
+
+/**
+ * \brief           Define the state storage for @a max_keynum buttons.
+ *
+ * \param           name: Name of the storage.
+ * \param           max_keynum: Max number of buttons in the button group.
+ */
+#define EBTN_STATE_STORAGE_DEFINE(name, max_keynum) bit_array_t name[EBTN_STATE_STORAGE_SIZE(max_keynum)]
+
+// #define EBTN_CONFIG_COMBO_INDEX
+
+// Keep an index of key_idx to combo-buttons and the active key count of every combo-button, a process only checks
+// combo-buttons whose keys changed or still in process, instead of checking keys of every combo-button.
+#ifdef EBTN_CONFIG_COMBO_INDEX
+// Max number of combo-buttons of the built-in combo index, combo-buttons beyond it are processed without the index.
+#ifndef EBTN_MAX_COMBONUM
+#define EBTN_MAX_COMBONUM (32)
+#endif
+
+/**
+ * \brief           Number of bit array variables of the combo index storage.
+ *
+ * \param           max_keynum: Max number of buttons in the button group.
+ * \param           max_combonum: Max number of combo-buttons in the button group.
+ */
+#define EBTN_COMBO_INDEX_STORAGE_SIZE(max_keynum, max_combonum) (((max_keynum) + 2) * BIT_ARRAY_BITMAP_SIZE(max_combonum))
+#endif
+
+// #define EBTN_CONFIG_KEY_INDEX
+
+// Keep an index of key_id to button, key_id lookup of ebtn_get_btn_index_by_key_id(), ebtn_combo_btn_add_btn() and
+// ebtn_feed_edge() is constant time instead of a linear search of all buttons.
+#ifdef EBTN_CONFIG_KEY_INDEX
+// key_id less than this value are looked up by a direct table, others by the hash table of the key index.
+#ifndef EBTN_KEY_ID_DIRECT_NUM
+#define EBTN_KEY_ID_DIRECT_NUM (32)
+#endif
+
+// Number of entries of the built-in key index hash table, for key_id not less than EBTN_KEY_ID_DIRECT_NUM.
+#ifndef EBTN_KEY_HASH_NUM
+#define EBTN_KEY_HASH_NUM (EBTN_MAX_KEYNUM)
+#endif
+
+#if EBTN_KEY_ID_DIRECT_NUM < 1 || EBTN_KEY_HASH_NUM < 1
+#error "EBTN_KEY_ID_DIRECT_NUM and EBTN_KEY_HASH_NUM must be at least 1"
+#endif
+
+/**
+ * \brief           Recommended number of key index hash entries for @a max_keynum buttons with sparse key_id.
+ *
+ * \param           max_keynum: Max number of buttons in the button group.
+ */
+#define EBTN_KEY_HASH_SIZE(max_keynum) (2 * (max_keynum))
+#endif
 
 /**
  * \brief           List of button events
@@ -87,6 +303,34 @@ typedef void (*ebtn_evt_fn)(struct ebtn_btn *btn, ebtn_evt_t evt);
  */
 typedef uint8_t (*ebtn_get_state_fn)(struct ebtn_btn *btn);
 
+/**
+ * \brief           Get input state of a range of state words in one call, instead of calling get_state_fn for every button
+ *
+ * Fill words `word_begin` to `word_end - 1`, bit of key_idx `i` is bit `i % BIT_ARRAY_BITS` of word `i / BIT_ARRAY_BITS`,
+ * `1` when button is considered `active`. Bits over key_num are ignored.
+ * key_idx of static buttons come first, then dynamic buttons in register order, see ebtn_get_btn_index_by_key_id_ex().
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[out]      state: State words of the button group, only words of the range are written
+ * \param[in]       word_begin: First word to fill
+ * \param[in]       word_end: One past last word to fill, never over `BIT_ARRAY_BITMAP_SIZE(key_num)`
+ * \param[in]       arg: User argument of the provider
+ */
+typedef void (*ebtn_get_state_bulk_fn)(struct ebtn *ebtobj, bit_array_t *state, int word_begin, int word_end, void *arg);
+
+/**
+ * \brief           Bulk state provider of a range of state words, e.g. one GPIO port or shift register chain.
+ * A button group can have many providers with ranges not overlapping.
+ */
+typedef struct ebtn_state_provider
+{
+    ebtn_get_state_bulk_fn fn;         /*!< Bulk state function */
+    void *arg;                         /*!< User argument passed to fn */
+    uint16_t word_begin;               /*!< First state word of the range */
+    uint16_t word_end;                 /*!< One past last state word of the range, `0` for up to last word in use */
+    struct ebtn_state_provider *next;  /*!< Next provider of the button group */
+} ebtn_state_provider_t;
+
 /**
  * \brief           Button Params structure
  */
@@ -222,8 +466,187 @@ typedef struct ebtn_btn_param
         .next = NULL, .btn = EBTN_BUTTON_COMBO_INIT(_key_id, _param),                                                                                          \
     }
 
+#define EBTN_BUTTON_COMBO_EXT_INIT(_key_id, _param, _comb_key_ext)                                                                                             \
+    {                                                                                                                                                          \
+        .comb_key = {0}, .comb_key_ext = _comb_key_ext, .btn = EBTN_BUTTON_INIT(_key_id, _param),                                                              \
+    }
+
+#define EBTN_BUTTON_COMBO_DYN_EXT_INIT(_key_id, _param, _comb_key_ext)                                                                                         \
+    {                                                                                                                                                          \
+        .next = NULL, .btn = EBTN_BUTTON_COMBO_EXT_INIT(_key_id, _param, _comb_key_ext),                                                                       \
+    }
+
 #define EBTN_ARRAY_SIZE(_arr) sizeof(_arr) / sizeof((_arr)[0])
 
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+/**
+ * \brief           Button timer structure, linked in timer wheel slot
+ */
+typedef struct ebtn_timer
+{
+    struct ebtn_timer *next;   /*!< Next timer in the same slot */
+    struct ebtn_timer **pprev; /*!< Point to previous next pointer, `NULL` means not scheduled */
+    ebtn_time_t expire;        /*!< Absolute expire time in ms */
+    int key_idx;               /*!< Button internal key_idx, `-1` means combo-button */
+} ebtn_timer_t;
+
+/**
+ * \brief           Hierarchical timer wheel structure
+ */
+typedef struct ebtn_timer_wheel
+{
+    ebtn_timer_t *slots[EBTN_TIMER_WHEEL_LEVELS][EBTN_TIMER_WHEEL_SLOTS]; /*!< Timer list of each slot */
+    uint64_t slot_mask[EBTN_TIMER_WHEEL_LEVELS];                         /*!< Slot may be not empty - `1` means slot need to be checked */
+    uint32_t cnt;                                                        /*!< Number of scheduled timers */
+    ebtn_time_t time;                                                    /*!< Time in ms of last advance */
+    uint8_t started;                                                     /*!< `1` when time is valid */
+} ebtn_timer_wheel_t;
+#endif
+
+#ifdef EBTN_CONFIG_STATS
+/**
+ * \brief           Button runtime statistics
+ */
+typedef struct ebtn_btn_stats
+{
+    uint16_t seq;                                 /*!< Private update sequence, odd while counters are being updated */
+    uint32_t transitions;                         /*!< Number of raw input transitions */
+    uint32_t bounces;                             /*!< Number of transitions reverted before debounce time passed */
+    uint32_t evt_cnt[EBTN_EVT_KEEPALIVE + 1];     /*!< Number of sent events, indexed by \ref ebtn_evt_t */
+    uint32_t press_hist[EBTN_STATS_HIST_NUM];     /*!< Histogram of press duration, from valid press to valid release */
+    uint32_t click_gap_hist[EBTN_STATS_HIST_NUM]; /*!< Histogram of gap from last click to next valid press */
+} ebtn_btn_stats_t;
+#endif
+
+#ifdef EBTN_CONFIG_GESTURE
+/**
+ * \brief           Gesture symbol, made from button event by ebtn_gesture_feed()
+ */
+typedef enum ebtn_gesture_sym
+{
+    EBTN_GESTURE_SYM_SHORT = 0, /*!< On-release of press without keep alive, `.` in pattern */
+    EBTN_GESTURE_SYM_LONG,      /*!< On-release of press with keep alive, `-` in pattern */
+    EBTN_GESTURE_SYM_HOLD,      /*!< Keep alive, one period of button still pressed, `_` in pattern */
+    EBTN_GESTURE_SYM_END,       /*!< End of sequence, on-click after release or on-press after idle of time_click_multi_max */
+    EBTN_GESTURE_SYM_NUM,
+} ebtn_gesture_sym_t;
+
+/**
+ * \brief           Number of gesture states for patterns of @a pattern_chars chars in total
+ */
+#define EBTN_GESTURE_STATE_NUM(pattern_chars) ((pattern_chars) + 2)
+
+/**
+ * \brief           Number of ebtn_gesture_trans_t entries of a table of @a max_states states
+ */
+#define EBTN_GESTURE_TABLE_SIZE(max_states) ((max_states) * EBTN_GESTURE_SYM_NUM)
+
+/**
+ * \brief           Gesture transition, of a state and a symbol
+ */
+typedef struct ebtn_gesture_trans
+{
+    uint16_t next;  /*!< Next state */
+    uint16_t match; /*!< Index of pattern matched by this transition plus `1`, `0` if none */
+} ebtn_gesture_trans_t;
+
+/**
+ * \brief           Compiled gesture patterns, shared by any number of buttons
+ */
+typedef struct ebtn_gesture
+{
+    ebtn_gesture_trans_t *table; /*!< Transition table, EBTN_GESTURE_SYM_NUM entries per state */
+    uint16_t state_size;         /*!< Max number of states of table */
+    uint16_t state_cnt;          /*!< Number of states in use */
+} ebtn_gesture_t;
+#endif
+
+#ifdef EBTN_CONFIG_SOA
+#ifdef EBTN_CONFIG_SIMD
+/* Deadline array of SoA storage, only used by the SIMD timeout check */
+#define EBTN_SOA_DEADLINE_DEFINE(max_keynum) ebtn_time_t deadline[max_keynum];
+#define EBTN_SOA_DEADLINE_INIT(_storage)     .deadline = (_storage).deadline,
+#else
+#define EBTN_SOA_DEADLINE_DEFINE(max_keynum)
+#define EBTN_SOA_DEADLINE_INIT(_storage)
+#endif
+
+/**
+ * \brief           Define structure-of-arrays storage for @a max_keynum buttons.
+ *
+ * \param           name: Name of the storage.
+ * \param           max_keynum: Max number of buttons in the button group.
+ */
+#define EBTN_SOA_STORAGE_DEFINE(name, max_keynum)                                                                                                              \
+    struct                                                                                                                                                     \
+    {                                                                                                                                                          \
+        struct ebtn_btn *btn[max_keynum];                                                                                                                      \
+        ebtn_time_t time_change[max_keynum];                                                                                                                   \
+        ebtn_time_t time_state_change[max_keynum];                                                                                                             \
+        ebtn_time_t keepalive_last_time[max_keynum];                                                                                                           \
+        ebtn_time_t click_last_time[max_keynum];                                                                                                               \
+        uint16_t click_cnt[max_keynum];                                                                                                                        \
+        uint8_t flags[max_keynum];                                                                                                                             \
+        uint8_t param_idx[max_keynum];                                                                                                                         \
+        EBTN_SOA_DEADLINE_DEFINE(max_keynum)                                                                                                                   \
+    } name
+
+/**
+ * \brief           Initialize ebtn_soa_t with storage defined by EBTN_SOA_STORAGE_DEFINE.
+ *
+ * \param           _storage: Storage defined by EBTN_SOA_STORAGE_DEFINE.
+ */
+#define EBTN_SOA_INIT(_storage)                                                                                                                                \
+    {                                                                                                                                                          \
+        .btn = (_storage).btn, .time_change = (_storage).time_change, .time_state_change = (_storage).time_state_change,                                       \
+        .keepalive_last_time = (_storage).keepalive_last_time, .click_last_time = (_storage).click_last_time, .click_cnt = (_storage).click_cnt,              \
+        .flags = (_storage).flags, .param_idx = (_storage).param_idx, EBTN_SOA_DEADLINE_INIT(_storage)                                                         \
+    }
+
+/**
+ * \brief           Structure-of-arrays button state, indexed by key_idx
+ */
+typedef struct ebtn_soa
+{
+    struct ebtn_btn **btn;            /*!< Button of key_idx */
+    ebtn_time_t *time_change;         /*!< Time in ms when button state got changed last time after valid debounce */
+    ebtn_time_t *time_state_change;   /*!< Time in ms when button state got changed last time */
+    ebtn_time_t *keepalive_last_time; /*!< Time in ms of last send keep alive event */
+    ebtn_time_t *click_last_time;     /*!< Time in ms of last successfully detected (not sent!) click event */
+    uint16_t *click_cnt;              /*!< Number of consecutive clicks detected */
+    uint8_t *flags;                   /*!< Private button flags management */
+    uint8_t *param_idx;               /*!< Index of param in the shared param table */
+#ifdef EBTN_CONFIG_SIMD
+    ebtn_time_t *deadline; /*!< Next time button in process need to be processed */
+#endif
+} ebtn_soa_t;
+
+#ifdef EBTN_CONFIG_SIMD
+/**
+ * \brief           Timeout check kernel
+ */
+typedef enum ebtn_simd_kernel
+{
+    EBTN_SIMD_AUTO = 0, /*!< Best kernel supported by CPU */
+    EBTN_SIMD_OFF,      /*!< No bulk check, process every button in process */
+    EBTN_SIMD_SCALAR,   /*!< Scalar kernel */
+    EBTN_SIMD_SSE2,     /*!< SSE2 kernel, x86 */
+    EBTN_SIMD_AVX2,     /*!< AVX2 kernel, x86 */
+    EBTN_SIMD_NEON,     /*!< NEON kernel, AArch64 */
+} ebtn_simd_kernel_t;
+
+/**
+ * \brief           Timeout check kernel function, get which buttons reached their deadline
+ *
+ * \param[in]       deadline: Deadline of buttons
+ * \param[in]       num: Number of buttons, not larger than `BIT_ARRAY_BITS`
+ * \param[in]       mstime: Current milliseconds system time
+ * \return          Bitmask of buttons whose deadline is reached, bit `i` for `deadline[i]`
+ */
+typedef bit_array_val_t (*ebtn_simd_due_fn)(const ebtn_time_t *deadline, int num, ebtn_time_t mstime);
+#endif
+#endif
+
 /**
  * \brief           Button structure
  */
@@ -245,8 +668,21 @@ typedef struct ebtn_btn
                             detection. Value is reset after on-release */
     uint16_t click_cnt;     /*!< Number of consecutive clicks detected, respecting maximum timeout
                         between clicks */
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+    uint16_t keepalive_step; /*!< Number of keep alive periods of last keep alive event, more than `1` when coalesced */
+#endif
 
     const ebtn_btn_param_t *param;
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    ebtn_timer_t timer; /*!< Private timer for next timeout */
+#endif
+#ifdef EBTN_CONFIG_STATS
+    ebtn_btn_stats_t stats; /*!< Private runtime statistics, read by ebtn_get_btn_stats() */
+#endif
+#ifdef EBTN_CONFIG_GESTURE
+    uint16_t gesture_state; /*!< Private gesture match state, see ebtn_gesture_feed() */
+#endif
 } ebtn_btn_t;
 
 /**
@@ -255,6 +691,12 @@ typedef struct ebtn_btn
 typedef struct ebtn_btn_combo
 {
     BIT_ARRAY_DEFINE(comb_key, EBTN_MAX_KEYNUM); /*!< select key index - `1` means active, `0` means inactive */
+    bit_array_t *comb_key_ext; /*!< select key index of caller storage, need `BIT_ARRAY_BITMAP_SIZE(max_keynum)` words of the button group, used instead of
+                                  `comb_key` when not `NULL` */
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    uint16_t key_cnt;        /*!< Private cached number of keys of combo-button */
+    uint16_t key_active_cnt; /*!< Private cached number of active keys of combo-button */
+#endif
 
     ebtn_btn_t btn;
 } ebtn_btn_combo_t;
@@ -265,6 +707,8 @@ typedef struct ebtn_btn_combo
 typedef struct ebtn_btn_dyn
 {
     struct ebtn_btn_dyn *next; /*!< point to next button */
+    int key_idx;               /*!< Private key_idx, set on register */
+    uint32_t group_gen;        /*!< Private generation of the button group registered to, `0` if not registered */
 
     ebtn_btn_t btn;
 } ebtn_btn_dyn_t;
@@ -275,10 +719,109 @@ typedef struct ebtn_btn_dyn
 typedef struct ebtn_btn_combo_dyn
 {
     struct ebtn_btn_combo_dyn *next; /*!< point to next combo-button */
+    uint32_t group_gen;              /*!< Private generation of the button group registered to, `0` if not registered */
 
     ebtn_btn_combo_t btn;
 } ebtn_btn_combo_dyn_t;
 
+#ifdef EBTN_CONFIG_EVT_RING
+/**
+ * \brief           Event record of the event ring
+ */
+typedef struct ebtn_evt_record
+{
+    ebtn_time_t time;       /*!< Time in ms of the process which generated the event */
+    uint16_t key_id;        /*!< key_id of button or combo-button */
+    uint16_t click_cnt;     /*!< Number of consecutive clicks when event generated */
+    uint16_t keepalive_cnt; /*!< Number of keep alive events when event generated */
+#ifdef EBTN_CONFIG_KEEPALIVE_COALESCE
+    uint16_t keepalive_step; /*!< Number of keep alive periods of keep alive event */
+#endif
+    uint8_t evt;            /*!< Event type, \ref ebtn_evt_t */
+    uint8_t combo;          /*!< `1` if event of combo-button, `0` otherwise */
+} ebtn_evt_record_t;
+
+/**
+ * \brief           Policy when event ring is full
+ */
+typedef enum ebtn_evt_ring_policy
+{
+    EBTN_EVT_RING_DROP_NEWEST = 0, /*!< Keep queued records, drop the new event */
+    EBTN_EVT_RING_DROP_OLDEST,     /*!< Overwrite the oldest queued record */
+} ebtn_evt_ring_policy_t;
+
+/**
+ * \brief           Event ring counters
+ */
+typedef struct ebtn_evt_ring_stats
+{
+    uint32_t queued;  /*!< Number of events put into the ring */
+    uint32_t dropped; /*!< Number of events lost because ring was full, new or overwritten by policy */
+    uint16_t peak;    /*!< Max number of records queued at the same time */
+} ebtn_evt_ring_stats_t;
+#endif
+
+/**
+ * \brief           Input edge of the input channel
+ */
+typedef struct ebtn_input_edge
+{
+    ebtn_time_t time; /*!< Time in ms of the edge */
+    uint16_t key_id;  /*!< key_id of button */
+    uint8_t state;    /*!< New input state, `1` means active */
+} ebtn_input_edge_t;
+
+/**
+ * \brief           Lock-free single-producer/single-consumer channel of input edges.
+ * Producer (input thread or interrupt) pushes edges, consumer (processing loop) drains them.
+ */
+typedef struct ebtn_input_channel
+{
+    ebtn_input_edge_t *edges; /*!< Edge storage */
+    uint16_t size;            /*!< Number of edges of storage, power of 2 */
+    uint16_t head;            /*!< Free running write index, written by producer only */
+    uint16_t tail;            /*!< Free running read index, written by consumer only */
+    uint32_t dropped;         /*!< Number of edges dropped because channel was full, written by producer only */
+} ebtn_input_channel_t;
+
+#ifdef EBTN_CONFIG_SHARD
+/**
+ * \brief           Event buffered by a shard, delivered after all shards are processed
+ */
+typedef struct ebtn_shard_evt
+{
+    ebtn_btn_t *btn;        /*!< Button of the event */
+    int key_idx;            /*!< Button internal key_idx */
+    ebtn_time_t time;       /*!< Time in ms of the process which generated the event */
+    uint16_t click_cnt;     /*!< Number of consecutive clicks when event generated */
+    uint16_t keepalive_cnt; /*!< Number of keep alive events when event generated */
+    uint8_t flags;          /*!< Button flags when event generated */
+    uint8_t evt;            /*!< Event type, \ref ebtn_evt_t */
+} ebtn_shard_evt_t;
+
+/**
+ * \brief           Shard of a button group, written only by the worker processing it
+ */
+typedef struct ebtn_shard
+{
+    ebtn_shard_evt_t *evts;            /*!< Event buffer of the shard */
+    uint16_t evt_size;                 /*!< Number of events of evts */
+    uint16_t evt_cnt;                  /*!< Private number of events buffered in this process */
+    uint32_t evt_dropped;              /*!< Number of events lost because event buffer was full */
+    uint8_t changed_any;               /*!< Private, some key of the shard changed in this process */
+    uint8_t pad[EBTN_CACHE_LINE_SIZE]; /*!< Keep fields of neighbour shards in different cache lines */
+} ebtn_shard_t;
+
+/**
+ * \brief           Run all shards callback function, see ebtn_process_sharded_ex()
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       shard_cnt: Number of shards, call ebtn_process_shard_ex() with every index from `0` to `shard_cnt - 1`
+ * \param[in]       arg: User argument
+ */
+typedef void (*ebtn_shard_run_fn)(struct ebtn *ebtobj, int shard_cnt, void *arg);
+#endif
+
 /**
  * \brief           easy_button group structure
  */
@@ -291,11 +834,91 @@ typedef struct ebtn
 
     ebtn_btn_dyn_t *btn_dyn_head;             /*!< Pointer to btn-dynamic list */
     ebtn_btn_combo_dyn_t *btn_combo_dyn_head; /*!< Pointer to btn-combo-dynamic list */
+    ebtn_btn_dyn_t *btn_dyn_tail;             /*!< Pointer to last of btn-dynamic list */
+    ebtn_btn_combo_dyn_t *btn_combo_dyn_tail; /*!< Pointer to last of btn-combo-dynamic list */
+    uint32_t group_gen;                       /*!< Generation of this init, unique for every init, marks registered dynamic buttons */
+
+    ebtn_evt_fn evt_fn;                       /*!< Pointer to event function */
+    ebtn_get_state_fn get_state_fn;           /*!< Pointer to get state function */
+    ebtn_state_provider_t *state_providers;   /*!< List of bulk state providers, used instead of get_state_fn when set */
+    ebtn_state_provider_t state_provider;     /*!< Provider of all words set by ebtn_set_get_state_bulk_ex() */
+
+    int key_num;      /*!< Number of key_idx in use, all bitmap operations only cover these bits */
+    int key_capacity; /*!< Max number of key_idx of the state storage */
+
+    bit_array_t *old_state;        /*!< Old button state - `1` means active, `0` means inactive */
+    bit_array_t *in_process;       /*!< Button in process state - `1` means button need process even input not change */
+    bit_array_t *curr_state;       /*!< Current button state, used by ebtn_process */
+    bit_array_t *changed;          /*!< Changed button state of this process */
+#ifndef EBTN_CONFIG_SOA
+    struct ebtn_btn **btn_table; /*!< Button of key_idx, static and dynamic, in the state storage */
+#endif
+    uint16_t combo_in_process_cnt; /*!< Number of combo-buttons in process */
+    uint8_t curr_state_synced;     /*!< curr_state equals old_state, a fed edge only changes its own bit */
+    ebtn_time_t feed_time;         /*!< Time of last fed edge or timeout, see ebtn_feed_edge_ex() */
+    uint8_t feed_time_valid;       /*!< feed_time is set */
+    uint8_t combo_dirty;           /*!< Buttons, combo-buttons or combo keys changed, combo-buttons are re-evaluated before next process */
+
+#ifdef EBTN_CONFIG_TIMER_WHEEL
+    ebtn_timer_wheel_t timer_wheel; /*!< Timer wheel of button timeout */
+    bit_array_t *timer_due;         /*!< Button timer expired - `1` means button need process */
+    uint16_t combo_due_cnt;         /*!< Number of combo-buttons timer expired */
+#endif
+
+    EBTN_STATE_STORAGE_DEFINE(state_storage, EBTN_MAX_KEYNUM); /*!< Built-in state storage, used when caller storage not set */
+
+#ifdef EBTN_CONFIG_KEY_INDEX
+    ebtn_btn_t *key_direct[EBTN_KEY_ID_DIRECT_NUM];    /*!< Key index of key_id less than EBTN_KEY_ID_DIRECT_NUM, indexed by key_id */
+    ebtn_btn_t **key_hash;                             /*!< Key index of other key_id, open-addressed hash table */
+    uint16_t key_hash_size;                            /*!< Number of entries of key_hash */
+    uint16_t key_hash_cnt;                             /*!< Number of used entries of key_hash */
+    uint8_t key_hash_overflow;                         /*!< Set when key_hash is full, lookup falls back to linear search */
+    ebtn_btn_t *key_hash_storage[EBTN_KEY_HASH_NUM];   /*!< Built-in key index hash storage, used when caller storage not set */
+#endif
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+    int combo_num;                 /*!< Number of combo-buttons, static and dynamic */
+    bit_array_t *combo_key_map;    /*!< Combo index, combo-buttons of every key_idx, one combo bitmap per key_idx */
+    bit_array_t *combo_touched;    /*!< Combo-buttons with keys changed in this process */
+    bit_array_t *combo_in_process; /*!< Combo-buttons in process */
+    ebtn_btn_combo_t **combo_ptr;  /*!< Combo-buttons by combo index */
+    int combo_index_keynum;        /*!< Max number of key_idx of the combo index storage */
+    int combo_index_capacity;      /*!< Max number of combo-buttons of the combo index storage */
+    uint8_t combo_index_valid;     /*!< Combo index covers all buttons and combo-buttons */
+    bit_array_t combo_index_storage[EBTN_COMBO_INDEX_STORAGE_SIZE(EBTN_MAX_KEYNUM, EBTN_MAX_COMBONUM)]; /*!< Built-in combo index storage */
+    ebtn_btn_combo_t *combo_ptr_storage[EBTN_MAX_COMBONUM];                                               /*!< Built-in combo pointer storage */
+#endif
+
+#ifdef EBTN_CONFIG_EVT_RING
+    ebtn_evt_record_t *evt_ring;                               /*!< Event ring, used when evt_fn not set */
+    uint16_t evt_ring_size;                                    /*!< Number of records of evt_ring, power of 2 */
+    uint16_t evt_ring_head;                                    /*!< Free running write index of evt_ring */
+    uint16_t evt_ring_tail;                                    /*!< Free running read index of evt_ring */
+    uint8_t evt_ring_policy;                                   /*!< Policy when ring is full, \ref ebtn_evt_ring_policy_t */
+    ebtn_evt_ring_stats_t evt_ring_stats;                      /*!< Event ring counters */
+    ebtn_evt_record_t evt_ring_storage[EBTN_EVT_RING_SIZE];    /*!< Built-in event ring storage */
+#endif
 
-    ebtn_evt_fn evt_fn;             /*!< Pointer to event function */
-    ebtn_get_state_fn get_state_fn; /*!< Pointer to get state function */
+#ifdef EBTN_CONFIG_SOA
+    ebtn_soa_t soa;                                          /*!< Structure-of-arrays state of buttons */
+    int soa_capacity;                                        /*!< Max number of key_idx of soa */
+    const ebtn_btn_param_t *param_table[EBTN_SOA_PARAM_NUM]; /*!< Shared param table */
+    uint8_t param_num;                                       /*!< Number of params in param_table */
+    EBTN_SOA_STORAGE_DEFINE(soa_storage, EBTN_MAX_KEYNUM);   /*!< Built-in structure-of-arrays storage */
+#endif
+#ifdef EBTN_CONFIG_SIMD
+    ebtn_simd_due_fn due_kernel; /*!< Timeout check kernel of the group, `NULL` means no bulk check */
+    uint8_t due_kernel_id;       /*!< Timeout check kernel of the group, \ref ebtn_simd_kernel_t */
+#endif
 
-    BIT_ARRAY_DEFINE(old_state, EBTN_MAX_KEYNUM); /*!< Old button state - `1` means active, `0` means inactive */
+#ifdef EBTN_CONFIG_SHARD
+    ebtn_shard_t *shards;          /*!< Shards, see ebtn_set_shards_ex() */
+    int shard_cnt;                 /*!< Number of shards, `0` means single thread processing */
+    int shard_keynum;              /*!< Number of key_idx of every shard in this process */
+    uint8_t shard_active;          /*!< Shards are being processed, button events go to the shard event buffer */
+    bit_array_t *shard_curr_state; /*!< Current state of shards in process */
+    ebtn_time_t shard_time;        /*!< Time of shards in process */
+#endif
 } ebtn_t;
 
 /**
@@ -306,6 +929,14 @@ typedef struct ebtn
  */
 void ebtn_process(ebtn_time_t mstime);
 
+/**
+ * \brief           Button processing function of a specific button group.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Current system time in milliseconds
+ */
+void ebtn_process_ex(ebtn_t *ebtobj, ebtn_time_t mstime);
+
 /**
  * \brief           Button processing function, with all button input state.
  *
@@ -314,6 +945,55 @@ void ebtn_process(ebtn_time_t mstime);
  */
 void ebtn_process_with_curr_state(bit_array_t *curr_state, ebtn_time_t mstime);
 
+/**
+ * \brief           Button processing function of a specific button group, with all button input state.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: Current all button input state
+ * \param[in]       mstime: Current system time in milliseconds
+ */
+void ebtn_process_with_curr_state_ex(ebtn_t *ebtobj, bit_array_t *curr_state, ebtn_time_t mstime);
+
+/**
+ * \brief           Process an input edge with its exact time, instead of sampling get_state_fn.
+ * Only the button of key_id changes state, others keep the last fed state. Edges must be fed in time order,
+ * an edge older than the last fed edge or timeout is processed at that time.
+ * Timeouts due before the edge are processed at their deadlines first, so a batch of edges can be fed at once.
+ * Call ebtn_feed_time() at the deadline from ebtn_get_next_deadline() to process timeouts when no edge comes.
+ *
+ * \param[in]       key_id: key_id of button
+ * \param[in]       state: New input state, `1` means active
+ * \param[in]       mstime: Time in ms of the edge
+ * \return          `1` on success, `0` if key_id is not registered
+ */
+int ebtn_feed_edge(uint16_t key_id, uint8_t state, ebtn_time_t mstime);
+
+/**
+ * \brief           Process an input edge of a specific button group with its exact time.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       key_id: key_id of button
+ * \param[in]       state: New input state, `1` means active
+ * \param[in]       mstime: Time in ms of the edge
+ * \return          `1` on success, `0` if key_id is not registered
+ */
+int ebtn_feed_edge_ex(ebtn_t *ebtobj, uint16_t key_id, uint8_t state, ebtn_time_t mstime);
+
+/**
+ * \brief           Process timeouts of edge-fed buttons without any input change.
+ *
+ * \param[in]       mstime: Current system time in milliseconds
+ */
+void ebtn_feed_time(ebtn_time_t mstime);
+
+/**
+ * \brief           Process timeouts of edge-fed buttons of a specific button group without any input change.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Current system time in milliseconds
+ */
+void ebtn_feed_time_ex(ebtn_t *ebtobj, ebtn_time_t mstime);
+
 /**
  * \brief           Check if button is active.
  * Active is considered when initial debounce period has been a pass.
@@ -341,6 +1021,34 @@ int ebtn_is_btn_in_process(const ebtn_btn_t *btn);
  */
 int ebtn_is_in_process(void);
 
+/**
+ * \brief           Check if some button of a specific button group is in process.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \return          `1` if in process, `0` otherwise
+ */
+int ebtn_is_in_process_ex(ebtn_t *ebtobj);
+
+/**
+ * \brief           Get the earliest time some button need to be processed again, without any input change.
+ * Used for tickless processing, system can sleep until the deadline or the next input change.
+ *
+ * \param[in]       mstime: Current system time in milliseconds, returned when some button is already due
+ * \param[out]      deadline: Absolute time in milliseconds of the next timer-driven processing
+ * \return          `1` if deadline is valid, `0` if all buttons are idle and no deadline exists
+ */
+int ebtn_get_next_deadline(ebtn_time_t mstime, ebtn_time_t *deadline);
+
+/**
+ * \brief           Get the earliest time some button of a specific button group need to be processed again.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       mstime: Current system time in milliseconds, returned when some button is already due
+ * \param[out]      deadline: Absolute time in milliseconds of the next timer-driven processing
+ * \return          `1` if deadline is valid, `0` if all buttons are idle and no deadline exists
+ */
+int ebtn_get_next_deadline_ex(ebtn_t *ebtobj, ebtn_time_t mstime, ebtn_time_t *deadline);
+
 /**
  * \brief           Initialize button manager
  * \param[in]       btns: Array of buttons to process
@@ -354,6 +1062,497 @@ int ebtn_is_in_process(void);
  */
 int ebtn_init(ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo, uint16_t btns_combo_cnt, ebtn_get_state_fn get_state_fn, ebtn_evt_fn evt_fn);
 
+/**
+ * \brief           Initialize a specific button group, each group is processed independently.
+ * \param[in]       ebtobj: Button group instance, owned by caller
+ * \param[in]       btns: Array of buttons to process
+ * \param[in]       btns_cnt: Number of buttons to process
+ * \param[in]       btns_combo: Array of combo-buttons to process
+ * \param[in]       btns_combo_cnt: Number of combo-buttons to process
+ * \param[in]       get_state_fn: Pointer to function providing button state on demand, can be `NULL` if only fed by ebtn_feed_edge_ex()
+ *                  or ebtn_set_get_state_bulk_ex() is used
+ * \param[in]       evt_fn: Button event function callback, can be `NULL` with `EBTN_CONFIG_EVT_RING` to queue events in the event ring
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_init_ex(ebtn_t *ebtobj, ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo, uint16_t btns_combo_cnt, ebtn_get_state_fn get_state_fn,
+                 ebtn_evt_fn evt_fn);
+
+/**
+ * \brief           Initialize input channel
+ *
+ * \param[in]       ch: Input channel instance
+ * \param[in]       storage: Edge storage
+ * \param[in]       size: Number of edges of storage, must be power of 2
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_input_channel_init(ebtn_input_channel_t *ch, ebtn_input_edge_t *storage, uint16_t size);
+
+/**
+ * \brief           Push input edge, called by producer only
+ *
+ * \param[in]       ch: Input channel instance
+ * \param[in]       key_id: key_id of button
+ * \param[in]       state: New input state, `1` means active
+ * \param[in]       time: Time in ms of the edge
+ *
+ * \return          `1` on success, `0` if channel is full and edge is dropped
+ */
+int ebtn_input_channel_push(ebtn_input_channel_t *ch, uint16_t key_id, uint8_t state, ebtn_time_t time);
+
+/**
+ * \brief           Pop the oldest input edge, called by consumer only
+ *
+ * \param[in]       ch: Input channel instance
+ * \param[out]      edge: Input edge
+ *
+ * \return          `1` on success, `0` if channel is empty
+ */
+int ebtn_input_channel_pop(ebtn_input_channel_t *ch, ebtn_input_edge_t *edge);
+
+/**
+ * \brief           Drain input edges into current state bitmap, called by consumer only.
+ * Process with ebtn_process_with_curr_state() afterwards, edges of unknown key_id are ignored.
+ * Draining stops at the second edge of the same button, the rest is drained after next process, so a short press is not lost.
+ * Time of edges is not used, see ebtn_input_channel_feed() for edge-fed button group.
+ *
+ * \param[in]       ch: Input channel instance
+ * \param[in,out]   curr_state: Current all button input state, kept by caller between processes
+ *
+ * \return          Number of edges drained
+ */
+int ebtn_input_channel_drain(ebtn_input_channel_t *ch, bit_array_t *curr_state);
+
+/**
+ * \brief           Drain input edges into current state bitmap of a specific button group, called by consumer only.
+ * Draining stops at the second edge of the same button, the rest is drained after next process.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       ch: Input channel instance
+ * \param[in,out]   curr_state: Current all button input state, kept by caller between processes
+ *
+ * \return          Number of edges drained
+ */
+int ebtn_input_channel_drain_ex(ebtn_t *ebtobj, ebtn_input_channel_t *ch, bit_array_t *curr_state);
+
+/**
+ * \brief           Feed all input edges one by one with their time by ebtn_feed_edge(), called by consumer only.
+ * Timeouts due before an edge are processed at their deadline first, edges of unknown key_id are ignored.
+ *
+ * \param[in]       ch: Input channel instance
+ *
+ * \return          Number of edges fed
+ */
+int ebtn_input_channel_feed(ebtn_input_channel_t *ch);
+
+/**
+ * \brief           Feed all input edges one by one with their time to a specific button group by ebtn_feed_edge_ex(), called by consumer only.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       ch: Input channel instance
+ *
+ * \return          Number of edges fed
+ */
+int ebtn_input_channel_feed_ex(ebtn_t *ebtobj, ebtn_input_channel_t *ch);
+
+#ifdef EBTN_CONFIG_SHARD
+/**
+ * \brief           Set shards for parallel processing, buttons are split into `shard_cnt` ranges of key_idx on every process.
+ *
+ * \param[in]       shards: Shard storage of `shard_cnt` entries, `NULL` with `shard_cnt` `0` for single thread processing
+ * \param[in]       shard_cnt: Number of shards, usually number of workers
+ * \param[in]       evts: Event buffer storage of `shard_cnt * evts_per_shard` entries
+ * \param[in]       evts_per_shard: Max number of events of a shard in one process
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_shards(ebtn_shard_t *shards, int shard_cnt, ebtn_shard_evt_t *evts, uint16_t evts_per_shard);
+
+/**
+ * \brief           Set shards for parallel processing of a specific button group.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       shards: Shard storage of `shard_cnt` entries, `NULL` with `shard_cnt` `0` for single thread processing
+ * \param[in]       shard_cnt: Number of shards, usually number of workers
+ * \param[in]       evts: Event buffer storage of `shard_cnt * evts_per_shard` entries
+ * \param[in]       evts_per_shard: Max number of events of a shard in one process
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_shards_ex(ebtn_t *ebtobj, ebtn_shard_t *shards, int shard_cnt, ebtn_shard_evt_t *evts, uint16_t evts_per_shard);
+
+/**
+ * \brief           Process with current state by shards, same result as ebtn_process_with_curr_state().
+ *
+ * Buttons of every shard are processed by `run_fn`, which can hand shards over to a worker pool and must return
+ * after all of them are finished. Combo-buttons are processed and buffered events are delivered afterwards in the calling thread.
+ *
+ * \param[in]       curr_state: Current all button state
+ * \param[in]       mstime: Current milliseconds system time
+ * \param[in]       run_fn: Run all shards function, `NULL` to run them one by one in the calling thread
+ * \param[in]       arg: User argument of run_fn
+ */
+void ebtn_process_sharded(bit_array_t *curr_state, ebtn_time_t mstime, ebtn_shard_run_fn run_fn, void *arg);
+
+/**
+ * \brief           Process with current state by shards of a specific button group.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       curr_state: Current all button state
+ * \param[in]       mstime: Current milliseconds system time
+ * \param[in]       run_fn: Run all shards function, `NULL` to run them one by one in the calling thread
+ * \param[in]       arg: User argument of run_fn
+ */
+void ebtn_process_sharded_ex(ebtn_t *ebtobj, bit_array_t *curr_state, ebtn_time_t mstime, ebtn_shard_run_fn run_fn, void *arg);
+
+/**
+ * \brief           Process buttons of one shard, called by run_fn of ebtn_process_sharded_ex() from any thread.
+ * Different shards can be processed at the same time.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       shard: Index of shard
+ */
+void ebtn_process_shard_ex(ebtn_t *ebtobj, int shard);
+#endif
+
+#ifdef EBTN_CONFIG_EVT_RING
+/**
+ * \brief           Fetch queued events in bulk, oldest first
+ *
+ * \param[out]      buf: Buffer of event records
+ * \param[in]       max: Max number of records of buf
+ *
+ * \return          Number of records fetched
+ */
+int ebtn_events_drain(ebtn_evt_record_t *buf, int max);
+
+/**
+ * \brief           Fetch queued events of a specific button group in bulk, oldest first
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[out]      buf: Buffer of event records
+ * \param[in]       max: Max number of records of buf
+ *
+ * \return          Number of records fetched
+ */
+int ebtn_events_drain_ex(ebtn_t *ebtobj, ebtn_evt_record_t *buf, int max);
+
+/**
+ * \brief           Get number of queued events
+ *
+ * \return          Number of queued events
+ */
+int ebtn_events_pending(void);
+
+/**
+ * \brief           Get number of queued events of a specific button group
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \return          Number of queued events
+ */
+int ebtn_events_pending_ex(ebtn_t *ebtobj);
+
+/**
+ * \brief           Set policy when event ring is full, default is `EBTN_EVT_RING_DROP_NEWEST`
+ *
+ * \param[in]       policy: Policy when event ring is full
+ */
+void ebtn_events_set_policy(ebtn_evt_ring_policy_t policy);
+
+/**
+ * \brief           Set policy when event ring of a specific button group is full
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       policy: Policy when event ring is full
+ */
+void ebtn_events_set_policy_ex(ebtn_t *ebtobj, ebtn_evt_ring_policy_t policy);
+
+/**
+ * \brief           Get event ring counters
+ *
+ * \param[out]      stats: Event ring counters
+ * \param[in]       reset: `1` to reset counters after read
+ */
+void ebtn_events_get_stats(ebtn_evt_ring_stats_t *stats, int reset);
+
+/**
+ * \brief           Get event ring counters of a specific button group
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[out]      stats: Event ring counters
+ * \param[in]       reset: `1` to reset counters after read
+ */
+void ebtn_events_get_stats_ex(ebtn_t *ebtobj, ebtn_evt_ring_stats_t *stats, int reset);
+
+/**
+ * \brief           Use caller storage for the event ring, queued events are discarded.
+ *
+ * \param[in]       storage: Event ring storage
+ * \param[in]       size: Number of records of storage, must be power of 2
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_evt_ring_storage(ebtn_evt_record_t *storage, uint16_t size);
+
+/**
+ * \brief           Use caller storage for the event ring of a specific button group, queued events are discarded.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       storage: Event ring storage
+ * \param[in]       size: Number of records of storage, must be power of 2
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_evt_ring_storage_ex(ebtn_t *ebtobj, ebtn_evt_record_t *storage, uint16_t size);
+#endif
+
+#ifdef EBTN_CONFIG_SOA
+/**
+ * \brief           Use caller structure-of-arrays storage, to support more than `EBTN_MAX_KEYNUM` buttons in SoA mode.
+ * Must be called before any dynamic button register beyond capacity of current storage.
+ *
+ * \param[in]       soa: Storage initialized by `EBTN_SOA_INIT` with storage defined by `EBTN_SOA_STORAGE_DEFINE(name, max_keynum)`
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_soa_storage(const ebtn_soa_t *soa, int max_keynum);
+
+/**
+ * \brief           Use caller structure-of-arrays storage of a specific button group.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       soa: Storage initialized by `EBTN_SOA_INIT` with storage defined by `EBTN_SOA_STORAGE_DEFINE(name, max_keynum)`
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_soa_storage_ex(ebtn_t *ebtobj, const ebtn_soa_t *soa, int max_keynum);
+#endif
+
+#ifdef EBTN_CONFIG_SIMD
+/**
+ * \brief           Select the timeout check kernel of the default button group and of button groups initialized later.
+ * Groups already initialized keep their kernel, call it before groups are initialized and processed by other contexts.
+ *
+ * \param[in]       kernel: Kernel to use, `EBTN_SIMD_AUTO` selects the best one supported by CPU
+ *
+ * \return          `1` on success, `0` if kernel not supported by CPU or not compiled
+ */
+int ebtn_simd_select(ebtn_simd_kernel_t kernel);
+
+/**
+ * \brief           Select the timeout check kernel of a specific button group, must not be called while the group is processed.
+ * ebtn_init_ex() selects the kernel of ebtn_simd_select(), `EBTN_SIMD_AUTO` if never called.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       kernel: Kernel to use, `EBTN_SIMD_AUTO` selects the best one supported by CPU
+ *
+ * \return          `1` on success, `0` if kernel not supported by CPU or not compiled
+ */
+int ebtn_simd_select_ex(ebtn_t *ebtobj, ebtn_simd_kernel_t kernel);
+
+/**
+ * \brief           Get the timeout check kernel selected for button groups initialized later
+ *
+ * \return          Kernel of ebtn_simd_select(), never `EBTN_SIMD_AUTO`
+ */
+ebtn_simd_kernel_t ebtn_simd_get(void);
+
+/**
+ * \brief           Get the timeout check kernel of a specific button group
+ *
+ * \param[in]       ebtobj: Button group instance
+ *
+ * \return          Kernel in use, never `EBTN_SIMD_AUTO`
+ */
+ebtn_simd_kernel_t ebtn_simd_get_ex(ebtn_t *ebtobj);
+#endif
+
+#ifdef EBTN_CONFIG_STATS
+/**
+ * \brief           Get a consistent snapshot of button runtime statistics.
+ * Can be called from another thread or interrupt while the button group is processed, retries when counters change during copy.
+ *
+ * \param[in]       btn: Button instance, `&combo->btn` for combo-button
+ * \param[out]      stats: Statistics snapshot
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_get_btn_stats(const ebtn_btn_t *btn, ebtn_btn_stats_t *stats);
+
+/**
+ * \brief           Clear button runtime statistics, must be called in the same context as processing
+ *
+ * \param[in]       btn: Button instance, `&combo->btn` for combo-button
+ */
+void ebtn_reset_btn_stats(ebtn_btn_t *btn);
+#endif
+
+#ifdef EBTN_CONFIG_GESTURE
+/**
+ * \brief           Compile gesture patterns into a transition table
+ *
+ * Pattern is a string of `.` short press, `-` long press (released after keep alive) and `_` one keep alive period
+ * of holding, e.g. `"..-"` or `"____."`. Holding longer than the `_` of a pattern is allowed. Pattern is matched
+ * right after its last symbol. Pattern which is the prefix of another pattern is matched when the sequence ends or
+ * next symbol does not continue the longer one, a sequence ending with long press ends only by the next press.
+ * A symbol not continuing any pattern starts matching again from the start.
+ *
+ * \param[out]      gesture: Compiled gesture
+ * \param[in]       table: Table storage of `EBTN_GESTURE_TABLE_SIZE(max_states)` entries
+ * \param[in]       max_states: Max number of states, `EBTN_GESTURE_STATE_NUM(pattern_chars)` is always enough
+ * \param[in]       patterns: Pattern strings, match result is the index of pattern
+ * \param[in]       pattern_cnt: Number of patterns
+ *
+ * \return          `1` on success, `0` if a pattern is empty, invalid, duplicated or states are not enough
+ */
+int ebtn_gesture_compile(ebtn_gesture_t *gesture, ebtn_gesture_trans_t *table, uint16_t max_states, const char *const *patterns, int pattern_cnt);
+
+/**
+ * \brief           Feed button event to gesture matching, called from event callback
+ *
+ * Uses EBTN_EVT_ONPRESS, EBTN_EVT_ONRELEASE, EBTN_EVT_ONCLICK and EBTN_EVT_KEEPALIVE, they must be in event_mask
+ * of the button.
+ *
+ * \param[in]       gesture: Compiled gesture, same for all events of the button
+ * \param[in]       btn: Button of the event
+ * \param[in]       evt: Event type
+ *
+ * \return          Index of matched pattern, `-1` if none
+ */
+int ebtn_gesture_feed(const ebtn_gesture_t *gesture, ebtn_btn_t *btn, ebtn_evt_t evt);
+
+/**
+ * \brief           Reset gesture match state of button to the start, needed before feeding another gesture
+ *
+ * \param[in]       btn: Button instance
+ */
+void ebtn_gesture_reset(ebtn_btn_t *btn);
+#endif
+
+#ifdef EBTN_CONFIG_COMBO_INDEX
+/**
+ * \brief           Use caller storage for the combo index, to keep combo processing proportional to changed keys with many combo-buttons.
+ * Index is rebuilt from all registered buttons and combo-buttons.
+ *
+ * \param[in]       storage: Combo index storage of `EBTN_COMBO_INDEX_STORAGE_SIZE(max_keynum, max_combonum)` words
+ * \param[in]       combos: Combo-button pointer storage of `max_combonum` entries
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ * \param[in]       max_combonum: Max number of combo-buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_combo_index_storage(bit_array_t *storage, ebtn_btn_combo_t **combos, int max_keynum, int max_combonum);
+
+/**
+ * \brief           Use caller storage for the combo index of a specific button group.
+ * Index is rebuilt from all registered buttons and combo-buttons.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       storage: Combo index storage of `EBTN_COMBO_INDEX_STORAGE_SIZE(max_keynum, max_combonum)` words
+ * \param[in]       combos: Combo-button pointer storage of `max_combonum` entries
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ * \param[in]       max_combonum: Max number of combo-buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_combo_index_storage_ex(ebtn_t *ebtobj, bit_array_t *storage, ebtn_btn_combo_t **combos, int max_keynum, int max_combonum);
+#endif
+
+#ifdef EBTN_CONFIG_KEY_INDEX
+/**
+ * \brief           Use caller storage for the key index hash table, to keep key_id lookup constant-time with many sparse key_id.
+ * Index is rebuilt from all registered buttons.
+ *
+ * \param[in]       storage: Hash table storage, `EBTN_KEY_HASH_SIZE(max_keynum)` entries is recommended
+ * \param[in]       size: Number of entries of the storage
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_key_index_storage(ebtn_btn_t **storage, uint16_t size);
+
+/**
+ * \brief           Use caller storage for the key index hash table of a specific button group.
+ * Index is rebuilt from all registered buttons.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       storage: Hash table storage, `EBTN_KEY_HASH_SIZE(max_keynum)` entries is recommended
+ * \param[in]       size: Number of entries of the storage
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_key_index_storage_ex(ebtn_t *ebtobj, ebtn_btn_t **storage, uint16_t size);
+#endif
+
+/**
+ * \brief           Use caller storage for the state bitmaps, to support more than `EBTN_MAX_KEYNUM` buttons.
+ * Must be called after ebtn_init() and before any dynamic button register.
+ *
+ * \param[in]       storage: State storage, defined by `EBTN_STATE_STORAGE_DEFINE(name, max_keynum)`
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_state_storage(bit_array_t *storage, int max_keynum);
+
+/**
+ * \brief           Use caller storage for the state bitmaps of a specific button group, to support more than `EBTN_MAX_KEYNUM` buttons.
+ * Must be called after ebtn_init_ex() and before any dynamic button register.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       storage: State storage, defined by `EBTN_STATE_STORAGE_DEFINE(name, max_keynum)`
+ * \param[in]       max_keynum: Max number of buttons, static and dynamic
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_state_storage_ex(ebtn_t *ebtobj, bit_array_t *storage, int max_keynum);
+
+/**
+ * \brief           Read input state of all buttons with one bulk call per process, instead of get_state_fn of every button.
+ * Used when inputs are read by ports or shift registers of many lines at once.
+ * Replaces all providers of the button group with one provider of all state words.
+ *
+ * \param[in]       get_state_bulk_fn: Bulk state function, `NULL` to remove all providers and use get_state_fn again
+ * \param[in]       arg: User argument passed to get_state_bulk_fn
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_get_state_bulk(ebtn_get_state_bulk_fn get_state_bulk_fn, void *arg);
+
+/**
+ * \brief           Read input state of all buttons of a specific button group with one bulk call per process.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       get_state_bulk_fn: Bulk state function, `NULL` to remove all providers and use get_state_fn again
+ * \param[in]       arg: User argument passed to get_state_bulk_fn
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_set_get_state_bulk_ex(ebtn_t *ebtobj, ebtn_get_state_bulk_fn get_state_bulk_fn, void *arg);
+
+/**
+ * \brief           Add a bulk state provider of a range of state words.
+ * Inputs of one button group read from several ports or chains, every provider fills its own words.
+ * Words not covered by any provider keep last state, and can be fed by ebtn_feed_edge_ex().
+ *
+ * \param[in]       provider: Provider with fn, arg and word range set, kept by button group until ebtn_set_get_state_bulk() or init
+ *
+ * \return          `1` on success, `0` if fn is not set, range is empty, or range overlaps another provider
+ */
+int ebtn_add_state_provider(ebtn_state_provider_t *provider);
+
+/**
+ * \brief           Add a bulk state provider of a range of state words to a specific button group
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       provider: Provider with fn, arg and word range set, kept by button group until ebtn_set_get_state_bulk_ex() or init
+ *
+ * \return          `1` on success, `0` if fn is not set, range is empty, or range overlaps another provider
+ */
+int ebtn_add_state_provider_ex(ebtn_t *ebtobj, ebtn_state_provider_t *provider);
+
 /**
  * @brief Register a dynamic button
  *
@@ -362,6 +1561,15 @@ int ebtn_init(ebtn_btn_t *btns, uint16_t btns_cnt, ebtn_btn_combo_t *btns_combo,
  */
 int ebtn_register(ebtn_btn_dyn_t *button);
 
+/**
+ * @brief Register a dynamic button to a specific button group
+ *
+ * @param ebtobj: Button group instance
+ * @param button: Dynamic button structure instance
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_register_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *button);
+
 /**
  * \brief           Register a dynamic combo-button
  * \param[in]       button: Dynamic combo-button structure instance
@@ -370,6 +1578,97 @@ int ebtn_register(ebtn_btn_dyn_t *button);
  */
 int ebtn_combo_register(ebtn_btn_combo_dyn_t *button);
 
+/**
+ * \brief           Register a dynamic combo-button to a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic combo-button structure instance
+ *
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_combo_register_ex(ebtn_t *ebtobj, ebtn_btn_combo_dyn_t *button);
+
+/**
+ * \brief           Register an array of dynamic buttons
+ *
+ * All buttons are registered in array order, or none of them if capacity is not enough or any is already registered.
+ *
+ * \param[in]       buttons: Array of dynamic buttons
+ * \param[in]       cnt: Number of buttons of array
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_register_bulk(ebtn_btn_dyn_t *buttons, int cnt);
+
+/**
+ * \brief           Register an array of dynamic buttons to a specific button group
+ *
+ * All buttons are registered in array order, or none of them if capacity is not enough or any is already registered.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       buttons: Array of dynamic buttons
+ * \param[in]       cnt: Number of buttons of array
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_register_bulk_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *buttons, int cnt);
+
+/**
+ * \brief           Unregister a dynamic button
+ *
+ * \param[in]       button: Dynamic button structure instance
+ * \return          `1` on success, `0` if button is not registered
+ */
+int ebtn_unregister(ebtn_btn_dyn_t *button);
+
+/**
+ * \brief           Unregister a dynamic button of a specific button group
+ *
+ * key_idx of the following dynamic buttons move down to keep key_idx compact, state bitmaps and combo-button keys are
+ * remapped with them. Caller maintained state of ebtn_process_with_curr_state_ex() must be remapped by caller.
+ * Pending events of the button are dropped, its state is kept in the button. Not allowed in event callback.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic button structure instance
+ * \return          `1` on success, `0` if button is not registered
+ */
+int ebtn_unregister_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *button);
+
+/**
+ * \brief           Unregister many dynamic buttons
+ *
+ * \param[in]       buttons: Array of pointers to dynamic buttons
+ * \param[in]       cnt: Number of buttons of array
+ * \return          `1` on success, `0` if any button is not registered, nothing is unregistered then
+ */
+int ebtn_unregister_bulk(ebtn_btn_dyn_t *const *buttons, int cnt);
+
+/**
+ * \brief           Unregister many dynamic buttons of a specific button group
+ *
+ * Same as ebtn_unregister_ex(), with key_idx compacted once for all buttons.
+ *
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       buttons: Array of pointers to dynamic buttons
+ * \param[in]       cnt: Number of buttons of array
+ * \return          `1` on success, `0` if any button is not registered, nothing is unregistered then
+ */
+int ebtn_unregister_bulk_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *const *buttons, int cnt);
+
+/**
+ * \brief           Unregister a dynamic combo-button
+ * \param[in]       button: Dynamic combo-button structure instance
+ *
+ * \return          `1` on success, `0` if combo-button is not registered
+ */
+int ebtn_combo_unregister(ebtn_btn_combo_dyn_t *button);
+
+/**
+ * \brief           Unregister a dynamic combo-button of a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       button: Dynamic combo-button structure instance
+ *
+ * \return          `1` on success, `0` if combo-button is not registered
+ */
+int ebtn_combo_unregister_ex(ebtn_t *ebtobj, ebtn_btn_combo_dyn_t *button);
+
 /**
  * \brief           Get the current total button cnt
  *
@@ -377,6 +1676,14 @@ int ebtn_combo_register(ebtn_btn_combo_dyn_t *button);
  */
 int ebtn_get_total_btn_cnt(void);
 
+/**
+ * \brief           Get the current total button cnt of a specific button group
+ * \param[in]       ebtobj: Button group instance
+ *
+ * \return          size of button.
+ */
+int ebtn_get_total_btn_cnt_ex(ebtn_t *ebtobj);
+
 /**
  * \brief           Get the internal key_idx of the key_id
  * \param[in]       key_id: key_id
@@ -385,6 +1692,15 @@ int ebtn_get_total_btn_cnt(void);
  */
 int ebtn_get_btn_index_by_key_id(uint16_t key_id);
 
+/**
+ * \brief           Get the internal key_idx of the key_id in a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       key_id: key_id
+ *
+ * \return          '-1' on error, other is key_idx
+ */
+int ebtn_get_btn_index_by_key_id_ex(ebtn_t *ebtobj, uint16_t key_id);
+
 /**
  * \brief           Get the internal btn instance of the key_id, here is the button instance, and what is dynamically registered is also to obtain its button
  * instance
@@ -395,6 +1711,15 @@ int ebtn_get_btn_index_by_key_id(uint16_t key_id);
  */
 ebtn_btn_t *ebtn_get_btn_by_key_id(uint16_t key_id);
 
+/**
+ * \brief           Get the internal btn instance of the key_id in a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       key_id: key_id
+ *
+ * \return          'NULL' on error, other is button instance
+ */
+ebtn_btn_t *ebtn_get_btn_by_key_id_ex(ebtn_t *ebtobj, uint16_t key_id);
+
 /**
  * \brief           Get the internal key_idx of the button
  * \param[in]       btn: Button
@@ -403,6 +1728,15 @@ ebtn_btn_t *ebtn_get_btn_by_key_id(uint16_t key_id);
  */
 int ebtn_get_btn_index_by_btn(ebtn_btn_t *btn);
 
+/**
+ * \brief           Get the internal key_idx of the button in a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button
+ *
+ * \return          '-1' on error, other is key_idx
+ */
+int ebtn_get_btn_index_by_btn_ex(ebtn_t *ebtobj, ebtn_btn_t *btn);
+
 /**
  * \brief           Get the internal key_idx of the dynamic button
  * \param[in]       btn: Button
@@ -411,10 +1745,19 @@ int ebtn_get_btn_index_by_btn(ebtn_btn_t *btn);
  */
 int ebtn_get_btn_index_by_btn_dyn(ebtn_btn_dyn_t *btn);
 
+/**
+ * \brief           Get the internal key_idx of the dynamic button in a specific button group
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Button
+ *
+ * \return          '-1' on error, other is key_idx
+ */
+int ebtn_get_btn_index_by_btn_dyn_ex(ebtn_t *ebtobj, ebtn_btn_dyn_t *btn);
+
 /**
  * \brief           Bind combo-button key with key_idx
  * \param[in]       btn: Combo Button
- * \param[in]       idx: key_idx
+ * \param[in]       idx: key_idx, must be less than `EBTN_MAX_KEYNUM` if `comb_key_ext` not used
  *
  */
 void ebtn_combo_btn_add_btn_by_idx(ebtn_btn_combo_t *btn, int idx);
@@ -427,6 +1770,24 @@ void ebtn_combo_btn_add_btn_by_idx(ebtn_btn_combo_t *btn, int idx);
  */
 void ebtn_combo_btn_remove_btn_by_idx(ebtn_btn_combo_t *btn, int idx);
 
+/**
+ * \brief           Bind combo-button key with key_idx of a specific button group.
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Combo Button
+ * \param[in]       idx: key_idx, must be less than `EBTN_MAX_KEYNUM` if `comb_key_ext` not used
+ *
+ */
+void ebtn_combo_btn_add_btn_by_idx_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, int idx);
+
+/**
+ * \brief           Remove combo-button key with key_idx of a specific button group.
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Combo Button
+ * \param[in]       idx: key_idx
+ *
+ */
+void ebtn_combo_btn_remove_btn_by_idx_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, int idx);
+
 /**
  * \brief           Bind combo-button key with key_id, make sure key_id(button) is already register.
  * \param[in]       btn: Combo Button
@@ -435,6 +1796,15 @@ void ebtn_combo_btn_remove_btn_by_idx(ebtn_btn_combo_t *btn, int idx);
  */
 void ebtn_combo_btn_add_btn(ebtn_btn_combo_t *btn, uint16_t key_id);
 
+/**
+ * \brief           Bind combo-button key with key_id of a specific button group.
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Combo Button
+ * \param[in]       key_id: key_id
+ *
+ */
+void ebtn_combo_btn_add_btn_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, uint16_t key_id);
+
 /**
  * \brief           Remove combo-button key with key_id, make sure key_id(button) is already
  * register. \param[in]       btn: Combo Button \param[in]       key_id: key_id
@@ -442,6 +1812,15 @@ void ebtn_combo_btn_add_btn(ebtn_btn_combo_t *btn, uint16_t key_id);
  */
 void ebtn_combo_btn_remove_btn(ebtn_btn_combo_t *btn, uint16_t key_id);
 
+/**
+ * \brief           Remove combo-button key with key_id of a specific button group.
+ * \param[in]       ebtobj: Button group instance
+ * \param[in]       btn: Combo Button
+ * \param[in]       key_id: key_id
+ *
+ */
+void ebtn_combo_btn_remove_btn_ex(ebtn_t *ebtobj, ebtn_btn_combo_t *btn, uint16_t key_id);
+
 /**
  * \brief           Get keep alive period for specific button
  * \param[in]       btn: Button instance to get keep alive period for
@@ -0,0 +1,237 @@
+#include <string.h>
+#include "ebtn_matrix.h"
+
+#define EBTN_MATRIX_SCAN_PERIOD_DEFAULT (5) /*!< Default scan period in ms */
+
+/**
+ * \brief           Get up to 32 bits from any position of a bitmap
+ *
+ * \param[in]       bits: Bitmap
+ * \param[in]       start: First bit
+ * \param[in]       num: Number of bits, `1` to `32`
+ * \return          Bits, bit `0` is bit start of bitmap
+ */
+static uint32_t prv_matrix_get_bits(const bit_array_t *bits, int start, int num)
+{
+    int word = BIT_ARRAY_BIT_WORD(start);
+    int offset = BIT_ARRAY_BIT_INDEX(start);
+    bit_array_val_t val = bits[word] >> offset;
+
+    if (offset + num > (int)BIT_ARRAY_BITS)
+    {
+        val |= bits[word + 1] << (BIT_ARRAY_BITS - offset);
+    }
+
+    return (uint32_t)(val & BIT_ARRAY_SUB_MASK(num));
+}
+
+/**
+ * \brief           Set up to 32 bits at any position of a bitmap, other bits are not changed
+ *
+ * \param[in]       bits: Bitmap
+ * \param[in]       start: First bit
+ * \param[in]       num: Number of bits, `1` to `32`
+ * \param[in]       val: Bits, bit `0` is set to bit start of bitmap
+ */
+static void prv_matrix_put_bits(bit_array_t *bits, int start, int num, uint32_t val)
+{
+    int word = BIT_ARRAY_BIT_WORD(start);
+    int offset = BIT_ARRAY_BIT_INDEX(start);
+    bit_array_val_t mask = BIT_ARRAY_SUB_MASK(num);
+    bit_array_val_t v = (bit_array_val_t)val & mask;
+
+    bits[word] = (bits[word] & ~(mask << offset)) | (v << offset);
+    if (offset + num > (int)BIT_ARRAY_BITS)
+    {
+        int shift = BIT_ARRAY_BITS - offset;
+        bits[word + 1] = (bits[word + 1] & ~(mask >> shift)) | (v >> shift);
+    }
+}
+
+/**
+ * \brief           Find ambiguous keys of rectangles of active keys
+ *
+ * \param[in]       matrix: Matrix instance
+ * \return          `1` if some key is ambiguous, `0` otherwise
+ */
+static int prv_matrix_find_ghost(ebtn_matrix_t *matrix)
+{
+    uint32_t *raw = matrix->raw;
+    uint32_t *ghost = matrix->ghost;
+    uint32_t shared;
+    int found = 0;
+
+    memset(ghost, 0x00, sizeof(uint32_t) * matrix->rows);
+
+    for (uint16_t i = 0; i < matrix->rows; i++)
+    {
+        /* Row with less than 2 active columns is not a side of any rectangle */
+        if ((raw[i] & (raw[i] - 1)) == 0)
+        {
+            continue;
+        }
+
+        for (uint16_t j = i + 1; j < matrix->rows; j++)
+        {
+            shared = raw[i] & raw[j];
+            if (shared & (shared - 1))
+            {
+                ghost[i] |= shared;
+                ghost[j] |= shared;
+                found = 1;
+            }
+        }
+    }
+
+    return found;
+}
+
+static int prv_matrix_is_in_process(ebtn_matrix_t *matrix)
+{
+    if (matrix->ebtobj == NULL)
+    {
+        return ebtn_is_in_process();
+    }
+    return ebtn_is_in_process_ex(matrix->ebtobj);
+}
+
+static int prv_matrix_get_deadline(ebtn_matrix_t *matrix, ebtn_time_t mstime, ebtn_time_t *deadline)
+{
+    if (matrix->ebtobj == NULL)
+    {
+        return ebtn_get_next_deadline(mstime, deadline);
+    }
+    return ebtn_get_next_deadline_ex(matrix->ebtobj, mstime, deadline);
+}
+
+static void prv_matrix_process(ebtn_matrix_t *matrix, ebtn_time_t mstime)
+{
+    if (matrix->ebtobj == NULL)
+    {
+        ebtn_process_with_curr_state(matrix->curr_state, mstime);
+        return;
+    }
+    ebtn_process_with_curr_state_ex(matrix->ebtobj, matrix->curr_state, mstime);
+}
+
+static uint16_t prv_matrix_get_period(ebtn_matrix_t *matrix)
+{
+    for (uint16_t i = 0; i < matrix->rows; i++)
+    {
+        if (matrix->raw[i])
+        {
+            return matrix->scan_period;
+        }
+    }
+
+    return prv_matrix_is_in_process(matrix) ? matrix->scan_period : matrix->scan_period_idle;
+}
+
+int ebtn_matrix_init(ebtn_matrix_t *matrix, ebtn_t *ebtobj, bit_array_t *curr_state, uint16_t key_idx_base, uint16_t rows, uint8_t cols,
+                     uint32_t *storage, ebtn_matrix_select_fn select_fn, ebtn_matrix_read_fn read_fn)
+{
+    if (matrix == NULL || curr_state == NULL || storage == NULL || select_fn == NULL || read_fn == NULL || rows == 0 || cols == 0 ||
+        cols > EBTN_MATRIX_MAX_COLS)
+    {
+        return 0;
+    }
+
+    memset(matrix, 0x00, sizeof(*matrix));
+    matrix->ebtobj = ebtobj;
+    matrix->curr_state = curr_state;
+    matrix->select_fn = select_fn;
+    matrix->read_fn = read_fn;
+    matrix->raw = storage;
+    matrix->ghost = storage + rows;
+    matrix->key_idx_base = key_idx_base;
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->scan_period = EBTN_MATRIX_SCAN_PERIOD_DEFAULT;
+    matrix->scan_period_idle = EBTN_MATRIX_SCAN_PERIOD_DEFAULT;
+    memset(storage, 0x00, sizeof(uint32_t) * 2 * rows);
+
+    return 1;
+}
+
+void ebtn_matrix_set_scan_rate(ebtn_matrix_t *matrix, uint16_t scan_period, uint16_t scan_period_idle)
+{
+    matrix->scan_period = scan_period;
+    matrix->scan_period_idle = scan_period_idle;
+}
+
+int ebtn_matrix_scan(ebtn_matrix_t *matrix)
+{
+    uint32_t col_mask = matrix->cols == 32 ? 0xFFFFFFFF : ((uint32_t)1 << matrix->cols) - 1;
+    int start = matrix->key_idx_base;
+    uint32_t prev;
+
+    for (uint16_t i = 0; i < matrix->rows; i++)
+    {
+        matrix->select_fn(matrix, i);
+        matrix->raw[i] = matrix->read_fn(matrix, i) & col_mask;
+    }
+    matrix->select_fn(matrix, EBTN_MATRIX_ROW_NONE);
+
+    matrix->ghosting = !(matrix->flags & EBTN_MATRIX_FLAG_NO_GHOST) && prv_matrix_find_ghost(matrix);
+    if (matrix->ghosting)
+    {
+        matrix->ghost_scans++;
+    }
+
+    for (uint16_t i = 0; i < matrix->rows; i++, start += matrix->cols)
+    {
+        if (matrix->ghosting && matrix->ghost[i])
+        {
+            /* Ambiguous keys keep state of last scan */
+            prev = prv_matrix_get_bits(matrix->curr_state, start, matrix->cols);
+            prv_matrix_put_bits(matrix->curr_state, start, matrix->cols, (matrix->raw[i] & ~matrix->ghost[i]) | (prev & matrix->ghost[i]));
+        }
+        else
+        {
+            prv_matrix_put_bits(matrix->curr_state, start, matrix->cols, matrix->raw[i]);
+        }
+    }
+
+    return matrix->ghosting;
+}
+
+int ebtn_matrix_poll(ebtn_matrix_t *matrix, ebtn_time_t mstime)
+{
+    ebtn_time_t deadline;
+
+    if (!matrix->scanned || (ebtn_time_sign_t)(mstime - matrix->last_scan) >= (ebtn_time_sign_t)prv_matrix_get_period(matrix))
+    {
+        ebtn_matrix_scan(matrix);
+        matrix->last_scan = mstime;
+        matrix->scanned = 1;
+        prv_matrix_process(matrix, mstime);
+        return 1;
+    }
+
+    /* No input change between scans, only timeout of buttons */
+    if (prv_matrix_get_deadline(matrix, mstime, &deadline) && (ebtn_time_sign_t)(deadline - mstime) <= 0)
+    {
+        prv_matrix_process(matrix, mstime);
+        return 1;
+    }
+
+    return 0;
+}
+
+ebtn_time_t ebtn_matrix_get_next_time(ebtn_matrix_t *matrix, ebtn_time_t mstime)
+{
+    ebtn_time_t next, deadline;
+
+    if (!matrix->scanned)
+    {
+        return mstime;
+    }
+
+    next = matrix->last_scan + prv_matrix_get_period(matrix);
+    if (prv_matrix_get_deadline(matrix, mstime, &deadline) && (ebtn_time_sign_t)(deadline - next) < 0)
+    {
+        next = deadline;
+    }
+
+    return next;
+}
@@ -0,0 +1,131 @@
+#ifndef _EBTN_MATRIX_H
+#define _EBTN_MATRIX_H
+
+#include <stdint.h>
+
+#include "ebtn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define EBTN_MATRIX_MAX_COLS (32)     /*!< Max number of columns, columns of a row are read as one 32 bits word */
+#define EBTN_MATRIX_ROW_NONE (0xFFFF) /*!< Row passed to select function after scan, release all rows */
+
+#define EBTN_MATRIX_FLAG_NO_GHOST ((uint8_t)0x01) /*!< Matrix has diode on every key, skip ghost detection */
+
+/**
+ * \brief           Define matrix storage of raw and ambiguous column bits of every row
+ * \param[in]       name: Storage name
+ * \param[in]       rows: Number of rows
+ */
+#define EBTN_MATRIX_STORAGE_DEFINE(name, rows) uint32_t name[2 * (rows)]
+
+struct ebtn_matrix;
+
+/**
+ * \brief           Drive one row of the matrix active, all other rows inactive
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       row: Row to select, `EBTN_MATRIX_ROW_NONE` to release all rows after scan
+ */
+typedef void (*ebtn_matrix_select_fn)(struct ebtn_matrix *matrix, uint16_t row);
+
+/**
+ * \brief           Read all columns of the selected row
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       row: Selected row
+ * \return          Column bits, bit `n` is `1` when key of column `n` is active
+ */
+typedef uint32_t (*ebtn_matrix_read_fn)(struct ebtn_matrix *matrix, uint16_t row);
+
+/**
+ * \brief           Keyboard matrix scanner.
+ * Key of row `r` and column `c` is key_idx `key_idx_base + r * cols + c` of the button group,
+ * so buttons of the matrix are defined row by row in the button array.
+ *
+ * Without diode on every key, three active corners of a rectangle make the fourth one read active too.
+ * Any two rows sharing two or more active columns form such a rectangle, keys of these columns of both rows are
+ * ambiguous and keep the state of last scan until the rectangle is gone.
+ */
+typedef struct ebtn_matrix
+{
+    ebtn_t *ebtobj;                  /*!< Button group, `NULL` for default group */
+    bit_array_t *curr_state;         /*!< Current state of button group, matrix keys are written by scan */
+    ebtn_matrix_select_fn select_fn; /*!< Row select function */
+    ebtn_matrix_read_fn read_fn;     /*!< Column read function */
+    uint32_t *raw;                   /*!< Raw column bits of every row of last scan */
+    uint32_t *ghost;                 /*!< Ambiguous column bits of every row of last scan */
+    uint16_t key_idx_base;           /*!< key_idx of row 0 column 0 */
+    uint16_t rows;                   /*!< Number of rows */
+    uint8_t cols;                    /*!< Number of columns, max is `EBTN_MATRIX_MAX_COLS` */
+    uint8_t flags;                   /*!< Matrix flags, `EBTN_MATRIX_FLAG_*` */
+    uint8_t scanned;                 /*!< Flag indicates that last_scan is valid */
+    uint8_t ghosting;                /*!< Flag indicates that last scan has ambiguous keys */
+    uint16_t scan_period;            /*!< Scan period in ms when some key is active or button is in process */
+    uint16_t scan_period_idle;       /*!< Scan period in ms when all keys are released and buttons idle */
+    ebtn_time_t last_scan;           /*!< Time of last scan */
+    uint32_t ghost_scans;            /*!< Number of scans with ambiguous keys */
+} ebtn_matrix_t;
+
+/**
+ * \brief           Initialize keyboard matrix scanner
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       ebtobj: Button group, `NULL` for default group
+ * \param[in]       curr_state: Current state bitmap of button group, keys out of matrix keep their bits
+ * \param[in]       key_idx_base: key_idx of row 0 column 0
+ * \param[in]       rows: Number of rows
+ * \param[in]       cols: Number of columns, max is `EBTN_MATRIX_MAX_COLS`
+ * \param[in]       storage: Storage defined by `EBTN_MATRIX_STORAGE_DEFINE(name, rows)`
+ * \param[in]       select_fn: Row select function
+ * \param[in]       read_fn: Column read function
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_matrix_init(ebtn_matrix_t *matrix, ebtn_t *ebtobj, bit_array_t *curr_state, uint16_t key_idx_base, uint16_t rows, uint8_t cols,
+                     uint32_t *storage, ebtn_matrix_select_fn select_fn, ebtn_matrix_read_fn read_fn);
+
+/**
+ * \brief           Set scan rate of matrix, default is 5ms for both
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       scan_period: Scan period in ms when some key is active or button is in process
+ * \param[in]       scan_period_idle: Scan period in ms when all keys are released and buttons idle, slower for low power
+ */
+void ebtn_matrix_set_scan_rate(ebtn_matrix_t *matrix, uint16_t scan_period, uint16_t scan_period_idle);
+
+/**
+ * \brief           Scan all rows and write matrix keys to curr_state, with ambiguous keys masked.
+ * Button group is not processed.
+ *
+ * \param[in]       matrix: Matrix instance
+ * \return          `1` if some key is ambiguous, `0` otherwise
+ */
+int ebtn_matrix_scan(ebtn_matrix_t *matrix);
+
+/**
+ * \brief           Scan the matrix when scan period passed and process button group with ebtn_process_with_curr_state_ex().
+ * Between scans, button group is only processed when some button timeout is due.
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       mstime: Current system time in milliseconds
+ * \return          `1` if button group is processed, `0` otherwise
+ */
+int ebtn_matrix_poll(ebtn_matrix_t *matrix, ebtn_time_t mstime);
+
+/**
+ * \brief           Get time matrix need to be polled again, next scan or button timeout, whichever is earlier.
+ * Used for tickless processing.
+ *
+ * \param[in]       matrix: Matrix instance
+ * \param[in]       mstime: Current system time in milliseconds
+ * \return          Absolute time in milliseconds of next poll
+ */
+ebtn_time_t ebtn_matrix_get_next_time(ebtn_matrix_t *matrix, ebtn_time_t mstime);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _EBTN_MATRIX_H */
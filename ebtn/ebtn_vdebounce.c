@@ -0,0 +1,186 @@
+#include <string.h>
+#include "ebtn_vdebounce.h"
+
+#ifdef EBTN_CONFIG_SIMD
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EBTN_SIMD_HAVE_X86
+#include <immintrin.h>
+#endif
+#endif
+
+/**
+ * \brief           Count one sample of the lines of a word
+ *
+ * \param[in]       vd: Debounce instance
+ * \param[in]       w: Word index
+ * \param[in]       raw: Raw input of the lines of the word
+ * \return          Lines whose stable state toggled
+ */
+static bit_array_val_t prv_vdebounce_word(ebtn_vdebounce_t *vd, int w, bit_array_val_t raw)
+{
+    bit_array_val_t delta = raw ^ vd->stable[w];
+    bit_array_val_t carry = delta;
+    bit_array_val_t *cnt = &vd->cnt[w];
+
+    /* Increment counters of lines differ from stable state, clear others, carry out of last plane is overflow */
+    for (int p = 0; p < vd->planes; p++, cnt += vd->words)
+    {
+        bit_array_val_t c = *cnt;
+        *cnt = (c ^ carry) & delta;
+        carry &= c;
+    }
+    vd->stable[w] ^= carry;
+
+    return carry;
+}
+
+static bit_array_val_t prv_vdebounce_kernel_scalar(ebtn_vdebounce_t *vd, const bit_array_t *raw, int words)
+{
+    bit_array_val_t changed = 0;
+
+    for (int w = 0; w < words; w++)
+    {
+        changed |= prv_vdebounce_word(vd, w, raw[w]);
+    }
+    return changed;
+}
+
+#ifdef EBTN_SIMD_HAVE_X86
+#define EBTN_VDEBOUNCE_SSE2_WORDS ((int)(16 / sizeof(bit_array_val_t))) /*!< Words of one 128 bits vector */
+#define EBTN_VDEBOUNCE_AVX2_WORDS ((int)(32 / sizeof(bit_array_val_t))) /*!< Words of one 256 bits vector */
+
+__attribute__((target("sse2"))) static bit_array_val_t prv_vdebounce_kernel_sse2(ebtn_vdebounce_t *vd, const bit_array_t *raw, int words)
+{
+    __m128i changed = _mm_setzero_si128();
+    bit_array_val_t out[EBTN_VDEBOUNCE_SSE2_WORDS];
+    bit_array_val_t res = 0;
+    int w = 0;
+
+    for (; w + EBTN_VDEBOUNCE_SSE2_WORDS <= words; w += EBTN_VDEBOUNCE_SSE2_WORDS)
+    {
+        __m128i *stable = (__m128i *)&vd->stable[w];
+        __m128i delta = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&raw[w]), _mm_loadu_si128(stable));
+        __m128i carry = delta;
+        bit_array_t *cnt = &vd->cnt[w];
+
+        for (int p = 0; p < vd->planes; p++, cnt += vd->words)
+        {
+            __m128i c = _mm_loadu_si128((const __m128i *)cnt);
+            _mm_storeu_si128((__m128i *)cnt, _mm_and_si128(_mm_xor_si128(c, carry), delta));
+            carry = _mm_and_si128(carry, c);
+        }
+        _mm_storeu_si128(stable, _mm_xor_si128(_mm_loadu_si128(stable), carry));
+        changed = _mm_or_si128(changed, carry);
+    }
+
+    _mm_storeu_si128((__m128i *)out, changed);
+    for (int i = 0; i < EBTN_VDEBOUNCE_SSE2_WORDS; i++)
+    {
+        res |= out[i];
+    }
+    for (; w < words; w++)
+    {
+        res |= prv_vdebounce_word(vd, w, raw[w]);
+    }
+    return res;
+}
+
+__attribute__((target("avx2"))) static bit_array_val_t prv_vdebounce_kernel_avx2(ebtn_vdebounce_t *vd, const bit_array_t *raw, int words)
+{
+    __m256i changed = _mm256_setzero_si256();
+    bit_array_val_t out[EBTN_VDEBOUNCE_AVX2_WORDS];
+    bit_array_val_t res = 0;
+    int w = 0;
+
+    for (; w + EBTN_VDEBOUNCE_AVX2_WORDS <= words; w += EBTN_VDEBOUNCE_AVX2_WORDS)
+    {
+        __m256i *stable = (__m256i *)&vd->stable[w];
+        __m256i delta = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&raw[w]), _mm256_loadu_si256(stable));
+        __m256i carry = delta;
+        bit_array_t *cnt = &vd->cnt[w];
+
+        for (int p = 0; p < vd->planes; p++, cnt += vd->words)
+        {
+            __m256i c = _mm256_loadu_si256((const __m256i *)cnt);
+            _mm256_storeu_si256((__m256i *)cnt, _mm256_and_si256(_mm256_xor_si256(c, carry), delta));
+            carry = _mm256_and_si256(carry, c);
+        }
+        _mm256_storeu_si256(stable, _mm256_xor_si256(_mm256_loadu_si256(stable), carry));
+        changed = _mm256_or_si256(changed, carry);
+    }
+
+    _mm256_storeu_si256((__m256i *)out, changed);
+    for (int i = 0; i < EBTN_VDEBOUNCE_AVX2_WORDS; i++)
+    {
+        res |= out[i];
+    }
+    for (; w < words; w++)
+    {
+        res |= prv_vdebounce_word(vd, w, raw[w]);
+    }
+    return res;
+}
+#endif
+
+int ebtn_vdebounce_init(ebtn_vdebounce_t *vd, bit_array_t *storage, int num_bits, uint8_t samples)
+{
+    int planes = 0;
+
+    if (vd == NULL || storage == NULL || num_bits <= 0 || samples < 2 || (samples & (samples - 1)) != 0)
+    {
+        return 0;
+    }
+    while ((1 << planes) < samples)
+    {
+        planes++;
+    }
+    if (planes > EBTN_VDEBOUNCE_MAX_PLANES)
+    {
+        return 0;
+    }
+
+    memset(vd, 0x00, sizeof(*vd));
+    vd->num_bits = num_bits;
+    vd->words = BIT_ARRAY_BITMAP_SIZE(num_bits);
+    vd->planes = planes;
+#ifdef EBTN_CONFIG_SIMD
+    vd->kernel = (uint8_t)ebtn_simd_get();
+#endif
+    vd->stable = storage;
+    vd->cnt = storage + vd->words;
+    memset(storage, 0x00, sizeof(bit_array_t) * (1 + planes) * vd->words);
+
+    return 1;
+}
+
+int ebtn_vdebounce_update(ebtn_vdebounce_t *vd, const bit_array_t *raw)
+{
+    int tail = vd->num_bits % BIT_ARRAY_BITS;
+    int full = vd->words - (tail ? 1 : 0);
+    bit_array_val_t changed;
+
+#if defined(EBTN_CONFIG_SIMD) && defined(EBTN_SIMD_HAVE_X86)
+    switch (vd->kernel)
+    {
+        case EBTN_SIMD_AVX2:
+            changed = prv_vdebounce_kernel_avx2(vd, raw, full);
+            break;
+        case EBTN_SIMD_SSE2:
+            changed = prv_vdebounce_kernel_sse2(vd, raw, full);
+            break;
+        default:
+            changed = prv_vdebounce_kernel_scalar(vd, raw, full);
+            break;
+    }
+#else
+    changed = prv_vdebounce_kernel_scalar(vd, raw, full);
+#endif
+
+    /* Lines over num_bits are never active */
+    if (tail)
+    {
+        changed |= prv_vdebounce_word(vd, full, raw[full] & BIT_ARRAY_SUB_MASK(tail));
+    }
+
+    return changed != 0;
+}
@@ -0,0 +1,76 @@
+#ifndef _EBTN_VDEBOUNCE_H
+#define _EBTN_VDEBOUNCE_H
+
+#include <stdint.h>
+
+#include "ebtn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define EBTN_VDEBOUNCE_MAX_PLANES (4) /*!< Max number of counter bit planes, max samples is `1 << EBTN_VDEBOUNCE_MAX_PLANES` */
+
+/**
+ * \brief           Define vertical counter storage of stable state and counter planes
+ * \param[in]       name: Storage name
+ * \param[in]       num_bits: Number of input lines
+ */
+#define EBTN_VDEBOUNCE_STORAGE_DEFINE(name, num_bits) bit_array_t name[(1 + EBTN_VDEBOUNCE_MAX_PLANES) * BIT_ARRAY_BITMAP_SIZE(num_bits)]
+
+/**
+ * \brief           Vertical counter debounce of a raw input bitmap.
+ * Every line has a counter of `planes` bits, bit `n` of all counters of a word is kept in word of plane `n`,
+ * so lines of a whole word are counted by a few bitwise operations per sample.
+ * A counter counts consecutive samples differ from stable state, and is cleared by a sample equal to stable state,
+ * stable state of the line toggles when `1 << planes` consecutive samples differ.
+ *
+ * Stable bitmap feeds ebtn_process_with_curr_state_ex(), debounce time is samples multiplied by scan period,
+ * so time_debounce and time_debounce_release of buttons are usually set to `0`.
+ */
+typedef struct ebtn_vdebounce
+{
+    bit_array_t *stable; /*!< Debounced state, `1` means active */
+    bit_array_t *cnt;    /*!< Counter planes, plane `n` is `cnt[n * words]` */
+    int num_bits;        /*!< Number of input lines */
+    uint16_t words;      /*!< Number of words of every bitmap */
+    uint8_t planes;      /*!< Number of counter bit planes */
+#ifdef EBTN_CONFIG_SIMD
+    uint8_t kernel; /*!< Kernel of ebtn_simd_get() at init, \ref ebtn_simd_kernel_t */
+#endif
+} ebtn_vdebounce_t;
+
+/**
+ * \brief           Initialize vertical counter debounce, all lines are stable inactive
+ *
+ * \param[in]       vd: Debounce instance
+ * \param[in]       storage: Storage defined by `EBTN_VDEBOUNCE_STORAGE_DEFINE(name, num_bits)`
+ * \param[in]       num_bits: Number of input lines
+ * \param[in]       samples: Number of consecutive equal samples to change stable state, `2`, `4`, `8` or `16`
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_vdebounce_init(ebtn_vdebounce_t *vd, bit_array_t *storage, int num_bits, uint8_t samples);
+
+/**
+ * \brief           Count one sample of all lines.
+ * With `EBTN_CONFIG_SIMD`, AVX2 or SSE2 kernel selected by ebtn_simd_select() before ebtn_vdebounce_init() counts 256 or 128 lines per step.
+ *
+ * \param[in]       vd: Debounce instance
+ * \param[in]       raw: Raw input bitmap of num_bits lines
+ * \return          `1` if stable state of some line changed, `0` otherwise
+ */
+int ebtn_vdebounce_update(ebtn_vdebounce_t *vd, const bit_array_t *raw);
+
+/**
+ * \brief           Get debounced state bitmap, to be passed to ebtn_process_with_curr_state_ex()
+ *
+ * \param[in]       vd: Debounce instance
+ * \return          Stable state bitmap
+ */
+#define ebtn_vdebounce_get_state(vd) ((vd)->stable)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _EBTN_VDEBOUNCE_H */
@@ -1,10 +1,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifdef _WIN32
 #include "windows.h"
+#endif
 
 #include "ebtn.h"
 
+#ifndef _WIN32
+#define FOREGROUND_BLUE  (0x01)
+#define FOREGROUND_GREEN (0x02)
+#define FOREGROUND_RED   (0x04)
+#endif
+
+/* Set console text color, FOREGROUND_xxx combination */
+static void test_set_color(uint32_t color)
+{
+#ifdef _WIN32
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), (WORD)color);
+#else
+    /* ANSI color bit order is red, green, blue */
+    printf("\033[%um", 30 + ((color & FOREGROUND_RED) ? 1 : 0) + ((color & FOREGROUND_GREEN) ? 2 : 0) + ((color & FOREGROUND_BLUE) ? 4 : 0));
+#endif
+}
+
 //
 // Tests
 //
@@ -100,7 +119,7 @@ typedef struct
         .test_events_cnt = EBTN_ARRAY_SIZE(_evt), .test_events = _evt                                                                                          \
     }
 
-/* Max number of ms to demonstrate */
+/* Max number of ms to simulate after the input sequence */
 #define MAX_TIME_MS 0x3FFFF
 
 #define EBTN_PARAM_TIME_DEBOUNCE_PRESS(_param)   _param.time_debounce
@@ -548,6 +567,17 @@ static const btn_test_evt_t test_events_keep_alive_0[] = {
         BTN_EVENT_ONCLICK(1),
 };
 
+/* Hold for one hour, simulated time jumps between input edges and button deadlines */
+static btn_test_time_t test_sequence_keep_alive_0_hold_hour[] = {
+        BTN_STATE_RAW(USER_BUTTON_keep_alive_0, 1, 60UL * 60UL * 1000UL),
+        BTN_STATE_RAW(USER_BUTTON_keep_alive_0, 0, EBTN_PARAM_TIME_DEBOUNCE_RELEASE(param_keep_alive_0) + EBTN_PARAM_TIME_CLICK_MULTI_MAX(param_keep_alive_0)),
+};
+
+static const btn_test_evt_t test_events_keep_alive_0_hold_hour[] = {
+        BTN_EVENT_ONPRESS(),
+        BTN_EVENT_ONRELEASE(),
+};
+
 static btn_test_arr_t test_list[] = {
         TEST_ARRAY_DEFINE(USER_BUTTON_default, test_sequence_single_click, test_events_single_click),
         TEST_ARRAY_DEFINE(USER_BUTTON_default, test_sequence_double_click, test_events_double_click),
@@ -577,38 +607,59 @@ static btn_test_arr_t test_list[] = {
         TEST_ARRAY_DEFINE(USER_BUTTON_click_multi_max_0, test_sequence_click_multi_max_0, test_events_click_multi_max_0),
 
         TEST_ARRAY_DEFINE(USER_BUTTON_keep_alive_0, test_sequence_keep_alive_0, test_events_keep_alive_0),
+        TEST_ARRAY_DEFINE(USER_BUTTON_keep_alive_0, test_sequence_keep_alive_0_hold_hour, test_events_keep_alive_0_hold_hour),
 };
 
 static btn_test_arr_t *select_test_item;
 
-/* Get button state for given current time */
-static uint8_t prv_get_state_for_time(uint16_t key_id, uint32_t time)
+/* Input sequence cursor of the simulation, time only goes forward */
+static int test_sequence_index;
+static uint32_t test_sequence_end; /* Last time of the state of test_sequence_index */
+
+static void test_sequence_reset(void)
 {
-    uint8_t state = 0;
-    uint32_t duration = 0;
+    test_sequence_index = -1;
+    test_sequence_end = 0;
+}
 
-    if (select_test_item->test_key_id == key_id)
+/* Move the cursor to the state of given time, `0` when time is after the whole sequence */
+static int test_sequence_seek(uint32_t time)
+{
+    while (test_sequence_index < 0 || time > test_sequence_end)
     {
-        // printf("time: %d, key_id: %d\n", time, key_id);
-        for (size_t i = 0; i < select_test_item->test_sequence_cnt; ++i)
+        do
         {
-            if (select_test_item->test_sequence[i].duration == 0)
-            {
-                continue;
-            }
-            duration += select_test_item->test_sequence[i].duration + 1; /* Advance time, need add 1 for state switch time. */
-            // printf("i: %d, duration: %d\n", i, duration);
-            if (time <= duration)
+            if (++test_sequence_index >= select_test_item->test_sequence_cnt)
             {
-                state = select_test_item->test_sequence[i].state;
-                // printf("i: %d, time: %d, duration: %d, state: %d\n", i, time, duration, state);
-                // printf("state: %d\n", state);
-                break;
+                test_sequence_index = select_test_item->test_sequence_cnt;
+                return 0;
             }
-        }
+        } while (select_test_item->test_sequence[test_sequence_index].duration == 0);
+        /* Advance time, need add 1 for state switch time. */
+        test_sequence_end += select_test_item->test_sequence[test_sequence_index].duration + 1;
     }
+    return 1;
+}
 
-    return state;
+/* Get button state for given current time */
+static uint8_t prv_get_state_for_time(uint16_t key_id, uint32_t time)
+{
+    if (select_test_item->test_key_id != key_id || !test_sequence_seek(time))
+    {
+        return 0;
+    }
+    return select_test_item->test_sequence[test_sequence_index].state;
+}
+
+/* Get next time input may change after given time, `0` when input never changes again */
+static int test_sequence_next_edge(uint32_t time, uint32_t *next)
+{
+    if (!test_sequence_seek(time))
+    {
+        return 0;
+    }
+    *next = test_sequence_end + 1;
+    return 1;
 }
 
 static uint32_t test_get_state_total_duration(void)
@@ -644,13 +695,12 @@ static void prv_btn_event(struct ebtn_btn *btn, ebtn_evt_t evt)
     const char *s;
     uint32_t color, keepalive_cnt = 0, diff_time;
     const btn_test_evt_t *test_evt_data = NULL;
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 
     if (test_processed_array_index >= select_test_item->test_events_cnt)
     {
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED);
+        test_set_color(FOREGROUND_RED);
         printf("[%7u] ERROR! Array index is out of bounds!\r\n", (unsigned)test_processed_time_current);
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+        test_set_color(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
     }
     else
     {
@@ -696,16 +746,65 @@ static void prv_btn_event(struct ebtn_btn *btn, ebtn_evt_t evt)
         color = FOREGROUND_RED;
     }
 
-    SetConsoleTextAttribute(hConsole, color);
+    test_set_color(color);
     printf("[%7u][%6u] ID(hex):%4x, evt:%10s, keep-alive cnt: %3u, click cnt: %3u\r\n", (unsigned)test_processed_time_current, (unsigned)diff_time, btn->key_id,
            s, (unsigned)keepalive_cnt, (unsigned)btn->click_cnt);
 
-    SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+    test_set_color(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
     ++test_processed_array_index; /* Go to next step in next event */
 }
 
+/* Check button idle once all events are sent and input sequence is over */
+static void test_check_idle(uint32_t time, uint32_t duration)
+{
+    if (test_processed_array_index >= select_test_item->test_events_cnt && time > duration + 1)
+    {
+        ASSERT(!ebtn_is_btn_in_process(ebtn_get_btn_by_key_id(select_test_item->test_key_id)));
+        ASSERT(!ebtn_is_in_process());
+    }
+}
+
+/*
+ * Simulate with virtual time, which jumps directly to the next input edge or button deadline,
+ * other milliseconds have no input change and no timeout, so processing them has no effect.
+ */
+static void test_simulate(void)
+{
+    uint32_t duration = test_get_state_total_duration();
+    uint32_t time = 0, time_end = duration + MAX_TIME_MS;
+    uint32_t next, next_edge;
+    ebtn_time_t deadline;
+    int has_edge, has_deadline;
+
+    test_sequence_reset();
+    while (time < time_end)
+    {
+        test_processed_time_current = time; /* Set current time used in callback */
+        ebtn_process(time);                 /* Now run processing */
+        test_check_idle(time, duration);
+
+        has_edge = test_sequence_next_edge(time, &next_edge);
+        has_deadline = ebtn_get_next_deadline(time, &deadline);
+        if (!has_edge && !has_deadline)
+        {
+            break; /* Nothing will happen any more */
+        }
+
+        /* Deadline is ebtn_time_t, may be 16 bits */
+        next = has_deadline ? time + (ebtn_time_t)(deadline - (ebtn_time_t)time) : next_edge;
+        if (has_edge && next_edge < next)
+        {
+            next = next_edge;
+        }
+        time = next > time ? next : time + 1;
+    }
+    test_check_idle(time_end, duration);
+}
+
 /**
  * \brief           Test function
+ *
+ * \return          `0` if all tests pass, `1` otherwise
  */
 int example_test(void)
 {
@@ -726,30 +825,13 @@ int example_test(void)
         /* Define buttons */
         ebtn_init(btns, EBTN_ARRAY_SIZE(btns), NULL, 0, prv_btn_get_state, prv_btn_event);
 
-        /* Counter simulates ms tick */
-        for (uint32_t i = 0; i < MAX_TIME_MS; ++i)
-        {
-            test_processed_time_current = i; /* Set current time used in callback */
-            ebtn_process(i);                 /* Now run processing */
-
-            // printf("time: %d, end: %d, in_process(): %d/%d\n", i, test_processed_array_index >= select_test_item->test_events_cnt
-            //     , ebtn_is_btn_in_process(ebtn_get_btn_by_key_id(select_test_item->test_key_id)), ebtn_is_in_process());
-            // check end
-            if (test_processed_array_index >= select_test_item->test_events_cnt)
-            {
-                uint32_t duration = test_get_state_total_duration();
-                if (i > duration + 1)
-                {
-                    ASSERT(!ebtn_is_btn_in_process(ebtn_get_btn_by_key_id(select_test_item->test_key_id)));
-                    ASSERT(!ebtn_is_in_process());
-                }
-            }
-        }
+        test_simulate();
         ASSERT(test_processed_array_index == select_test_item->test_events_cnt);
 
         // printf("\n");
 
         SUITE_END();
     }
-    return 0;
+    printf("%d suites, %d failed, %d asserts, %d failed\r\n", suites_run, suites_failed, tests_run, tests_failed);
+    return tests_failed != 0;
 }
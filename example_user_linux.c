@@ -1,19 +1,19 @@
+#define _GNU_SOURCE /* usleep, clock_gettime with -std=c99 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <sys/time.h>
 #include <termios.h>
 #include "ebtn.h"
+#include "ebtn_evdev.h"
+#include "ebtn_runtime.h"
 #include <unistd.h>
 #include <fcntl.h>
 #include <linux/input.h>
-#include <pthread.h>
 #include <stdatomic.h>
 #include <errno.h>      // 新增：用于错误处理
 #include <string.h>     // 新增：用于字符串操作
 #include <sys/types.h>  // 新增：系统类型定义
-#include "libscl/SCL_map.h"
-SCL_map_t   btn_info_map;
 #define KEY_DEVICE "/dev/input/event1"  // 按键设备节点
 static uint32_t get_tick(void);
 typedef enum
@@ -38,103 +38,15 @@ typedef enum
     USER_BUTTON_COMBO_MAX,
 } user_button_t;
 static struct termios old_termios;
-typedef struct key_btn_info_t
-{
-    int key_value;
-    char key_status;
-}key_btn_info_t;
-user_button_t get_key_input(void) {
-	static int fd = -1;
-	struct input_event ev;
-	ssize_t n;
-
-	// 首次调用时打开设备
-	if (fd < 0) {
-		printf("Trying to open input device %s\n", KEY_DEVICE);
-		fd = open(KEY_DEVICE, O_RDONLY);
-		if (fd < 0) {
-			perror("Failed to open input device");
-			return USER_BUTTON_INVALID;
-		}
-		printf("Successfully opened input device %s\n", KEY_DEVICE);
-	}
-
-	// 读取输入事件
-	n = read(fd, &ev, sizeof(ev));
-	if (n == -1) {
-		if (errno != EAGAIN) {
-			perror("Error reading input device");
-			close(fd);
-			fd = -1;
-		}
-		return USER_BUTTON_INVALID;
-	}
-	else if (n != sizeof(ev)) {
-		fprintf(stderr, "Read incomplete input event (%zd bytes)\n", n);
-		return USER_BUTTON_INVALID;
-	}
-
-	// printf("Input event: type=%d code=%d value=%d\n", ev.type, ev.code, ev.value);
-    int key_value = USER_BUTTON_INVALID;
-    int key_status = 0;
-	if (ev.type == EV_KEY) {
-        key_status = ev.value;
-        switch (ev.code) {
-            case KEY_0:
-                key_value = USER_BUTTON_0;
-                break;
-            case KEY_1:
-                key_value = USER_BUTTON_1;
-                break;
-            case KEY_2:
-                key_value = USER_BUTTON_2;
-                break;
-            case KEY_3:
-                key_value = USER_BUTTON_3;
-                break;
-            case KEY_4:
-                key_value = USER_BUTTON_4;
-                break;
-            case KEY_5:
-                key_value = USER_BUTTON_5;
-                break;
-            case KEY_6:
-                key_value = USER_BUTTON_6;
-                break;
-            case KEY_7:
-                key_value = USER_BUTTON_7;
-                break;
-            case KEY_8:
-                key_value = USER_BUTTON_8;
-                break;
-            case KEY_9:
-                key_value = USER_BUTTON_9;
-                break;
-            default:
-                printf("Unmapped key code: %d\n", ev.code);
-                break;
-        }
-        if (key_value != USER_BUTTON_INVALID){
-            key_btn_info_t *key_btn_info = NULL;
-            key_btn_info = scl_map_access(btn_info_map, key_value);
-            if (key_btn_info == NULL){
-                key_btn_info = malloc(sizeof(key_btn_info_t));
-                memset(key_btn_info, 0, sizeof(key_btn_info_t));
-                key_btn_info->key_value = key_value;
-                key_btn_info->key_status = key_status;
-                scl_map_insert(btn_info_map, key_value, key_btn_info);
-            }
-            key_btn_info->key_value = key_value;
-            key_btn_info->key_status = key_status;
-            return key_value;
-        }
-	}
-	return USER_BUTTON_INVALID;
-}
-
-
-
 
+/* Key edges of input devices are fed to default button group by evdev backend */
+static ebtn_evdev_dev_t key_devs[4];
+static ebtn_evdev_t key_evdev;
+static ebtn_runtime_t key_runtime;
+static const ebtn_evdev_keymap_t key_map[] = {
+        {KEY_0, USER_BUTTON_0}, {KEY_1, USER_BUTTON_1}, {KEY_2, USER_BUTTON_2}, {KEY_3, USER_BUTTON_3}, {KEY_4, USER_BUTTON_4},
+        {KEY_5, USER_BUTTON_5}, {KEY_6, USER_BUTTON_6}, {KEY_7, USER_BUTTON_7}, {KEY_8, USER_BUTTON_8}, {KEY_9, USER_BUTTON_9},
+};
 /* User defined settings */
 static const ebtn_btn_param_t defaul_ebtn_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
 
@@ -217,24 +129,6 @@ uint32_t last_time_keys_combo[USER_BUTTON_COMBO_MAX - USER_BUTTON_COMBO_0] = {0}
 
 
 
-/**
- * \brief           Get input state callback
- * \param           btn: Button instance
- * \return          `1` if button active, `0` otherwise
- */
-uint8_t prv_btn_get_state(struct ebtn_btn *btn)
-{
-    /*
-     * Function will return negative number if button is pressed,
-     * or zero if button is releases
-     */
-    key_btn_info_t *key_btn_info = scl_map_access(btn_info_map, btn->key_id);
-    if (key_btn_info){
-        return key_btn_info->key_status;
-    }
-    return 0;
-}
-
 /**
  * \brief           Button event
  *
@@ -291,21 +185,6 @@ void prv_btn_event(struct ebtn_btn *btn, ebtn_evt_t evt)
            (unsigned)ebtn_keepalive_get_count(btn), (unsigned)ebtn_click_get_count(btn));
 }
 
-void* key_listener_thread(void* arg) {
-	(void)arg;
-
-	while (1) {
-		int key = get_key_input(); // 使用上述任一方法
-		if (key != USER_BUTTON_INVALID) {
-			// atomic_store(&key_pressed, key);
-		}
-		usleep(10000); // 10ms间隔
-	}
-
-	return NULL;
-}
-static pthread_t key_thread;
-
 /**
  * \brief           Example function
  */
@@ -313,12 +192,14 @@ int example_user(void)
 {
     uint32_t time_last;
     printf("Application running\r\n");
-    btn_info_map = scl_map_new();
-    pthread_create(&key_thread, NULL, key_listener_thread, NULL);
-	pthread_detach(key_thread);
+    ebtn_evdev_init(&key_evdev, NULL, key_devs, EBTN_ARRAY_SIZE(key_devs), key_map, EBTN_ARRAY_SIZE(key_map));
+    if (!ebtn_evdev_open(&key_evdev, KEY_DEVICE))
+    {
+        perror("Failed to open input device " KEY_DEVICE);
+    }
 
     /* Define buttons */
-    ebtn_init(btns, EBTN_ARRAY_SIZE(btns), btns_combo, EBTN_ARRAY_SIZE(btns_combo), prv_btn_get_state, prv_btn_event);
+    ebtn_init(btns, EBTN_ARRAY_SIZE(btns), btns_combo, EBTN_ARRAY_SIZE(btns_combo), NULL, prv_btn_event);
 
     ebtn_combo_btn_add_btn(&btns_combo[0], USER_BUTTON_0);
     ebtn_combo_btn_add_btn(&btns_combo[0], USER_BUTTON_1);
@@ -343,14 +224,9 @@ int example_user(void)
         ebtn_combo_register(&btns_combo_dyn[i]);
     }
 
-    while (1)
-    {
-        /* Process forever */
-        ebtn_process(get_tick());
-
-        /* Artificial sleep to offload win process */
-        usleep(5000);
-    }
+    /* Process forever, wake up only on key input or button deadline */
+    ebtn_runtime_init(&key_runtime, NULL, &key_evdev, get_tick);
+    ebtn_runtime_run(&key_runtime);
     return 0;
 }
 
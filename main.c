@@ -5,9 +5,13 @@
 extern int example_test(void);
 extern int example_user(void);
 
-int main(void)
+int main(int argc, char **argv)
 {
-    // example_test();
+    // run with argument "test" to run test example
+    if (argc > 1 && strcmp(argv[1], "test") == 0)
+    {
+        return example_test();
+    }
     example_user();
     return 0;
 }
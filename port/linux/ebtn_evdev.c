@@ -0,0 +1,527 @@
+#define _GNU_SOURCE /* epoll_create1, O_CLOEXEC with -std=c99 */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include "ebtn_evdev.h"
+
+/* Max number of ready devices got by one epoll_wait() */
+#define EBTN_EVDEV_WAIT_BATCH (16)
+
+/* Headers before 4.16 have no accessors of input_event time */
+#ifndef input_event_sec
+#define input_event_sec  time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
+static ebtn_evdev_dev_t *prv_evdev_find(ebtn_evdev_t *ev, int fd)
+{
+    for (uint16_t i = 0; i < ev->dev_cnt; i++)
+    {
+        if (ev->devs[i].fd == fd)
+        {
+            return &ev->devs[i];
+        }
+    }
+    return NULL;
+}
+
+static int prv_evdev_add(ebtn_evdev_t *ev, int fd, uint8_t flags)
+{
+    struct epoll_event epev;
+    int clk = CLOCK_MONOTONIC;
+    int fl;
+
+    if (ev->epfd < 0 || fd < 0 || ev->dev_cnt >= ev->dev_size || prv_evdev_find(ev, fd) != NULL)
+    {
+        return 0;
+    }
+
+    /* Pending input is read until EAGAIN, device must not block */
+    fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0)
+    {
+        return 0;
+    }
+
+    /* Default clock of evdev is CLOCK_REALTIME which may jump, age of events is got from CLOCK_MONOTONIC */
+    if (ioctl(fd, EVIOCSCLOCKID, &clk) == 0)
+    {
+        flags |= EBTN_EVDEV_FLAG_MONOTONIC;
+    }
+
+    memset(&epev, 0x00, sizeof(epev));
+    epev.events = EPOLLIN;
+    epev.data.fd = fd;
+    if (epoll_ctl(ev->epfd, EPOLL_CTL_ADD, fd, &epev) < 0)
+    {
+        return 0;
+    }
+
+    ev->devs[ev->dev_cnt].fd = fd;
+    ev->devs[ev->dev_cnt].flags = flags;
+    memset(ev->devs[ev->dev_cnt].keys, 0x00, sizeof(ev->devs[ev->dev_cnt].keys));
+    ev->dev_cnt++;
+
+    return 1;
+}
+
+static int prv_evdev_feed(ebtn_evdev_t *ev, uint16_t key_id, uint8_t state, ebtn_time_t mstime)
+{
+    if (ev->ebtobj == NULL)
+    {
+        return ebtn_feed_edge(key_id, state, mstime);
+    }
+    return ebtn_feed_edge_ex(ev->ebtobj, key_id, state, mstime);
+}
+
+/**
+ * \brief           Keep state of a mapped EV_KEY code of the device, feed edge when state of its key_id changed.
+ * A key_id is pressed while it is held by any mapped code on any device,
+ * release on one device does not release a key held on another one.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       dev: Device of the edge
+ * \param[in]       code: Mapped EV_KEY code
+ * \param[in]       state: New state of the key on this device
+ * \param[in]       mstime: Current system time in milliseconds
+ * \return          Number of edges fed
+ */
+static int prv_evdev_feed_key(ebtn_evdev_t *ev, ebtn_evdev_dev_t *dev, uint16_t code, uint8_t state, ebtn_time_t mstime)
+{
+    uint8_t mask = (uint8_t)(1U << (code & 0x07));
+    uint16_t *hold = &ev->key_hold[ev->keyref[code]];
+
+    if (((dev->keys[code >> 3] & mask) != 0) == (state != 0))
+    {
+        return 0; /* state of this device not changed */
+    }
+
+    if (state)
+    {
+        dev->keys[code >> 3] |= mask;
+        if ((*hold)++ > 0)
+        {
+            return 0; /* already held by another code or device */
+        }
+    }
+    else
+    {
+        dev->keys[code >> 3] &= (uint8_t)~mask;
+        if (--(*hold) > 0)
+        {
+            return 0; /* still held by another code or device */
+        }
+    }
+
+    return prv_evdev_feed(ev, ev->keymap[code], state, mstime);
+}
+
+/**
+ * \brief           Read back key state of a device after kernel dropped events.
+ * Only mapped keys changed on this device are updated, a key with the same key_id held on another device is kept.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       dev: Device to resync
+ * \param[in]       mstime: Current system time in milliseconds
+ * \return          Number of edges fed
+ */
+static int prv_evdev_resync(ebtn_evdev_t *ev, ebtn_evdev_dev_t *dev, ebtn_time_t mstime)
+{
+    uint8_t keys[(KEY_CNT + 7) / 8];
+    uint8_t state;
+    int cnt = 0;
+
+    memset(keys, 0x00, sizeof(keys));
+    if (ioctl(dev->fd, EVIOCGKEY(sizeof(keys)), keys) < 0)
+    {
+        return 0; /* not an evdev device, state is unknown, keep last state. */
+    }
+
+    for (uint16_t code = 0; code < KEY_CNT; code++)
+    {
+        state = (keys[code >> 3] >> (code & 0x07)) & 0x01;
+        if (ev->keymap[code] != EBTN_EVDEV_KEY_NONE && state != ((dev->keys[code >> 3] >> (code & 0x07)) & 0x01))
+        {
+            cnt += prv_evdev_feed_key(ev, dev, code, state, mstime);
+        }
+    }
+
+    return cnt;
+}
+
+/**
+ * \brief           Get time of an event in ms, in time base of mstime.
+ * Kernel timestamp gives age of the event when device stamps events with CLOCK_MONOTONIC,
+ * unstamped events and events stamped later than now get mstime.
+ *
+ * \param[in]       dev: Device of the event
+ * \param[in]       e: Event
+ * \param[in]       mstime: Current system time in milliseconds
+ * \param[in]       now_us: Current CLOCK_MONOTONIC time in us
+ * \return          Time of the event in ms
+ */
+static ebtn_time_t prv_evdev_get_time(const ebtn_evdev_dev_t *dev, const struct input_event *e, ebtn_time_t mstime, uint64_t now_us)
+{
+    uint64_t us;
+
+    if (!(dev->flags & EBTN_EVDEV_FLAG_MONOTONIC) || (e->input_event_sec == 0 && e->input_event_usec == 0))
+    {
+        return mstime;
+    }
+
+    us = (uint64_t)e->input_event_sec * 1000000 + (uint64_t)e->input_event_usec;
+    if (us > now_us)
+    {
+        return mstime;
+    }
+
+    return (ebtn_time_t)(mstime - (ebtn_time_t)((now_us - us) / 1000));
+}
+
+/**
+ * \brief           Read all pending input of a device
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       dev: Device to read
+ * \param[in]       mstime: Current system time in milliseconds
+ * \param[in]       now_us: Current CLOCK_MONOTONIC time in us
+ * \return          Number of edges fed, `-1` if device is gone
+ */
+static int prv_evdev_read(ebtn_evdev_t *ev, ebtn_evdev_dev_t *dev, ebtn_time_t mstime, uint64_t now_us)
+{
+    struct input_event buf[EBTN_EVDEV_READ_BATCH];
+    ssize_t n;
+    size_t num;
+    int cnt = 0;
+
+    while (1)
+    {
+        n = read(dev->fd, buf, sizeof(buf));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return -1; /* ENODEV when device is unplugged */
+        }
+        if (n == 0)
+        {
+            return -1; /* end of file */
+        }
+
+        /* evdev only returns whole events, partial tail from other fds is dropped */
+        num = (size_t)n / sizeof(buf[0]);
+        for (size_t i = 0; i < num; i++)
+        {
+            const struct input_event *e = &buf[i];
+
+            if (dev->flags & EBTN_EVDEV_FLAG_DROPPED)
+            {
+                if (e->type == EV_SYN && e->code == SYN_REPORT)
+                {
+                    dev->flags &= ~EBTN_EVDEV_FLAG_DROPPED;
+                    cnt += prv_evdev_resync(ev, dev, prv_evdev_get_time(dev, e, mstime, now_us));
+                }
+                continue;
+            }
+
+            if (e->type == EV_SYN && e->code == SYN_DROPPED)
+            {
+                dev->flags |= EBTN_EVDEV_FLAG_DROPPED;
+            }
+            else if (e->type == EV_KEY && e->code < KEY_CNT && e->value != 2 && ev->keymap[e->code] != EBTN_EVDEV_KEY_NONE)
+            {
+                /* value 0 is release, 1 is press, 2 is auto repeat */
+                cnt += prv_evdev_feed_key(ev, dev, e->code, e->value != 0, prv_evdev_get_time(dev, e, mstime, now_us));
+            }
+        }
+
+        if ((size_t)n < sizeof(buf))
+        {
+            break; /* drained, save a read() returning EAGAIN. */
+        }
+    }
+
+    return cnt;
+}
+
+/**
+ * \brief           Stop watching a device, keys held on it are released first
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       dev: Device to remove
+ * \param[in]       mstime: Time in ms of the releases
+ * \return          Number of edges fed
+ */
+static int prv_evdev_remove(ebtn_evdev_t *ev, ebtn_evdev_dev_t *dev, ebtn_time_t mstime)
+{
+    int cnt = 0;
+
+    /* A key held on an unplugged device would stay pressed forever */
+    for (uint16_t code = 0; code < KEY_CNT; code++)
+    {
+        if ((dev->keys[code >> 3] >> (code & 0x07)) & 0x01)
+        {
+            cnt += prv_evdev_feed_key(ev, dev, code, 0, mstime);
+        }
+    }
+
+    epoll_ctl(ev->epfd, EPOLL_CTL_DEL, dev->fd, NULL);
+    if (dev->flags & EBTN_EVDEV_FLAG_OWNED)
+    {
+        close(dev->fd);
+    }
+
+    /* Keep devices packed, move last one to the free slot */
+    ev->dev_cnt--;
+    *dev = ev->devs[ev->dev_cnt];
+    ev->devs[ev->dev_cnt].fd = -1;
+    ev->devs[ev->dev_cnt].flags = 0;
+
+    return cnt;
+}
+
+int ebtn_evdev_init(ebtn_evdev_t *ev, ebtn_t *ebtobj, ebtn_evdev_dev_t *devs, uint16_t dev_size, const ebtn_evdev_keymap_t *keymap,
+                    uint16_t keymap_cnt)
+{
+    memset(ev, 0x00, sizeof(*ev));
+    ev->epfd = -1;
+
+    if (devs == NULL || dev_size == 0)
+    {
+        return 0;
+    }
+
+    ev->ebtobj = ebtobj;
+    ev->devs = devs;
+    ev->dev_size = dev_size;
+    for (uint16_t i = 0; i < dev_size; i++)
+    {
+        devs[i].fd = -1;
+        devs[i].flags = 0;
+        memset(devs[i].keys, 0x00, sizeof(devs[i].keys));
+    }
+
+    memset(ev->keymap, 0xFF, sizeof(ev->keymap)); /* all EBTN_EVDEV_KEY_NONE */
+    for (uint16_t i = 0; i < keymap_cnt; i++)
+    {
+        if (!ebtn_evdev_map_key(ev, keymap[i].code, keymap[i].key_id))
+        {
+            return 0;
+        }
+    }
+
+    ev->epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    return ev->epfd >= 0;
+}
+
+void ebtn_evdev_deinit(ebtn_evdev_t *ev)
+{
+    while (ev->dev_cnt > 0)
+    {
+        ebtn_evdev_remove_fd(ev, ev->devs[ev->dev_cnt - 1].fd);
+    }
+    if (ev->epfd >= 0)
+    {
+        close(ev->epfd);
+        ev->epfd = -1;
+    }
+}
+
+/**
+ * \brief           Point keyref of all codes mapped to key_id to the lowest of them, and keep hold count of key_id there
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       key_id: key_id of button
+ * \param[in]       hold: Hold count of key_id
+ */
+static void prv_evdev_set_keyref(ebtn_evdev_t *ev, uint16_t key_id, uint16_t hold)
+{
+    uint16_t ref = KEY_CNT;
+
+    for (uint16_t i = 0; i < KEY_CNT; i++)
+    {
+        if (ev->keymap[i] == key_id)
+        {
+            ref = ref == KEY_CNT ? i : ref;
+            ev->keyref[i] = ref;
+        }
+    }
+    if (ref != KEY_CNT)
+    {
+        ev->key_hold[ref] = hold;
+    }
+}
+
+/**
+ * \brief           Take hold count of a key_id out of its keyref slot
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       key_id: key_id of button
+ * \return          Hold count of key_id
+ */
+static uint16_t prv_evdev_take_hold(ebtn_evdev_t *ev, uint16_t key_id)
+{
+    uint16_t hold;
+
+    for (uint16_t i = 0; i < KEY_CNT; i++)
+    {
+        if (ev->keymap[i] == key_id)
+        {
+            hold = ev->key_hold[ev->keyref[i]];
+            ev->key_hold[ev->keyref[i]] = 0;
+            return hold;
+        }
+    }
+    return 0;
+}
+
+int ebtn_evdev_map_key(ebtn_evdev_t *ev, uint16_t code, uint16_t key_id)
+{
+    uint16_t old_id, old_hold, new_hold;
+
+    if (code >= KEY_CNT)
+    {
+        return 0;
+    }
+    old_id = ev->keymap[code];
+    if (old_id == key_id)
+    {
+        return 1;
+    }
+
+    /* Hold count of a key_id can not tell which code holds it, a held code keeps its key_id */
+    for (uint16_t i = 0; i < ev->dev_cnt; i++)
+    {
+        if ((ev->devs[i].keys[code >> 3] >> (code & 0x07)) & 0x01)
+        {
+            return 0;
+        }
+    }
+
+    /* Changing the codes of a key_id may move its lowest code, hold counts follow */
+    old_hold = old_id != EBTN_EVDEV_KEY_NONE ? prv_evdev_take_hold(ev, old_id) : 0;
+    new_hold = key_id != EBTN_EVDEV_KEY_NONE ? prv_evdev_take_hold(ev, key_id) : 0;
+    ev->keymap[code] = key_id;
+    if (old_id != EBTN_EVDEV_KEY_NONE)
+    {
+        prv_evdev_set_keyref(ev, old_id, old_hold);
+    }
+    if (key_id != EBTN_EVDEV_KEY_NONE)
+    {
+        prv_evdev_set_keyref(ev, key_id, new_hold);
+    }
+
+    return 1;
+}
+
+int ebtn_evdev_add_fd(ebtn_evdev_t *ev, int fd)
+{
+    return prv_evdev_add(ev, fd, 0);
+}
+
+int ebtn_evdev_open(ebtn_evdev_t *ev, const char *path)
+{
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return 0;
+    }
+    if (!prv_evdev_add(ev, fd, EBTN_EVDEV_FLAG_OWNED))
+    {
+        close(fd);
+        return 0;
+    }
+
+    return 1;
+}
+
+int ebtn_evdev_remove_fd(ebtn_evdev_t *ev, int fd)
+{
+    ebtn_evdev_dev_t *dev = prv_evdev_find(ev, fd);
+
+    if (dev == NULL)
+    {
+        return 0;
+    }
+    prv_evdev_remove(ev, dev, ev->mstime);
+
+    return 1;
+}
+
+int ebtn_evdev_get_fd(const ebtn_evdev_t *ev)
+{
+    return ev->epfd;
+}
+
+int ebtn_evdev_wait(ebtn_evdev_t *ev, int timeout_ms)
+{
+    struct epoll_event epev;
+    int n = epoll_wait(ev->epfd, &epev, 1, timeout_ms);
+
+    if (n < 0)
+    {
+        return errno == EINTR ? 0 : -1;
+    }
+
+    return n > 0;
+}
+
+int ebtn_evdev_dispatch(ebtn_evdev_t *ev, ebtn_time_t mstime)
+{
+    struct epoll_event epevs[EBTN_EVDEV_WAIT_BATCH];
+    ebtn_evdev_dev_t *dev;
+    int cnt = 0;
+    struct timespec ts;
+    uint64_t now_us;
+    int n, ret;
+
+    ev->mstime = mstime;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+    do
+    {
+        /* Level triggered, devices not got by this call are got by next one */
+        n = epoll_wait(ev->epfd, epevs, EBTN_EVDEV_WAIT_BATCH, 0);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                break;
+            }
+            return -1;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            dev = prv_evdev_find(ev, epevs[i].data.fd);
+            if (dev == NULL)
+            {
+                continue;
+            }
+
+            ret = prv_evdev_read(ev, dev, mstime, now_us);
+            if (ret < 0)
+            {
+                cnt += prv_evdev_remove(ev, dev, mstime);
+            }
+            else
+            {
+                cnt += ret;
+            }
+        }
+    } while (n == EBTN_EVDEV_WAIT_BATCH);
+
+    return cnt;
+}
@@ -0,0 +1,160 @@
+#ifndef _EBTN_EVDEV_H
+#define _EBTN_EVDEV_H
+
+#include <stdint.h>
+#include <linux/input.h>
+
+#include "ebtn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#ifndef EBTN_EVDEV_READ_BATCH
+#define EBTN_EVDEV_READ_BATCH (64) /*!< Max number of input_event read by one read() syscall */
+#endif
+
+#define EBTN_EVDEV_KEY_NONE (0xFFFF) /*!< EV_KEY code not mapped to any key_id */
+
+#define EBTN_EVDEV_FLAG_OWNED     ((uint8_t)0x01) /*!< Device fd is opened by backend, closed when removed */
+#define EBTN_EVDEV_FLAG_DROPPED   ((uint8_t)0x02) /*!< Kernel dropped events, skip until next SYN_REPORT and resync */
+#define EBTN_EVDEV_FLAG_MONOTONIC ((uint8_t)0x04) /*!< Device stamps events with CLOCK_MONOTONIC, edges are fed with their timestamps */
+
+/**
+ * \brief           Map of an EV_KEY code to a key_id
+ */
+typedef struct ebtn_evdev_keymap
+{
+    uint16_t code;   /*!< EV_KEY code, e.g. `KEY_0` */
+    uint16_t key_id; /*!< key_id of button */
+} ebtn_evdev_keymap_t;
+
+/**
+ * \brief           Input device watched by backend
+ */
+typedef struct ebtn_evdev_dev
+{
+    int fd;                          /*!< Device fd, `-1` if slot is free */
+    uint8_t flags;                   /*!< Device flags, `EBTN_EVDEV_FLAG_*` */
+    uint8_t keys[(KEY_CNT + 7) / 8]; /*!< Mapped EV_KEY codes held on this device, resync only changes these */
+} ebtn_evdev_dev_t;
+
+/**
+ * \brief           Linux evdev input backend.
+ * Watches any number of input devices with one epoll instance, reads arrays of input_event
+ * and feeds EV_KEY edges to a button group with ebtn_feed_edge_ex().
+ * Any fd producing struct input_event records works, a pipe or socketpair can stand in for a device.
+ */
+typedef struct ebtn_evdev
+{
+    ebtn_t *ebtobj;                    /*!< Button group fed by backend, `NULL` for default group */
+    int epfd;                          /*!< epoll instance of all devices */
+    ebtn_evdev_dev_t *devs;            /*!< Device storage */
+    uint16_t dev_size;                 /*!< Number of devices of storage */
+    uint16_t dev_cnt;                  /*!< Number of devices watched */
+    uint16_t keymap[KEY_CNT];          /*!< key_id of every EV_KEY code, `EBTN_EVDEV_KEY_NONE` if unmapped */
+    uint16_t keyref[KEY_CNT];          /*!< Lowest EV_KEY code mapped to the same key_id as every code, slot of its hold count */
+    uint16_t key_hold[KEY_CNT];        /*!< Number of codes held on all devices of every key_id, at slot of its keyref */
+    ebtn_time_t mstime;                /*!< Time of last dispatch, used to release keys of a device removed by caller */
+} ebtn_evdev_t;
+
+/**
+ * \brief           Initialize evdev backend
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       ebtobj: Button group to feed, `NULL` for default group
+ * \param[in]       devs: Device storage
+ * \param[in]       dev_size: Number of devices of storage, max number of devices watched
+ * \param[in]       keymap: Array of EV_KEY code to key_id map, can be `NULL`
+ * \param[in]       keymap_cnt: Number of entries of keymap
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_evdev_init(ebtn_evdev_t *ev, ebtn_t *ebtobj, ebtn_evdev_dev_t *devs, uint16_t dev_size, const ebtn_evdev_keymap_t *keymap,
+                    uint16_t keymap_cnt);
+
+/**
+ * \brief           Close all devices opened by backend and the epoll instance
+ *
+ * \param[in]       ev: Backend instance
+ */
+void ebtn_evdev_deinit(ebtn_evdev_t *ev);
+
+/**
+ * \brief           Map an EV_KEY code to a key_id.
+ * A code held on some device keeps its key_id until released.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       code: EV_KEY code
+ * \param[in]       key_id: key_id of button, `EBTN_EVDEV_KEY_NONE` to unmap
+ * \return          `1` on success, `0` if code is out of range or held
+ */
+int ebtn_evdev_map_key(ebtn_evdev_t *ev, uint16_t code, uint16_t key_id);
+
+/**
+ * \brief           Watch an opened fd, it is switched to non-blocking mode.
+ * The fd is not closed by backend.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       fd: Device fd, or any fd producing struct input_event records
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_evdev_add_fd(ebtn_evdev_t *ev, int fd);
+
+/**
+ * \brief           Open an input device and watch it, the fd is closed when removed.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       path: Device path, e.g. `/dev/input/event1`
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_evdev_open(ebtn_evdev_t *ev, const char *path);
+
+/**
+ * \brief           Stop watching a device, closed if it is opened by backend.
+ * Keys held on the device are released with time of last ebtn_evdev_dispatch(), unless held on another device.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       fd: Device fd
+ * \return          `1` on success, `0` if fd is not watched
+ */
+int ebtn_evdev_remove_fd(ebtn_evdev_t *ev, int fd);
+
+/**
+ * \brief           Get pollable fd of backend, readable when some device has input.
+ * Used to embed backend in other event loops.
+ *
+ * \param[in]       ev: Backend instance
+ * \return          epoll fd
+ */
+int ebtn_evdev_get_fd(const ebtn_evdev_t *ev);
+
+/**
+ * \brief           Wait until some device has input
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       timeout_ms: Max time to wait in ms, `-1` to wait forever
+ * \return          `1` if some device has input, `0` on timeout or signal, `-1` on error
+ */
+int ebtn_evdev_wait(ebtn_evdev_t *ev, int timeout_ms);
+
+/**
+ * \brief           Read all pending input of all devices without blocking and feed EV_KEY edges to button group.
+ * Edges are fed in order with time of their kernel timestamps: devices are switched to CLOCK_MONOTONIC with EVIOCSCLOCKID when added,
+ * age of an event is subtracted from mstime, so mstime can be any time base. Events of devices not supporting it get mstime.
+ * Auto repeat (value `2`) is ignored.
+ * A device reaching end of file or unplugged is removed, keys held on it are released.
+ * When kernel reports SYN_DROPPED, events until next SYN_REPORT are skipped and key state of that device is read back with EVIOCGKEY,
+ * only keys whose state changed on that device are updated, keys held on other devices are kept.
+ * A key_id is pressed while any EV_KEY code mapped to it is held on any device, edges are fed only when that changes.
+ *
+ * \param[in]       ev: Backend instance
+ * \param[in]       mstime: Current system time in milliseconds
+ * \return          Number of edges fed, `-1` on error
+ */
+int ebtn_evdev_dispatch(ebtn_evdev_t *ev, ebtn_time_t mstime);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _EBTN_EVDEV_H */
@@ -0,0 +1,226 @@
+#define _GNU_SOURCE /* epoll_create1, clock_gettime with -std=c99 */
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "ebtn_runtime.h"
+
+static ebtn_time_t prv_runtime_default_tick(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ebtn_time_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static int prv_runtime_get_deadline(ebtn_runtime_t *rt, ebtn_time_t mstime, ebtn_time_t *deadline)
+{
+    if (rt->ebtobj == NULL)
+    {
+        return ebtn_get_next_deadline(mstime, deadline);
+    }
+    return ebtn_get_next_deadline_ex(rt->ebtobj, mstime, deadline);
+}
+
+static void prv_runtime_feed_time(ebtn_runtime_t *rt, ebtn_time_t mstime)
+{
+    if (rt->ebtobj == NULL)
+    {
+        ebtn_feed_time(mstime);
+        return;
+    }
+    ebtn_feed_time_ex(rt->ebtobj, mstime);
+}
+
+static int prv_runtime_watch(ebtn_runtime_t *rt, int fd)
+{
+    struct epoll_event epev;
+
+    memset(&epev, 0x00, sizeof(epev));
+    epev.events = EPOLLIN;
+    epev.data.fd = fd;
+
+    return epoll_ctl(rt->epfd, EPOLL_CTL_ADD, fd, &epev) == 0;
+}
+
+static void prv_runtime_clear_stop(ebtn_runtime_t *rt)
+{
+    uint64_t cnt;
+
+    while (read(rt->efd, &cnt, sizeof(cnt)) < 0 && errno == EINTR) {}
+}
+
+int ebtn_runtime_init(ebtn_runtime_t *rt, ebtn_t *ebtobj, ebtn_evdev_t *evdev, ebtn_runtime_tick_fn get_tick)
+{
+    memset(rt, 0x00, sizeof(*rt));
+    rt->ebtobj = ebtobj;
+    rt->evdev = evdev;
+    rt->get_tick = get_tick != NULL ? get_tick : prv_runtime_default_tick;
+    rt->tfd = -1;
+    rt->efd = -1;
+
+    rt->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (rt->epfd < 0)
+    {
+        return 0;
+    }
+
+    /* Timer is armed with relative time, time base of get_tick does not need to be CLOCK_MONOTONIC */
+    rt->tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    /* Wakes epoll_wait() up when stop is requested from callback, another thread or a signal handler */
+    rt->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (rt->tfd < 0 || !prv_runtime_watch(rt, rt->tfd) || rt->efd < 0 || !prv_runtime_watch(rt, rt->efd)
+        || (evdev != NULL && !prv_runtime_watch(rt, ebtn_evdev_get_fd(evdev))))
+    {
+        ebtn_runtime_deinit(rt);
+        return 0;
+    }
+
+    return 1;
+}
+
+void ebtn_runtime_deinit(ebtn_runtime_t *rt)
+{
+    if (rt->tfd >= 0)
+    {
+        close(rt->tfd);
+        rt->tfd = -1;
+    }
+    if (rt->efd >= 0)
+    {
+        close(rt->efd);
+        rt->efd = -1;
+    }
+    if (rt->epfd >= 0)
+    {
+        close(rt->epfd);
+        rt->epfd = -1;
+    }
+    rt->armed = 0;
+}
+
+int ebtn_runtime_get_fd(const ebtn_runtime_t *rt)
+{
+    return rt->epfd;
+}
+
+int ebtn_runtime_arm(ebtn_runtime_t *rt)
+{
+    struct itimerspec its;
+    ebtn_time_t mstime = rt->get_tick();
+    ebtn_time_t deadline;
+    ebtn_time_sign_t delay;
+
+    memset(&its, 0x00, sizeof(its));
+    if (prv_runtime_get_deadline(rt, mstime, &deadline))
+    {
+        if (rt->armed && rt->deadline == deadline)
+        {
+            return 1; /* already armed to this deadline, save a syscall. */
+        }
+
+        /* Zero it_value disarms timer, a due deadline fires after 1ms */
+        delay = (ebtn_time_sign_t)(deadline - mstime);
+        if (delay < 1)
+        {
+            delay = 1;
+        }
+        its.it_value.tv_sec = delay / 1000;
+        its.it_value.tv_nsec = (long)(delay % 1000) * 1000000;
+        rt->deadline = deadline;
+        rt->armed = 1;
+    }
+    else
+    {
+        if (!rt->armed)
+        {
+            return 1; /* all buttons idle and timer is not running. */
+        }
+        rt->armed = 0;
+    }
+
+    return timerfd_settime(rt->tfd, 0, &its, NULL) == 0;
+}
+
+int ebtn_runtime_dispatch(ebtn_runtime_t *rt)
+{
+    ebtn_time_t mstime = rt->get_tick();
+    ebtn_time_t deadline;
+    uint64_t expired;
+
+    if (rt->evdev != NULL && ebtn_evdev_dispatch(rt->evdev, mstime) < 0)
+    {
+        return 0;
+    }
+
+    if (read(rt->tfd, &expired, sizeof(expired)) == sizeof(expired))
+    {
+        rt->armed = 0;
+        rt->timer_wakeups++;
+    }
+
+    /* Timer may fire a little early when get_tick is another clock, arm it again for the rest */
+    if (prv_runtime_get_deadline(rt, mstime, &deadline) && (ebtn_time_sign_t)(deadline - mstime) <= 0)
+    {
+        prv_runtime_feed_time(rt, mstime);
+    }
+
+    return ebtn_runtime_arm(rt);
+}
+
+int ebtn_runtime_run_once(ebtn_runtime_t *rt, int timeout_ms)
+{
+    struct epoll_event epev;
+    int n = epoll_wait(rt->epfd, &epev, 1, timeout_ms);
+
+    if (n < 0)
+    {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    if (epev.data.fd == rt->efd)
+    {
+        prv_runtime_clear_stop(rt); /* input and timer left ready are got by next wait. */
+        return 0;
+    }
+
+    rt->wakeups++;
+
+    return ebtn_runtime_dispatch(rt) ? 1 : -1;
+}
+
+int ebtn_runtime_run(ebtn_runtime_t *rt)
+{
+    /* Edges may be fed before running, deadline must be armed before first wait */
+    if (!ebtn_runtime_arm(rt))
+    {
+        return 0;
+    }
+
+    while (!rt->stop)
+    {
+        if (ebtn_runtime_run_once(rt, -1) < 0)
+        {
+            return 0;
+        }
+    }
+    rt->stop = 0;
+    prv_runtime_clear_stop(rt); /* stop requested by callback is not got by epoll yet. */
+
+    return 1;
+}
+
+void ebtn_runtime_stop(ebtn_runtime_t *rt)
+{
+    uint64_t one = 1;
+
+    rt->stop = 1;
+    /* A full counter is readable already, write() failing with EAGAIN is fine */
+    while (write(rt->efd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
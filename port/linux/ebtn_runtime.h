@@ -0,0 +1,112 @@
+#ifndef _EBTN_RUNTIME_H
+#define _EBTN_RUNTIME_H
+
+#include <stdint.h>
+
+#include "ebtn.h"
+#include "ebtn_evdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Get current time in ms, time base of button group
+ * \return          Current time in ms
+ */
+typedef ebtn_time_t (*ebtn_runtime_tick_fn)(void);
+
+/**
+ * \brief           Linux tickless runtime.
+ * Blocks in epoll on the evdev backend and a timerfd armed to ebtn_get_next_deadline_ex(),
+ * button group is processed only on input or when the deadline expired, there is no wakeup when all buttons are idle.
+ */
+typedef struct ebtn_runtime
+{
+    ebtn_t *ebtobj;                /*!< Button group, `NULL` for default group */
+    ebtn_evdev_t *evdev;           /*!< Input backend, can be `NULL` when edges are fed by caller */
+    ebtn_runtime_tick_fn get_tick; /*!< Time source of button group */
+    int epfd;                      /*!< epoll instance of input and timer */
+    int tfd;                       /*!< timerfd armed to next deadline */
+    int efd;                       /*!< eventfd waking up ebtn_runtime_run() when stop is requested */
+    uint8_t armed;                 /*!< Flag indicates that timerfd is armed */
+    ebtn_time_t deadline;          /*!< Deadline timerfd is armed to */
+    volatile uint8_t stop;         /*!< Flag requests ebtn_runtime_run() to return */
+    uint32_t wakeups;              /*!< Number of wakeups with input or timer expired */
+    uint32_t timer_wakeups;        /*!< Number of wakeups with timer expired */
+} ebtn_runtime_t;
+
+/**
+ * \brief           Initialize tickless runtime
+ *
+ * \param[in]       rt: Runtime instance
+ * \param[in]       ebtobj: Button group, `NULL` for default group, must be the group fed by evdev
+ * \param[in]       evdev: Initialized evdev backend, can be `NULL` when edges are fed by caller
+ * \param[in]       get_tick: Time source of button group, `NULL` to use CLOCK_MONOTONIC in ms
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_runtime_init(ebtn_runtime_t *rt, ebtn_t *ebtobj, ebtn_evdev_t *evdev, ebtn_runtime_tick_fn get_tick);
+
+/**
+ * \brief           Close timerfd and epoll instance of runtime, evdev backend is not closed
+ *
+ * \param[in]       rt: Runtime instance
+ */
+void ebtn_runtime_deinit(ebtn_runtime_t *rt);
+
+/**
+ * \brief           Get pollable fd of runtime, readable when input arrived or deadline expired.
+ * Used to embed runtime in other event loops, call ebtn_runtime_dispatch() when it is readable.
+ *
+ * \param[in]       rt: Runtime instance
+ * \return          epoll fd
+ */
+int ebtn_runtime_get_fd(const ebtn_runtime_t *rt);
+
+/**
+ * \brief           Arm timerfd to next deadline of button group, disarm it when all buttons are idle.
+ * Call it after feeding edges to button group out of runtime.
+ *
+ * \param[in]       rt: Runtime instance
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_runtime_arm(ebtn_runtime_t *rt);
+
+/**
+ * \brief           Process pending input and expired deadline without blocking, then arm timerfd again
+ *
+ * \param[in]       rt: Runtime instance
+ * \return          `1` on success, `0` otherwise
+ */
+int ebtn_runtime_dispatch(ebtn_runtime_t *rt);
+
+/**
+ * \brief           Wait for input or deadline, then dispatch
+ *
+ * \param[in]       rt: Runtime instance
+ * \param[in]       timeout_ms: Max time to wait in ms, `-1` to wait forever
+ * \return          `1` if woken up by input or deadline, `0` on timeout, signal or ebtn_runtime_stop(), `-1` on error
+ */
+int ebtn_runtime_run_once(ebtn_runtime_t *rt, int timeout_ms);
+
+/**
+ * \brief           Run until ebtn_runtime_stop() is called or an error occurs
+ *
+ * \param[in]       rt: Runtime instance
+ * \return          `1` if stopped, `0` on error
+ */
+int ebtn_runtime_run(ebtn_runtime_t *rt);
+
+/**
+ * \brief           Request ebtn_runtime_run() to return, e.g. from button event callback.
+ * Can be called from another thread or a signal handler, wakes up ebtn_runtime_run() blocked with all buttons idle.
+ *
+ * \param[in]       rt: Runtime instance
+ */
+void ebtn_runtime_stop(ebtn_runtime_t *rt);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _EBTN_RUNTIME_H */
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of active set processing: a process only walks buttons whose state changed or which are in process,
+ * timeouts of buttons in process fire without input change, and the in_process bitmap mirrors EBTN_FLAG_IN_PROCESS.
+ */
+
+#define TEST_BTN_NUM    (100)
+#define TEST_MAX_KEYNUM (128)
+#define TEST_COMBO_ID   (0x100)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_BTN_NUM];
+static ebtn_btn_combo_t test_combos[1];
+static BIT_ARRAY_DEFINE(test_combo_key, TEST_MAX_KEYNUM); /* Keys of combo-button are over EBTN_MAX_KEYNUM */
+static EBTN_STATE_STORAGE_DEFINE(test_state_storage, TEST_MAX_KEYNUM);
+static BIT_ARRAY_DEFINE(test_curr_state, TEST_MAX_KEYNUM);
+
+/* Process every ms of [test_now, until) with the current state bitmap */
+static void prv_test_run(ebtn_time_t until)
+{
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+    }
+}
+
+/* in_process bitmap and EBTN_FLAG_IN_PROCESS of every button agree */
+static int prv_test_in_process_mirrored(void)
+{
+    int cnt = 0;
+
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        if (bit_array_get(test_group.in_process, i) != ebtn_is_btn_in_process(&test_btns[i]))
+        {
+            return 0;
+        }
+        cnt += ebtn_is_btn_in_process(&test_btns[i]);
+    }
+    cnt += ebtn_is_btn_in_process(&test_combos[0].btn);
+
+    return ebtn_is_in_process_ex(&test_group) == (cnt != 0) && test_group.combo_in_process_cnt == ebtn_is_btn_in_process(&test_combos[0].btn);
+}
+
+static void prv_test_setup(void)
+{
+    ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_EXT_INIT(TEST_COMBO_ID, &test_param, test_combo_key);
+
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    memset(test_combo_key, 0x00, sizeof(test_combo_key));
+    test_combos[0] = combo;
+    ebtn_init_ex(&test_group, test_btns, TEST_BTN_NUM, test_combos, 1, NULL, prv_test_event);
+    ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 70);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 90);
+
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+static void test_timeouts(void)
+{
+    int idx;
+
+    SUITE_START("active: timeouts of unchanged buttons in process");
+    prv_test_setup();
+    prv_test_run(10);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    ASSERT(prv_test_in_process_mirrored());
+
+    /* Button 3 clicked, button 65 of second word held */
+    bit_array_set(test_curr_state, 3);
+    bit_array_set(test_curr_state, 65);
+    prv_test_run(100);
+    bit_array_clear(test_curr_state, 3);
+    prv_test_run(101);
+    ASSERT(ebtn_is_btn_in_process(&test_btns[3]) && ebtn_is_btn_in_process(&test_btns[65]));
+    ASSERT(prv_test_in_process_mirrored());
+
+    /* No input change, click is sent after multi-click time and keep alive periodically */
+    prv_test_run(800);
+    idx = prv_test_find_event(3, EBTN_EVT_ONCLICK);
+    ASSERT(idx >= 0 && test_evt[idx].time == 100 + 200);
+    idx = prv_test_find_event(65, EBTN_EVT_KEEPALIVE);
+    ASSERT(idx >= 0 && test_evt[idx].time == 10 + 20 + 500);
+    ASSERT(!ebtn_is_btn_in_process(&test_btns[3]));
+    ASSERT(ebtn_is_btn_in_process(&test_btns[65]));
+    ASSERT(prv_test_in_process_mirrored());
+
+    /* Idle buttons never get an event */
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        ASSERT(test_evt[i].key_id == 3 || test_evt[i].key_id == 65);
+    }
+
+    bit_array_clear(test_curr_state, 65);
+    prv_test_run(1200);
+    ASSERT(prv_test_find_event(65, EBTN_EVT_ONRELEASE) >= 0);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    ASSERT(prv_test_in_process_mirrored());
+
+    SUITE_END();
+}
+
+static void test_combo(void)
+{
+    int idx;
+
+    SUITE_START("active: combo-button in process");
+    prv_test_setup();
+
+    /* Combo-button of keys 70 and 90, keys of other words do not start it */
+    bit_array_set(test_curr_state, 5);
+    prv_test_run(50);
+    ASSERT(test_group.combo_in_process_cnt == 0);
+    bit_array_clear(test_curr_state, 5);
+    bit_array_set(test_curr_state, 70);
+    bit_array_set(test_curr_state, 90);
+    prv_test_run(100);
+    ASSERT(prv_test_find_event(TEST_COMBO_ID, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(test_group.combo_in_process_cnt == 1);
+    ASSERT(prv_test_in_process_mirrored());
+
+    /* Released, click is sent after multi-click time without input change */
+    bit_array_clear(test_curr_state, 70);
+    bit_array_clear(test_curr_state, 90);
+    prv_test_run(600);
+    idx = prv_test_find_event(TEST_COMBO_ID, EBTN_EVT_ONCLICK);
+    ASSERT(idx >= 0 && test_evt[idx].time == 100 + 200);
+    ASSERT(test_group.combo_in_process_cnt == 0);
+    ASSERT(prv_test_in_process_mirrored());
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_timeouts();
+    test_combo();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+
+#define TEST_EVT_NUM (32768) /* Events of a whole run */
+#include "ebtn_test.h"
+
+/*
+ * Test of bulk state provider: the same random input read by per-button get_state_fn, by one
+ * get_state_bulk_fn call per process, and by providers of word ranges gives the same events, over static and dynamic buttons.
+ */
+
+#define TEST_STATIC_NUM (40)
+#define TEST_DYN_NUM    (20)
+#define TEST_KEY_NUM    (TEST_STATIC_NUM + TEST_DYN_NUM)
+#define TEST_TICKS      (20000)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_STATIC_NUM];
+static ebtn_btn_dyn_t test_dyn[TEST_DYN_NUM];
+
+static uint8_t test_in[TEST_KEY_NUM]; /* Input of key_id, key_id is key_idx */
+static int test_bulk_calls[2]; /* Calls of provider of all words, or of every word range */
+static int test_bulk_words;    /* Number of words filled by last process */
+static ebtn_state_provider_t test_provider[3];
+
+static test_evt_t test_run_evt[3][TEST_EVT_NUM]; /* Event log of every run */
+static int test_run_evt_cnt[3];
+
+static uint8_t prv_test_get_state(struct ebtn_btn *btn)
+{
+    return test_in[btn->key_id];
+}
+
+/* Padding bits above key_num are written active, they must not be seen */
+static void prv_test_get_state_bulk(ebtn_t *ebtobj, bit_array_t *state, int word_begin, int word_end, void *arg)
+{
+    ASSERT(ebtobj == &test_group);
+    memset(&state[word_begin], 0xFF, sizeof(bit_array_t) * (word_end - word_begin));
+    for (int i = word_begin * BIT_ARRAY_BITS; i < word_end * (int)BIT_ARRAY_BITS && i < ebtobj->key_num; i++)
+    {
+        bit_array_assign(state, i, test_in[i]);
+    }
+    (*(int *)arg)++;
+    test_bulk_words += word_end - word_begin;
+}
+
+/* Run random input read by get_state_fn (`0`), one provider of all words (`1`), or one provider of every word range (`2`) */
+static void prv_test_run(int use_bulk)
+{
+    prv_test_clear_events();
+    test_seed = 1;
+    test_bulk_calls[0] = test_bulk_calls[1] = 0;
+    memset(test_in, 0x00, sizeof(test_in));
+
+    for (int i = 0; i < TEST_STATIC_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(TEST_STATIC_NUM + i, &test_param);
+        test_dyn[i] = btn;
+    }
+
+    /* Per-button get_state_fn can be NULL with bulk provider */
+    ebtn_init_ex(&test_group, test_btns, TEST_STATIC_NUM, NULL, 0, use_bulk ? NULL : prv_test_get_state, prv_test_event);
+    ebtn_register_bulk_ex(&test_group, test_dyn, TEST_DYN_NUM);
+    if (use_bulk == 1)
+    {
+        ASSERT(ebtn_set_get_state_bulk_ex(&test_group, prv_test_get_state_bulk, &test_bulk_calls[0]) == 1);
+    }
+    else if (use_bulk == 2)
+    {
+        /* First word, and all words after it */
+        for (int i = 0; i < 2; i++)
+        {
+            memset(&test_provider[i], 0x00, sizeof(test_provider[i]));
+            test_provider[i].fn = prv_test_get_state_bulk;
+            test_provider[i].arg = &test_bulk_calls[i];
+            test_provider[i].word_begin = (uint16_t)i;
+            test_provider[i].word_end = (uint16_t)(i == 0 ? 1 : 0);
+            ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[i]) == 1);
+        }
+    }
+
+    for (int t = 0; t < TEST_TICKS; t++)
+    {
+        /* A few keys toggle every ms, some of them bounce */
+        for (int k = 0; k < 3; k++)
+        {
+            int i = (int)(prv_test_rand() % TEST_KEY_NUM);
+            test_in[i] = !test_in[i];
+        }
+        test_bulk_words = 0;
+        test_now = (ebtn_time_t)t;
+        ebtn_process_ex(&test_group, test_now);
+    }
+    memcpy(test_run_evt[use_bulk], test_evt, sizeof(test_evt[0]) * test_evt_cnt);
+    test_run_evt_cnt[use_bulk] = test_evt_cnt;
+}
+
+static void test_bulk(void)
+{
+    SUITE_START("bulk: same events as per-button get_state_fn");
+    prv_test_run(0);
+    prv_test_run(1);
+
+    ASSERT(test_bulk_calls[0] == TEST_TICKS);
+    ASSERT(test_bulk_words == BIT_ARRAY_BITMAP_SIZE(TEST_KEY_NUM));
+    ASSERT(test_run_evt_cnt[0] > 100 && test_run_evt_cnt[0] < TEST_EVT_NUM);
+    ASSERT(test_run_evt_cnt[0] == test_run_evt_cnt[1]);
+    ASSERT(memcmp(test_run_evt[0], test_run_evt[1], sizeof(test_run_evt[0][0]) * test_run_evt_cnt[0]) == 0);
+
+    /* Provider is removed, per-button reads are back */
+    ASSERT(ebtn_set_get_state_bulk_ex(&test_group, NULL, NULL) == 1);
+    ASSERT(test_group.state_providers == NULL);
+    ASSERT(ebtn_init_ex(&test_group, test_btns, TEST_STATIC_NUM, NULL, 0, prv_test_get_state, prv_test_event) == 1);
+    ASSERT(test_group.state_providers == NULL);
+
+    SUITE_END();
+}
+
+static void test_provider_range(void)
+{
+    SUITE_START("bulk: providers of word ranges");
+    prv_test_run(2);
+
+    /* Range over words in use is not called */
+    ASSERT(test_bulk_calls[0] == TEST_TICKS);
+    ASSERT(test_bulk_calls[1] == (BIT_ARRAY_BITMAP_SIZE(TEST_KEY_NUM) > 1 ? TEST_TICKS : 0));
+    ASSERT(test_bulk_words == BIT_ARRAY_BITMAP_SIZE(TEST_KEY_NUM));
+    ASSERT(test_run_evt_cnt[2] == test_run_evt_cnt[0]);
+    ASSERT(memcmp(test_run_evt[0], test_run_evt[2], sizeof(test_run_evt[0][0]) * test_run_evt_cnt[0]) == 0);
+
+    /* All keys released */
+    memset(test_in, 0x00, sizeof(test_in));
+    for (int t = TEST_TICKS; t < TEST_TICKS + 1000; t++)
+    {
+        ebtn_process_ex(&test_group, (ebtn_time_t)t);
+    }
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    /* Added provider, overlapping or empty range is rejected */
+    ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[0]) == 0);
+    memcpy(&test_provider[2], &test_provider[0], sizeof(test_provider[2]));
+    test_provider[2].word_end = 2;
+    ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[2]) == 0);
+    test_provider[2].word_begin = 3;
+    test_provider[2].word_end = 3;
+    ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[2]) == 0);
+    test_provider[2].fn = NULL;
+    test_provider[2].word_end = 4;
+    ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[2]) == 0);
+
+    /* Only first word is read, key of a word not covered keeps state fed by edge */
+    ASSERT(ebtn_set_get_state_bulk_ex(&test_group, NULL, NULL) == 1);
+    ASSERT(ebtn_add_state_provider_ex(&test_group, &test_provider[0]) == 1);
+    ASSERT(ebtn_feed_edge_ex(&test_group, TEST_KEY_NUM - 1, 1, TEST_TICKS + 1000) == 1);
+    for (int t = TEST_TICKS + 1000; t < TEST_TICKS + 1100; t++)
+    {
+        ebtn_process_ex(&test_group, (ebtn_time_t)t);
+    }
+    ASSERT(ebtn_is_btn_active(ebtn_get_btn_by_key_id_ex(&test_group, TEST_KEY_NUM - 1)) == (BIT_ARRAY_BITMAP_SIZE(TEST_KEY_NUM) > 1));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_bulk();
+    test_provider_range();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of coalesced keep alive delivery: a late process sends one EBTN_EVT_KEEPALIVE for all periods elapsed,
+ * keepalive_cnt advances by all of them and keepalive_step is the number of periods.
+ * Built with EBTN_CONFIG_KEEPALIVE_COALESCE and EBTN_CONFIG_EVT_RING.
+ */
+
+#define TEST_PERIOD (10) /* Keep alive period in ms */
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, TEST_PERIOD, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[1];
+static uint8_t test_in;
+
+static uint16_t test_last_step; /* keepalive_step of last event */
+
+static uint8_t prv_test_get_state(struct ebtn_btn *btn)
+{
+    (void)btn;
+    return test_in;
+}
+
+static void prv_test_step_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    test_last_step = btn->keepalive_step;
+    prv_test_event(btn, evt);
+}
+
+static void prv_test_setup(ebtn_evt_fn evt_fn)
+{
+    ebtn_btn_t btn = EBTN_BUTTON_INIT(0, &test_param);
+
+    test_btns[0] = btn;
+    ebtn_init_ex(&test_group, test_btns, 1, NULL, 0, prv_test_get_state, evt_fn);
+    test_in = 1;
+    prv_test_clear_events();
+}
+
+static void test_callback(void)
+{
+    ebtn_time_t deadline;
+
+    SUITE_START("coalesce: late process sends one keep alive");
+    prv_test_setup(prv_test_step_event);
+
+    /* Pressed at 20, keep alive every period in time has step 1 */
+    for (ebtn_time_t t = 0; t <= 100; t++)
+    {
+        ebtn_process_ex(&test_group, t);
+    }
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 8);
+    ASSERT(test_last_step == 1 && test_evt[test_evt_cnt - 1].keepalive_cnt == 8);
+
+    /* Processing stalls for 2 s */
+    prv_test_clear_events();
+    ebtn_process_ex(&test_group, 2100);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 1);
+    ASSERT(test_last_step == 200);
+    ASSERT(test_evt[test_evt_cnt - 1].keepalive_cnt == 208);
+
+    /* Period phase is kept, next keep alive is one period later */
+    ASSERT(ebtn_get_next_deadline_ex(&test_group, 2100, &deadline) == 1);
+    ASSERT(deadline == 2100 + TEST_PERIOD);
+    ebtn_process_ex(&test_group, 2105);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 1);
+    ebtn_process_ex(&test_group, 2110);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 2);
+    ASSERT(test_last_step == 1 && test_evt[test_evt_cnt - 1].keepalive_cnt == 209);
+
+    /* Late by less than two periods is not coalesced */
+    ebtn_process_ex(&test_group, 2129);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 3);
+    ASSERT(test_last_step == 1 && test_evt[test_evt_cnt - 1].keepalive_cnt == 210);
+
+    SUITE_END();
+}
+
+static void test_ring(void)
+{
+    ebtn_evt_record_t rec[EBTN_EVT_RING_SIZE];
+    int n, keepalive = 0;
+
+    SUITE_START("coalesce: step in event ring record");
+    prv_test_setup(NULL);
+
+    for (ebtn_time_t t = 0; t <= 30; t++)
+    {
+        ebtn_process_ex(&test_group, t);
+    }
+    ebtn_process_ex(&test_group, 530);
+
+    n = ebtn_events_drain_ex(&test_group, rec, EBTN_EVT_RING_SIZE);
+    ASSERT(n == 3); /* ONPRESS, keep alive of 30 and coalesced one */
+    for (int i = 0; i < n; i++)
+    {
+        if (rec[i].evt == EBTN_EVT_KEEPALIVE)
+        {
+            keepalive++;
+        }
+    }
+    ASSERT(keepalive == 2);
+    ASSERT(rec[n - 1].evt == EBTN_EVT_KEEPALIVE);
+    ASSERT(rec[n - 1].keepalive_step == 50);
+    ASSERT(rec[n - 1].keepalive_cnt == 51);
+    ASSERT(rec[n - 1].time == 530);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_callback();
+    test_ring();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of combo index, built with EBTN_CONFIG_COMBO_INDEX.
+ * Random input with combo keys changed and a dynamic combo-button registered mid-run gives the same events
+ * with the index in caller storage as without index, where every combo-button is checked.
+ */
+
+#define TEST_COMBO_NUM (8)
+
+static sim_t test_sim[2];
+static bit_array_t test_index[EBTN_COMBO_INDEX_STORAGE_SIZE(SIM_KEY_NUM, TEST_COMBO_NUM)];
+static ebtn_btn_combo_t *test_index_combos[TEST_COMBO_NUM];
+static ebtn_btn_combo_dyn_t test_dyn_combo[2];
+static BIT_ARRAY_DEFINE(test_dyn_combo_key[2], SIM_KEY_NUM);
+
+/* Same combo changes in both scenarios */
+static void prv_test_tick(sim_t *sim, ebtn_time_t mstime)
+{
+    int n = (int)(sim - test_sim);
+
+    switch (mstime)
+    {
+        case 3000:
+            /* Key added to combo-button, one removed from another */
+            ebtn_combo_btn_add_btn_ex(&sim->group, &sim->combos[0], 40);
+            ebtn_combo_btn_remove_btn_ex(&sim->group, &sim->combos[3], 5);
+            break;
+        case 6000:
+            ASSERT(ebtn_combo_register_ex(&sim->group, &test_dyn_combo[n]));
+            ebtn_combo_btn_add_btn_ex(&sim->group, &test_dyn_combo[n].btn, 20);
+            ebtn_combo_btn_add_btn_ex(&sim->group, &test_dyn_combo[n].btn, SIM_KEY_NUM - 2);
+            break;
+        case 12000:
+            ASSERT(ebtn_combo_unregister_ex(&sim->group, &test_dyn_combo[n]));
+            break;
+        case 15000:
+            ebtn_combo_btn_remove_btn_ex(&sim->group, &sim->combos[0], 40);
+            break;
+        default:
+            break;
+    }
+}
+
+static void test_equal(void)
+{
+    SUITE_START("comboindex: indexed combo processing equals checking all");
+    for (int i = 0; i < 2; i++)
+    {
+        ebtn_btn_combo_dyn_t combo = EBTN_BUTTON_COMBO_DYN_EXT_INIT(SIM_COMBO_ID + SIM_COMBO_NUM, &sim_params[0], test_dyn_combo_key[i]);
+
+        memset(test_dyn_combo_key[i], 0x00, sizeof(test_dyn_combo_key[i]));
+        test_dyn_combo[i] = combo;
+        sim_init(&test_sim[i], 7);
+        test_sim[i].tick = prv_test_tick;
+        ASSERT(sim_setup(&test_sim[i]));
+    }
+
+    /* Built-in index does not cover SIM_KEY_NUM keys, second group processes without index */
+    ASSERT(ebtn_set_combo_index_storage_ex(&test_sim[0].group, test_index, test_index_combos, SIM_KEY_NUM, TEST_COMBO_NUM));
+
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    sim_run(&test_sim[1], SIM_MODE_TICK, SIM_TICKS);
+    ASSERT(test_sim[0].group.combo_index_valid);
+    ASSERT(!test_sim[1].group.combo_index_valid);
+
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+    for (uint16_t id = SIM_COMBO_ID; id <= SIM_COMBO_ID + SIM_COMBO_NUM; id++)
+    {
+        int cnt = 0;
+
+        for (int i = 0; i < test_sim[0].evt_cnt; i++)
+        {
+            cnt += test_sim[0].evt[i].key_id == id && test_sim[0].evt[i].evt == EBTN_EVT_ONPRESS;
+        }
+        ASSERT(cnt > 0);
+    }
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_equal();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of ebtn_get_next_deadline_ex(): deadline of every timeout, and processing only on input change
+ * and at the deadline gives the same events as processing every ms.
+ */
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 10, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[1];
+static BIT_ARRAY_DEFINE(test_curr_state, EBTN_MAX_KEYNUM);
+static sim_t test_sim[2];
+
+/* Deadline of group after processing at mstime, `0xFFFF...` if none */
+static ebtn_time_t prv_test_process(ebtn_time_t mstime)
+{
+    ebtn_time_t deadline;
+
+    ebtn_process_with_curr_state_ex(&test_group, test_curr_state, mstime);
+    if (!ebtn_get_next_deadline_ex(&test_group, mstime, &deadline))
+    {
+        return (ebtn_time_t)-1;
+    }
+    return deadline;
+}
+
+static void test_deadline(void)
+{
+    ebtn_btn_t btn = EBTN_BUTTON_INIT(0, &test_param);
+
+    SUITE_START("deadline: next deadline of every timeout");
+    test_btns[0] = btn;
+    ebtn_init_ex(&test_group, test_btns, 1, NULL, 0, NULL, prv_test_event);
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    prv_test_clear_events();
+
+    /* Idle group has no deadline */
+    ASSERT(prv_test_process(0) == (ebtn_time_t)-1);
+
+    /* Press debounce, then keep alive period after on-press */
+    bit_array_set(test_curr_state, 0);
+    ASSERT(prv_test_process(100) == 120);
+    ASSERT(prv_test_process(110) == 120);
+    ASSERT(prv_test_process(120) == 620);
+
+    /* Release debounce, then multi-click time after click */
+    bit_array_clear(test_curr_state, 0);
+    ASSERT(prv_test_process(200) == 210);
+    ASSERT(prv_test_process(210) == 410);
+
+    /* Bounce shorter than debounce, deadline restarts from the last change */
+    bit_array_set(test_curr_state, 0);
+    ASSERT(prv_test_process(300) == 320);
+    bit_array_clear(test_curr_state, 0);
+    ASSERT(prv_test_process(305) == 410);
+
+    /* Click is sent at the deadline, button stays in process until the next process clears it */
+    ASSERT(prv_test_process(409) == 410);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONCLICK) == 0);
+    ASSERT(prv_test_process(410) == 410);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONCLICK) == 1);
+    ASSERT(prv_test_process(411) == (ebtn_time_t)-1);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONCLICK) == 1);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    SUITE_END();
+}
+
+static void test_tickless(void)
+{
+    SUITE_START("deadline: tickless processing equals processing every ms");
+    for (int i = 0; i < 2; i++)
+    {
+        sim_init(&test_sim[i], 1);
+        ASSERT(sim_setup(&test_sim[i]));
+    }
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    sim_run(&test_sim[1], SIM_MODE_TICKLESS, SIM_TICKS);
+
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_KEEPALIVE) > 0);
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_deadline();
+    test_tickless();
+
+    return TEST_RESULT();
+}
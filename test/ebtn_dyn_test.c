@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of dynamic button registration: bulk register/unregister, list membership checks of register and unregister,
+ * and cached shard start of sharded processing after unregister.
+ * Built with EBTN_CONFIG_SHARD and EBTN_SHARD_ALIGN_KEYNUM of 64, to have small shards.
+ */
+
+#define TEST_STATIC_NUM    (16)
+#define TEST_DYN_NUM       (112)
+#define TEST_MAX_KEYNUM    (256)
+#define TEST_DYN_KEY_ID    (100) /* key_id of first dynamic button */
+#define TEST_SHARD_NUM     (2)
+#define TEST_SHARD_EVT_NUM (64)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(0, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_t test_other;
+static ebtn_btn_t test_btns[TEST_STATIC_NUM];
+static ebtn_btn_t test_other_btns[64];
+static ebtn_btn_dyn_t test_dyn[TEST_DYN_NUM];
+static ebtn_btn_combo_dyn_t test_combo;
+static EBTN_STATE_STORAGE_DEFINE(test_state_storage, TEST_MAX_KEYNUM);
+static EBTN_STATE_STORAGE_DEFINE(test_other_storage, TEST_MAX_KEYNUM);
+static ebtn_shard_t test_shards[TEST_SHARD_NUM];
+static ebtn_shard_evt_t test_shard_evts[TEST_SHARD_NUM * TEST_SHARD_EVT_NUM];
+static BIT_ARRAY_DEFINE(test_curr_state, TEST_MAX_KEYNUM);
+
+static void prv_test_setup(void)
+{
+    for (int i = 0; i < TEST_STATIC_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(TEST_DYN_KEY_ID + i, &test_param);
+        test_dyn[i] = btn;
+    }
+
+    ebtn_init_ex(&test_group, test_btns, TEST_STATIC_NUM, NULL, 0, NULL, prv_test_event);
+    ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM);
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    prv_test_clear_events();
+}
+
+/* Press or release a button by key_id, at its key_idx of this moment */
+static void prv_test_set_key(ebtn_t *ebtobj, uint16_t key_id, int state)
+{
+    int idx = ebtn_get_btn_index_by_key_id_ex(ebtobj, key_id);
+
+    if (idx >= 0)
+    {
+        bit_array_assign(test_curr_state, idx, state);
+    }
+}
+
+static void test_bulk_register(void)
+{
+    ebtn_btn_dyn_t *removed[3];
+
+    SUITE_START("dyn: bulk register and unregister");
+    prv_test_setup();
+
+    ASSERT(ebtn_register_bulk_ex(&test_group, test_dyn, TEST_DYN_NUM) == 1);
+    ASSERT(ebtn_get_total_btn_cnt_ex(&test_group) == TEST_STATIC_NUM + TEST_DYN_NUM);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID) == TEST_STATIC_NUM);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID + TEST_DYN_NUM - 1) == TEST_STATIC_NUM + TEST_DYN_NUM - 1);
+
+    /* Registered buttons are rejected, whole bulk is not registered */
+    ASSERT(ebtn_register_bulk_ex(&test_group, &test_dyn[10], 2) == 0);
+    ASSERT(ebtn_register_ex(&test_group, &test_dyn[0]) == 0);
+    ASSERT(ebtn_get_total_btn_cnt_ex(&test_group) == TEST_STATIC_NUM + TEST_DYN_NUM);
+
+    /* Buttons after removed ones move down, removed buttons are not found */
+    removed[0] = &test_dyn[0];
+    removed[1] = &test_dyn[50];
+    removed[2] = &test_dyn[TEST_DYN_NUM - 1];
+    ASSERT(ebtn_unregister_bulk_ex(&test_group, removed, 3) == 1);
+    ASSERT(ebtn_get_total_btn_cnt_ex(&test_group) == TEST_STATIC_NUM + TEST_DYN_NUM - 3);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID) == -1);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID + 50) == -1);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID + 1) == TEST_STATIC_NUM);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID + 51) == TEST_STATIC_NUM + 49);
+    ASSERT(test_dyn[51].key_idx == TEST_STATIC_NUM + 49);
+
+    /* Removed buttons can not be removed again */
+    ASSERT(ebtn_unregister_ex(&test_group, &test_dyn[50]) == 0);
+
+    /* Moved button keeps working at its new key_idx */
+    prv_test_set_key(&test_group, TEST_DYN_KEY_ID + 51, 1);
+    ebtn_process_with_curr_state_ex(&test_group, test_curr_state, 1);
+    ASSERT(test_evt_cnt == 1);
+    ASSERT(prv_test_find_event(TEST_DYN_KEY_ID + 51, EBTN_EVT_ONPRESS) >= 0);
+
+    SUITE_END();
+}
+
+static void test_membership(void)
+{
+    ebtn_btn_dyn_t copy;
+    ebtn_btn_combo_dyn_t combo_copy;
+    ebtn_btn_combo_dyn_t combo = EBTN_BUTTON_COMBO_DYN_INIT(0x300, &test_param);
+
+    SUITE_START("dyn: register and unregister check list membership");
+    prv_test_setup();
+    ASSERT(ebtn_register_bulk_ex(&test_group, test_dyn, 8) == 1);
+
+    /* Copy of a registered button carries its group generation and key_idx, but is not in the list */
+    copy = test_dyn[5];
+    ASSERT(ebtn_unregister_ex(&test_group, &copy) == 0);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_DYN_KEY_ID + 5) == TEST_STATIC_NUM + 5);
+    ASSERT(test_dyn[5].key_idx == TEST_STATIC_NUM + 5);
+    ASSERT(ebtn_get_total_btn_cnt_ex(&test_group) == TEST_STATIC_NUM + 8);
+
+    copy.btn.key_id = 0x200;
+    ASSERT(ebtn_register_ex(&test_group, &copy) == 1);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, 0x200) == TEST_STATIC_NUM + 8);
+    ASSERT(ebtn_unregister_ex(&test_group, &copy) == 1);
+
+    /* Combo-button */
+    test_combo = combo;
+    ASSERT(ebtn_combo_register_ex(&test_group, &test_combo) == 1);
+    ASSERT(ebtn_combo_register_ex(&test_group, &test_combo) == 0);
+    combo_copy = test_combo;
+    ASSERT(ebtn_combo_unregister_ex(&test_group, &combo_copy) == 0);
+    ASSERT(ebtn_combo_register_ex(&test_group, &combo_copy) == 1);
+    ASSERT(ebtn_combo_unregister_ex(&test_group, &test_combo) == 1);
+    ASSERT(ebtn_combo_unregister_ex(&test_group, &test_combo) == 0);
+    ASSERT(ebtn_combo_unregister_ex(&test_group, &combo_copy) == 1);
+    ASSERT(test_group.btn_combo_dyn_head == NULL && test_group.btn_combo_dyn_tail == NULL);
+
+    SUITE_END();
+}
+
+static void test_shard_unregister(void)
+{
+    uint16_t moved_key_id = TEST_DYN_KEY_ID + 48;
+    uint16_t next_key_id = TEST_DYN_KEY_ID + 49;
+    ebtn_btn_dyn_t *removed = &test_dyn[48];
+
+    SUITE_START("dyn: shard start after unregister");
+    prv_test_setup();
+    ASSERT(ebtn_set_shards_ex(&test_group, test_shards, TEST_SHARD_NUM, test_shard_evts, TEST_SHARD_EVT_NUM) == 1);
+    ASSERT(ebtn_register_bulk_ex(&test_group, test_dyn, TEST_DYN_NUM) == 1);
+
+    /* 128 buttons, second shard starts at key_idx 64, the first dynamic button of it is cached */
+    ebtn_process_sharded_ex(&test_group, test_curr_state, 1, NULL, NULL);
+    ASSERT(removed->key_idx == 64);
+
+    /* Button of second shard start is unregistered, and its memory is reused by another group at the same key_idx */
+    ASSERT(ebtn_unregister_ex(&test_group, removed) == 1);
+    for (int i = 0; i < 64; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(0x400 + i, &test_param);
+        test_other_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_other, test_other_btns, 64, NULL, 0, NULL, prv_test_event);
+    ebtn_set_state_storage_ex(&test_other, test_other_storage, TEST_MAX_KEYNUM);
+    ASSERT(ebtn_register_ex(&test_other, removed) == 1);
+    ASSERT(removed->key_idx == 64);
+
+    /* 127 buttons, second shard still starts at key_idx 64, now the next dynamic button */
+    prv_test_set_key(&test_group, next_key_id, 1);
+    ebtn_process_sharded_ex(&test_group, test_curr_state, 2, NULL, NULL);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, next_key_id) == 64);
+    ASSERT(prv_test_find_event(next_key_id, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(prv_test_find_event(moved_key_id, EBTN_EVT_ONPRESS) < 0);
+    ASSERT(test_evt_cnt == 1);
+
+    /* Register after sharded processing, new button at the end of second shard */
+    prv_test_clear_events();
+    ASSERT(ebtn_unregister_ex(&test_other, removed) == 1);
+    ASSERT(ebtn_register_ex(&test_group, removed) == 1);
+    prv_test_set_key(&test_group, moved_key_id, 1);
+    ebtn_process_sharded_ex(&test_group, test_curr_state, 3, NULL, NULL);
+    ASSERT(prv_test_find_event(moved_key_id, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(test_evt_cnt == 1);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_bulk_register();
+    test_membership();
+    test_shard_unregister();
+
+    return TEST_RESULT();
+}
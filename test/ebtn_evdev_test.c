@@ -0,0 +1,353 @@
+#define _GNU_SOURCE /* socketpair with -std=c99 */
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "ebtn.h"
+#include "ebtn_evdev.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of Linux evdev backend with pipe and socketpair fds standing in for devices.
+ * EVIOCGKEY fails on them, ioctl() is replaced below to report key state of a fake device for resync,
+ * and to accept EVIOCSCLOCKID, clock_gettime() is replaced to stamp events relative to a fixed CLOCK_MONOTONIC.
+ */
+
+#define TEST_DEBOUNCE (20) /* Max of press and release debounce time */
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 10, 20, 300, 200, 500, 10);
+static const ebtn_evdev_keymap_t test_keymap[] = {
+    {KEY_A, 1},
+    {KEY_B, 2},
+    {KEY_C, 3},
+};
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[3];
+static ebtn_evdev_dev_t test_devs[2];
+static ebtn_evdev_t test_ev;
+
+/* fd answering EVIOCGKEY with test_ioctl_keys, `-1` for none */
+static int test_ioctl_fd = -1;
+static uint8_t test_ioctl_keys[(KEY_CNT + 7) / 8];
+
+int ioctl(int fd, unsigned long request, ...)
+{
+    va_list ap;
+    void *arg;
+
+    va_start(ap, request);
+    arg = va_arg(ap, void *);
+    va_end(ap);
+
+    if (fd == test_ioctl_fd && request == (unsigned long)EVIOCGKEY(sizeof(test_ioctl_keys)))
+    {
+        memcpy(arg, test_ioctl_keys, sizeof(test_ioctl_keys));
+        return 0;
+    }
+    if (request == (unsigned long)EVIOCSCLOCKID && *(const int *)arg == CLOCK_MONOTONIC)
+    {
+        return 0;
+    }
+    errno = ENOTTY;
+    return -1;
+}
+
+/* CLOCK_MONOTONIC in us seen by backend */
+static uint64_t test_now_us = 5000000;
+
+int clock_gettime(clockid_t clk, struct timespec *ts)
+{
+    (void)clk;
+    ts->tv_sec = (time_t)(test_now_us / 1000000);
+    ts->tv_nsec = (long)(test_now_us % 1000000) * 1000;
+    return 0;
+}
+
+static int prv_test_find_event_time(uint16_t key_id, ebtn_evt_t evt, ebtn_time_t time)
+{
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        if (test_evt[i].key_id == key_id && test_evt[i].evt == evt && test_evt[i].time_state_change == time)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Write an event stamped with CLOCK_MONOTONIC us, `0` for unstamped */
+static void prv_test_put_at(int fd, uint16_t type, uint16_t code, int32_t value, uint64_t us)
+{
+    struct input_event e;
+
+    memset(&e, 0x00, sizeof(e));
+    e.input_event_sec = (time_t)(us / 1000000);
+    e.input_event_usec = (suseconds_t)(us % 1000000);
+    e.type = type;
+    e.code = code;
+    e.value = value;
+    if (write(fd, &e, sizeof(e)) != (ssize_t)sizeof(e))
+    {
+        ASSERT(0);
+    }
+}
+
+static void prv_test_put(int fd, uint16_t type, uint16_t code, int32_t value)
+{
+    prv_test_put_at(fd, type, code, value, 0);
+}
+
+/* Dispatch at mstime, then process timeouts until debounce of edges fed has passed */
+static int prv_test_dispatch(ebtn_time_t mstime)
+{
+    int cnt = ebtn_evdev_dispatch(&test_ev, mstime);
+
+    ebtn_feed_time_ex(&test_group, mstime + TEST_DEBOUNCE);
+    return cnt;
+}
+
+static int prv_test_setup(void)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i + 1, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 3, NULL, 0, NULL, prv_test_event);
+    prv_test_clear_events();
+    test_ioctl_fd = -1;
+    memset(test_ioctl_keys, 0x00, sizeof(test_ioctl_keys));
+
+    return ebtn_evdev_init(&test_ev, &test_group, test_devs, EBTN_ARRAY_SIZE(test_devs), test_keymap, EBTN_ARRAY_SIZE(test_keymap));
+}
+
+static void test_edges(void)
+{
+    int pa[2], sp[2], pc[2];
+
+    SUITE_START("evdev: edges of pipe and socketpair");
+    ASSERT(prv_test_setup() == 1);
+    ASSERT(pipe(pa) == 0 && socketpair(AF_UNIX, SOCK_STREAM, 0, sp) == 0 && pipe(pc) == 0);
+
+    ASSERT(ebtn_evdev_add_fd(&test_ev, pa[0]) == 1);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, sp[0]) == 1);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, pa[0]) == 0); /* already watched */
+    ASSERT(ebtn_evdev_add_fd(&test_ev, pc[0]) == 0); /* storage is full */
+    ASSERT(ebtn_evdev_wait(&test_ev, 0) == 0);
+    ASSERT(prv_test_dispatch(0) == 0);
+
+    /* Press, auto repeat and unmapped key on the pipe, press on the socket */
+    prv_test_put(pa[1], EV_KEY, KEY_A, 1);
+    prv_test_put(pa[1], EV_KEY, KEY_A, 2);
+    prv_test_put(pa[1], EV_KEY, KEY_Z, 1);
+    prv_test_put(pa[1], EV_SYN, SYN_REPORT, 0);
+    prv_test_put(sp[1], EV_KEY, KEY_B, 1);
+    ASSERT(ebtn_evdev_wait(&test_ev, 100) == 1);
+    ASSERT(prv_test_dispatch(100) == 2);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(prv_test_find_event(2, EBTN_EVT_ONPRESS) >= 0);
+
+    /* More events than one read() gets */
+    for (int i = 0; i < EBTN_EVDEV_READ_BATCH * 2; i++)
+    {
+        prv_test_put(sp[1], EV_SYN, SYN_REPORT, 0);
+    }
+    prv_test_put(sp[1], EV_KEY, KEY_B, 0);
+    ASSERT(prv_test_dispatch(500) == 1);
+    ASSERT(prv_test_find_event(2, EBTN_EVT_ONRELEASE) >= 0);
+
+    /* Dropped events are skipped until SYN_REPORT, EVIOCGKEY fails on a pipe and last state is kept */
+    prv_test_put(pa[1], EV_SYN, SYN_DROPPED, 0);
+    prv_test_put(pa[1], EV_KEY, KEY_C, 1);
+    prv_test_put(pa[1], EV_SYN, SYN_REPORT, 0);
+    ASSERT(prv_test_dispatch(600) == 0);
+    ASSERT(prv_test_find_event(3, EBTN_EVT_ONPRESS) < 0);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) < 0);
+
+    /* End of file removes device, KEY_A held on it is released */
+    close(pa[1]);
+    ASSERT(prv_test_dispatch(700) == 1);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) >= 0);
+    ASSERT(test_ev.key_hold[test_ev.keyref[KEY_A]] == 0);
+    ASSERT(test_ev.dev_cnt == 1);
+    ASSERT(ebtn_evdev_get_fd(&test_ev) >= 0);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, pc[0]) == 1);
+
+    /* Removed by caller, KEY_C held on it is released */
+    prv_test_put(pc[1], EV_KEY, KEY_C, 1);
+    ASSERT(prv_test_dispatch(800) == 1);
+    ASSERT(ebtn_evdev_remove_fd(&test_ev, pc[0]) == 1);
+    ebtn_feed_time_ex(&test_group, 900);
+    ASSERT(prv_test_find_event(3, EBTN_EVT_ONRELEASE) >= 0);
+    ASSERT(ebtn_evdev_remove_fd(&test_ev, sp[0]) == 1);
+    ASSERT(ebtn_evdev_remove_fd(&test_ev, sp[0]) == 0);
+
+    ebtn_evdev_deinit(&test_ev);
+    close(pa[0]);
+    close(sp[0]);
+    close(sp[1]);
+    close(pc[0]);
+    close(pc[1]);
+    SUITE_END();
+}
+
+static void test_resync(void)
+{
+    int da[2], db[2];
+
+    SUITE_START("evdev: resync keeps keys held on other device");
+    ASSERT(prv_test_setup() == 1);
+    ASSERT(pipe(da) == 0 && pipe(db) == 0);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, da[0]) == 1);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, db[0]) == 1);
+
+    /* Same key_id held on device A, key C held on device B */
+    prv_test_put(da[1], EV_KEY, KEY_A, 1);
+    prv_test_put(db[1], EV_KEY, KEY_C, 1);
+    ASSERT(prv_test_dispatch(100) == 2);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(prv_test_find_event(3, EBTN_EVT_ONPRESS) >= 0);
+
+    /* Device B drops press of KEY_B and release of KEY_C, KEY_A is not held on device B */
+    test_ioctl_fd = db[0];
+    test_ioctl_keys[KEY_B >> 3] |= (uint8_t)(1U << (KEY_B & 0x07));
+    prv_test_put(db[1], EV_SYN, SYN_DROPPED, 0);
+    prv_test_put(db[1], EV_KEY, KEY_B, 1);
+    prv_test_put(db[1], EV_SYN, SYN_REPORT, 0);
+    prv_test_clear_events();
+    ASSERT(prv_test_dispatch(200) == 2);
+    ASSERT(prv_test_find_event(2, EBTN_EVT_ONPRESS) >= 0);
+    ASSERT(prv_test_find_event(3, EBTN_EVT_ONRELEASE) >= 0);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) < 0);
+    ASSERT(ebtn_is_btn_active(&test_btns[0]));
+
+    /* Second resync with the same state feeds nothing */
+    prv_test_put(db[1], EV_SYN, SYN_DROPPED, 0);
+    prv_test_put(db[1], EV_SYN, SYN_REPORT, 0);
+    prv_test_clear_events();
+    ASSERT(prv_test_dispatch(300) == 0);
+    ASSERT(test_evt_cnt == 0);
+
+    /* Release on device A still works */
+    prv_test_put(da[1], EV_KEY, KEY_A, 0);
+    ASSERT(prv_test_dispatch(400) == 1);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) >= 0);
+
+    ebtn_evdev_deinit(&test_ev);
+    close(da[0]);
+    close(da[1]);
+    close(db[0]);
+    close(db[1]);
+    SUITE_END();
+}
+
+static void test_aggregate(void)
+{
+    int da[2], db[2];
+
+    SUITE_START("evdev: key held on any device or code keeps key_id pressed");
+    ASSERT(prv_test_setup() == 1);
+    ASSERT(ebtn_evdev_map_key(&test_ev, KEY_D, 1) == 1);
+    ASSERT(pipe(da) == 0 && pipe(db) == 0);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, da[0]) == 1);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, db[0]) == 1);
+
+    /* KEY_A pressed on both devices, only first press is fed */
+    prv_test_put(da[1], EV_KEY, KEY_A, 1);
+    ASSERT(prv_test_dispatch(100) == 1);
+    prv_test_put(db[1], EV_KEY, KEY_A, 1);
+    ASSERT(prv_test_dispatch(200) == 0);
+    ASSERT(test_ev.keyref[KEY_D] == KEY_A);
+    ASSERT(test_ev.key_hold[KEY_A] == 2);
+
+    /* Release on device A, still held on device B */
+    prv_test_clear_events();
+    prv_test_put(da[1], EV_KEY, KEY_A, 0);
+    ASSERT(prv_test_dispatch(300) == 0);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) < 0);
+    ASSERT(ebtn_is_btn_active(&test_btns[0]));
+
+    /* KEY_D mapped to the same key_id, pressed on device A before device B drops its KEY_A */
+    prv_test_put(da[1], EV_KEY, KEY_D, 1);
+    ASSERT(prv_test_dispatch(400) == 0);
+    test_ioctl_fd = db[0];
+    prv_test_put(db[1], EV_SYN, SYN_DROPPED, 0);
+    prv_test_put(db[1], EV_SYN, SYN_REPORT, 0);
+    ASSERT(prv_test_dispatch(500) == 0);
+    ASSERT(test_ev.key_hold[KEY_A] == 1);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) < 0);
+
+    /* Held KEY_D keeps its key_id, unmapping released KEY_A moves hold count to KEY_D */
+    ASSERT(ebtn_evdev_map_key(&test_ev, KEY_D, 2) == 0);
+    ASSERT(ebtn_evdev_map_key(&test_ev, KEY_A, EBTN_EVDEV_KEY_NONE) == 1);
+    ASSERT(test_ev.keyref[KEY_D] == KEY_D && test_ev.key_hold[KEY_D] == 1);
+
+    /* Last code released */
+    prv_test_put(da[1], EV_KEY, KEY_D, 0);
+    ASSERT(prv_test_dispatch(600) == 1);
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) >= 0);
+
+    ebtn_evdev_deinit(&test_ev);
+    close(da[0]);
+    close(da[1]);
+    close(db[0]);
+    close(db[1]);
+    SUITE_END();
+}
+
+static void test_timestamp(void)
+{
+    int pa[2];
+
+    SUITE_START("evdev: edges fed with kernel timestamps");
+    ASSERT(prv_test_setup() == 1);
+    ASSERT(pipe(pa) == 0);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, pa[0]) == 1);
+    ASSERT(test_devs[0].flags & EBTN_EVDEV_FLAG_MONOTONIC);
+
+    /*
+     * Press 100ms and release 40.5ms before dispatch in one read, time base of mstime differs from CLOCK_MONOTONIC.
+     * Press debounce ends at 920 before the release, on-press is sent by the dispatch.
+     */
+    test_now_us = 5000000;
+    prv_test_put_at(pa[1], EV_KEY, KEY_A, 1, 4900000);
+    prv_test_put_at(pa[1], EV_KEY, KEY_A, 0, 4959500);
+    ASSERT(ebtn_evdev_dispatch(&test_ev, 1000) == 2);
+    ASSERT(prv_test_find_event_time(1, EBTN_EVT_ONPRESS, 900));
+    ASSERT(prv_test_find_event(1, EBTN_EVT_ONRELEASE) < 0);
+
+    /* Release debounce and multi-click time of the back-dated release */
+    ebtn_feed_time_ex(&test_group, 1000);
+    ASSERT(prv_test_find_event_time(1, EBTN_EVT_ONRELEASE, 960));
+    ebtn_feed_time_ex(&test_group, 1200);
+    ASSERT(prv_test_find_event_time(1, EBTN_EVT_ONCLICK, 960));
+
+    /* Unstamped event and event stamped after now get mstime */
+    test_now_us = 6000000;
+    prv_test_put(pa[1], EV_KEY, KEY_B, 1);
+    ASSERT(prv_test_dispatch(2000) == 1);
+    ASSERT(prv_test_find_event_time(2, EBTN_EVT_ONPRESS, 2000));
+    test_now_us = 6100000;
+    prv_test_put_at(pa[1], EV_KEY, KEY_B, 0, 7000000);
+    ASSERT(prv_test_dispatch(2100) == 1);
+    ASSERT(prv_test_find_event_time(2, EBTN_EVT_ONRELEASE, 2100));
+
+    ebtn_evdev_deinit(&test_ev);
+    close(pa[0]);
+    close(pa[1]);
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_edges();
+    test_resync();
+    test_aggregate();
+    test_timestamp();
+
+    return TEST_RESULT();
+}
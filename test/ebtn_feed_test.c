@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of edge-fed processing: events are timed by the fed edge time and the deadline, not by a process period,
+ * a late edge never moves time back, timeouts due between edges fed in a batch are processed at their deadlines,
+ * and feeding edges and deadlines gives the same events as processing every ms.
+ */
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 10, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[2];
+static sim_t test_sim[2];
+
+/* Feed edge of key 0, then feed time at every deadline before until */
+static void prv_test_edge(uint8_t state, ebtn_time_t time, ebtn_time_t until)
+{
+    ebtn_time_t deadline;
+
+    test_now = time;
+    ASSERT(ebtn_feed_edge_ex(&test_group, 0, state, time));
+    while (ebtn_get_next_deadline_ex(&test_group, test_now, &deadline) && ebtn_timer_sub(until, deadline) > 0)
+    {
+        test_now = deadline;
+        ebtn_feed_time_ex(&test_group, deadline);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 2, NULL, 0, NULL, prv_test_event);
+    prv_test_clear_events();
+}
+
+static void test_exact(void)
+{
+    SUITE_START("feed: events at exact edge and deadline time");
+    prv_test_setup();
+    ASSERT(ebtn_feed_edge_ex(&test_group, 7, 1, 0) == 0); /* Unknown key_id */
+
+    /* Press at 103, released at 257, pressed again at 301 and held */
+    prv_test_edge(1, 103, 257);
+    ASSERT(test_evt_cnt == 1 && test_evt[0].evt == EBTN_EVT_ONPRESS && test_evt[0].time == 123);
+    prv_test_edge(0, 257, 301);
+    ASSERT(test_evt_cnt == 2 && test_evt[1].evt == EBTN_EVT_ONRELEASE && test_evt[1].time == 267);
+    prv_test_edge(1, 301, 1000);
+    ASSERT(test_evt[2].evt == EBTN_EVT_ONPRESS && test_evt[2].time == 321);
+    ASSERT(test_evt[3].evt == EBTN_EVT_ONCLICK && test_evt[3].time == 321 + 300 + 1); /* Long press ends click sequence */
+    ASSERT(test_evt[4].evt == EBTN_EVT_KEEPALIVE && test_evt[4].time == 821);
+    ASSERT(test_evt_cnt == 5);
+
+    /* Without input, process keeps the last fed state */
+    test_now = 1321;
+    ebtn_process_ex(&test_group, 1321);
+    ASSERT(test_evt_cnt == 6 && test_evt[5].evt == EBTN_EVT_KEEPALIVE);
+    ASSERT(ebtn_is_btn_active(&test_btns[0]));
+
+    SUITE_END();
+}
+
+static void test_late(void)
+{
+    SUITE_START("feed: late edge is processed at the last time");
+    prv_test_setup();
+
+    prv_test_edge(1, 100, 200);
+    ASSERT(test_evt_cnt == 1 && test_evt[0].time == 120);
+
+    /* Timeout of 150 processed, then an edge stamped 140 arrives */
+    ebtn_feed_time_ex(&test_group, 150);
+    test_now = 150;
+    ASSERT(ebtn_feed_edge_ex(&test_group, 0, 0, 140));
+    ebtn_feed_time_ex(&test_group, 159);
+    ASSERT(test_evt_cnt == 1);
+    ebtn_feed_time_ex(&test_group, 160);
+    ASSERT(test_evt_cnt == 2 && test_evt[1].evt == EBTN_EVT_ONRELEASE);
+
+    SUITE_END();
+}
+
+static void test_batch(void)
+{
+    SUITE_START("feed: timeouts between edges of a batch");
+    prv_test_setup();
+
+    /* Press and release read at once, no ebtn_feed_time() at press debounce deadline of 120 */
+    ASSERT(ebtn_feed_edge_ex(&test_group, 0, 1, 100));
+    ASSERT(ebtn_feed_edge_ex(&test_group, 0, 0, 160));
+    ASSERT(test_evt_cnt == 1 && test_evt[0].evt == EBTN_EVT_ONPRESS && test_evt[0].time_state_change == 100);
+
+    /* Next edge of the batch sends release and click at their deadlines first */
+    ASSERT(ebtn_feed_edge_ex(&test_group, 1, 1, 1000));
+    ASSERT(test_evt_cnt == 3);
+    ASSERT(test_evt[1].evt == EBTN_EVT_ONRELEASE && test_evt[1].time_state_change == 160);
+    ASSERT(test_evt[2].evt == EBTN_EVT_ONCLICK && test_evt[2].time_state_change == 160);
+
+    SUITE_END();
+}
+
+static void test_equal(void)
+{
+    SUITE_START("feed: feeding edges equals processing every ms");
+    for (int i = 0; i < 2; i++)
+    {
+        sim_init(&test_sim[i], 12);
+        test_sim[i].one_edge = 1;
+        ASSERT(sim_setup(&test_sim[i]));
+    }
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    sim_run(&test_sim[1], SIM_MODE_FEED, SIM_TICKS);
+
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_exact();
+    test_late();
+    test_batch();
+    test_equal();
+
+    return TEST_RESULT();
+}
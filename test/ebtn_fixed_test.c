@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of compile-time feature stripping and fixed params.
+ * Built with EBTN_CONFIG_FIXED_PARAMS, EBTN_CONFIG_NO_KEEPALIVE and EBTN_CONFIG_NO_MULTICLICK,
+ * buttons have `NULL` param and an event_mask which is ignored.
+ */
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[2];
+static ebtn_btn_combo_t test_combos[1];
+static ebtn_btn_combo_dyn_t test_dyn_combo;
+static uint8_t test_in[2];
+
+static uint8_t prv_test_get_state(struct ebtn_btn *btn)
+{
+    return test_in[btn->key_id];
+}
+
+/* Process every ms of [test_now, until) with key state */
+static void prv_test_hold(uint16_t key_id, uint8_t state, ebtn_time_t until)
+{
+    test_in[key_id] = state;
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_ex(&test_group, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    ebtn_btn_t btn0 = EBTN_BUTTON_INIT_RAW(0, NULL, EBTN_EVT_MASK_ONPRESS);
+    ebtn_btn_t btn1 = EBTN_BUTTON_INIT(1, NULL);
+    ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_INIT(0x100, NULL);
+
+    test_btns[0] = btn0;
+    test_btns[1] = btn1;
+    test_combos[0] = combo;
+    ebtn_init_ex(&test_group, test_btns, 2, test_combos, 1, prv_test_get_state, prv_test_event);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 0);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 1);
+
+    memset(test_in, 0x00, sizeof(test_in));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+static void test_fixed_params(void)
+{
+    ebtn_btn_combo_dyn_t combo = EBTN_BUTTON_COMBO_DYN_INIT(0x101, NULL);
+
+    SUITE_START("fixed: fixed params with NULL param");
+    prv_test_setup();
+
+    /* Bounce shorter than EBTN_FIXED_TIME_DEBOUNCE is ignored */
+    prv_test_hold(0, 1, EBTN_FIXED_TIME_DEBOUNCE - 5);
+    prv_test_hold(0, 0, 50);
+    ASSERT(test_evt_cnt == 0);
+
+    /* Press after debounce, event_mask of button is replaced by EBTN_FIXED_EVT_MASK */
+    prv_test_hold(0, 1, 50 + EBTN_FIXED_TIME_DEBOUNCE + 1);
+    ASSERT(test_evt_cnt == 1);
+    ASSERT(test_evt[0].evt == EBTN_EVT_ONPRESS && test_evt[0].time == 50 + EBTN_FIXED_TIME_DEBOUNCE);
+    prv_test_hold(0, 1, 150);
+    prv_test_hold(0, 0, 200);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONRELEASE) == 1);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONCLICK) == 1);
+
+    /* Press longer than EBTN_FIXED_TIME_CLICK_PRESSED_MAX is no click */
+    prv_test_hold(1, 1, 200 + EBTN_FIXED_TIME_DEBOUNCE + EBTN_FIXED_TIME_CLICK_PRESSED_MAX + 10);
+    prv_test_hold(1, 0, 1000);
+    ASSERT(prv_test_count_event(1, EBTN_EVT_ONPRESS) == 1);
+    ASSERT(prv_test_count_event(1, EBTN_EVT_ONCLICK) == 0);
+
+    /* Combo-button with NULL param */
+    test_in[0] = 1;
+    prv_test_hold(1, 1, 1100);
+    prv_test_hold(1, 0, 1200);
+    test_in[0] = 0;
+    prv_test_hold(0, 0, 1500);
+    ASSERT(prv_test_count_event(0x100, EBTN_EVT_ONPRESS) == 1);
+    ASSERT(prv_test_count_event(0x100, EBTN_EVT_ONRELEASE) == 1);
+
+    /* Combo-button with NULL param registered while its keys are held is processed */
+    test_in[0] = 1;
+    prv_test_hold(1, 1, 1600);
+    test_dyn_combo = combo;
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_dyn_combo.btn, 0);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_dyn_combo.btn, 1);
+    ASSERT(ebtn_combo_register_ex(&test_group, &test_dyn_combo) == 1);
+    prv_test_hold(1, 1, 1700);
+    test_in[0] = 0;
+    prv_test_hold(1, 0, 1800);
+    ASSERT(prv_test_count_event(0x101, EBTN_EVT_ONRELEASE) == 1);
+    ASSERT(ebtn_combo_unregister_ex(&test_group, &test_dyn_combo) == 1);
+
+    SUITE_END();
+}
+
+static void test_stripped(void)
+{
+    ebtn_time_t deadline;
+    int idx;
+
+    SUITE_START("fixed: no keep alive and no multi-click");
+    prv_test_setup();
+
+    /* Held for many keep alive periods, no keep alive and no deadline after on-press */
+    prv_test_hold(0, 1, 100);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_ONPRESS) == 1);
+    ASSERT(ebtn_get_next_deadline_ex(&test_group, test_now, &deadline) == 0);
+    prv_test_hold(0, 1, 100 + 4 * EBTN_FIXED_TIME_KEEPALIVE_PERIOD);
+    ASSERT(prv_test_count_event(0, EBTN_EVT_KEEPALIVE) == 0);
+    prv_test_hold(0, 0, 3000);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    /* Two quick clicks are two clicks of count 1, each sent right after on-release */
+    prv_test_clear_events();
+    prv_test_hold(1, 1, 3100);
+    prv_test_hold(1, 0, 3150);
+    ASSERT(prv_test_count_event(1, EBTN_EVT_ONCLICK) == 1);
+    prv_test_hold(1, 1, 3250);
+    prv_test_hold(1, 0, 3300);
+    ASSERT(prv_test_count_event(1, EBTN_EVT_ONCLICK) == 2);
+    for (idx = 0; idx < test_evt_cnt; idx++)
+    {
+        if (test_evt[idx].evt == EBTN_EVT_ONCLICK)
+        {
+            ASSERT(test_evt[idx].click_cnt == 1);
+            ASSERT(test_evt[idx - 1].evt == EBTN_EVT_ONRELEASE && test_evt[idx - 1].time == test_evt[idx].time);
+        }
+    }
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_fixed_params();
+    test_stripped();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of gesture matching, built with EBTN_CONFIG_GESTURE.
+ * Scripted presses of buttons are fed from event callback, every pattern is matched at its last symbol or at the end
+ * of the sequence, buttons sharing a gesture keep their own state, and bad patterns are refused.
+ */
+
+#define TEST_MATCH_NUM  (16)
+#define TEST_STATE_NUM  EBTN_GESTURE_STATE_NUM(16)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+static const char *const test_patterns[] = {"..-", ".-", "-...", ".", "___"};
+
+static ebtn_gesture_trans_t test_table[EBTN_GESTURE_TABLE_SIZE(TEST_STATE_NUM)];
+static ebtn_gesture_t test_gesture;
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[2];
+static uint8_t test_in[2];
+
+static int test_match[TEST_MATCH_NUM];
+static uint16_t test_match_key_id[TEST_MATCH_NUM];
+static ebtn_time_t test_match_time[TEST_MATCH_NUM];
+static int test_match_cnt;
+
+static uint8_t prv_test_get_state(struct ebtn_btn *btn)
+{
+    return test_in[btn->key_id];
+}
+
+static void prv_test_gesture_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    int idx = ebtn_gesture_feed(&test_gesture, btn, evt);
+
+    if (idx >= 0 && test_match_cnt < TEST_MATCH_NUM)
+    {
+        test_match[test_match_cnt] = idx;
+        test_match_key_id[test_match_cnt] = btn->key_id;
+        test_match_time[test_match_cnt] = test_now;
+        test_match_cnt++;
+    }
+}
+
+/* Process every ms of [test_now, test_now + duration) with input state of key */
+static void prv_test_hold(int key, uint8_t state, ebtn_time_t duration)
+{
+    ebtn_time_t until = test_now + duration;
+
+    test_in[key] = state;
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_ex(&test_group, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 2, NULL, 0, prv_test_get_state, prv_test_gesture_event);
+    memset(test_in, 0x00, sizeof(test_in));
+    test_now = 0;
+    test_match_cnt = 0;
+    prv_test_hold(0, 0, 100);
+}
+
+static void test_compile(void)
+{
+    const char *const bad[] = {".", ".x"};
+    const char *const dup[] = {"..", "-", ".."};
+    const char *const empty[] = {".", ""};
+
+    SUITE_START("gesture: compile patterns");
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, test_patterns, EBTN_ARRAY_SIZE(test_patterns)));
+    ASSERT(test_gesture.state_cnt >= 2 && test_gesture.state_cnt <= TEST_STATE_NUM);
+
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, test_patterns, 0) == 0);
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, bad, EBTN_ARRAY_SIZE(bad)) == 0);
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, dup, EBTN_ARRAY_SIZE(dup)) == 0);
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, empty, EBTN_ARRAY_SIZE(empty)) == 0);
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, 3, test_patterns, EBTN_ARRAY_SIZE(test_patterns)) == 0);
+
+    ASSERT(ebtn_gesture_compile(&test_gesture, test_table, TEST_STATE_NUM, test_patterns, EBTN_ARRAY_SIZE(test_patterns)));
+
+    SUITE_END();
+}
+
+static void test_match_patterns(void)
+{
+    SUITE_START("gesture: patterns matched at the right event");
+
+    /* Short, short, long: matched on release of the long press, not by the on-click it ends */
+    prv_test_setup();
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 100);
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 100);
+    prv_test_hold(0, 1, 700);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 1 && test_match[0] == 0 && test_match_time[0] == 1100);
+
+    /* Short alone, a prefix of longer patterns, matched on end of sequence */
+    prv_test_setup();
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 1 && test_match[0] == 3 && test_match_time[0] == 350);
+
+    /* Shorts apart more than time_click_multi_max are separate sequences */
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 2 && test_match[1] == 3);
+
+    /* Short, long */
+    prv_test_setup();
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 100);
+    prv_test_hold(0, 1, 700);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 1 && test_match[0] == 1);
+
+    /* Long, then three shorts, matched on third release */
+    prv_test_setup();
+    prv_test_hold(0, 1, 700);
+    prv_test_hold(0, 0, 100);
+    for (int i = 0; i < 3; i++)
+    {
+        prv_test_hold(0, 1, 50);
+        prv_test_hold(0, 0, 100);
+    }
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 1 && test_match[0] == 2 && test_match_time[0] == 1250);
+
+    /* Third keep alive while held, holding longer and release give nothing more */
+    prv_test_setup();
+    prv_test_hold(0, 1, 2100);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 1 && test_match[0] == 4 && test_match_time[0] == 120 + 3 * 500);
+
+    SUITE_END();
+}
+
+static void test_buttons(void)
+{
+    SUITE_START("gesture: buttons keep own state, reset");
+
+    /* Sequences of two buttons interleaved */
+    prv_test_setup();
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 50);
+    prv_test_hold(1, 1, 50);
+    prv_test_hold(1, 0, 50);
+    prv_test_hold(0, 1, 700);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 2);
+    ASSERT(test_match_key_id[0] == 1 && test_match[0] == 3);
+    ASSERT(test_match_key_id[1] == 0 && test_match[1] == 1);
+
+    /* Reset drops the started sequence, long press after it is not ".-" */
+    prv_test_setup();
+    prv_test_hold(0, 1, 50);
+    prv_test_hold(0, 0, 100);
+    ebtn_gesture_reset(&test_btns[0]);
+    prv_test_hold(0, 1, 700);
+    prv_test_hold(0, 0, 1000);
+    ASSERT(test_match_cnt == 0);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_compile();
+    test_match_patterns();
+    test_buttons();
+
+    return TEST_RESULT();
+}
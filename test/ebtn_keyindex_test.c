@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of key index, built with EBTN_CONFIG_KEY_INDEX.
+ * key_id lookup by the direct table and by the hash table, after dynamic buttons are registered and unregistered
+ * and when the hash table is full, gives the same result as a linear search of all buttons.
+ */
+
+#define TEST_BTN_NUM   (40)
+#define TEST_DYN_NUM   (20)
+#define TEST_HASH_SIZE EBTN_KEY_HASH_SIZE(TEST_BTN_NUM + TEST_DYN_NUM)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_BTN_NUM];
+static ebtn_btn_dyn_t test_dyn[TEST_DYN_NUM];
+static ebtn_btn_combo_t test_combos[1];
+static ebtn_btn_t *test_hash[TEST_HASH_SIZE];
+static ebtn_btn_t *test_hash_small[4];
+
+static ebtn_btn_dyn_t *test_reg[TEST_DYN_NUM]; /* Registered dynamic buttons in key_idx order */
+static int test_reg_cnt;
+
+/* key_id of static buttons in direct and hash range */
+static uint16_t prv_test_key_id(int i)
+{
+    return (uint16_t)(i < 20 ? i : 1000 + i * 37);
+}
+
+/* key_id of dynamic buttons, first ones fill up the direct range */
+static uint16_t prv_test_dyn_key_id(int i)
+{
+    return (uint16_t)(i < 12 ? 20 + i : 0xFFFE - i * 3);
+}
+
+/* Linear search reference of ebtn_get_btn_index_by_key_id_ex() */
+static int prv_test_find(uint16_t key_id)
+{
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        if (test_btns[i].key_id == key_id)
+        {
+            return i;
+        }
+    }
+    for (int i = 0; i < test_reg_cnt; i++)
+    {
+        if (test_reg[i]->btn.key_id == key_id)
+        {
+            return TEST_BTN_NUM + i;
+        }
+    }
+    return -1;
+}
+
+/* Lookup of every key_id in use and some unused ones equals the reference */
+static int prv_test_lookup_all(void)
+{
+    static const uint16_t unused[] = {32, 999, 1000 + 40 * 37, 0xFFFF};
+    int idx;
+
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        if (ebtn_get_btn_index_by_key_id_ex(&test_group, prv_test_key_id(i)) != i)
+        {
+            return 0;
+        }
+    }
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        uint16_t key_id = prv_test_dyn_key_id(i);
+
+        idx = ebtn_get_btn_index_by_key_id_ex(&test_group, key_id);
+        if (idx != prv_test_find(key_id))
+        {
+            return 0;
+        }
+        if (idx >= 0 && ebtn_get_btn_by_key_id_ex(&test_group, key_id) != &test_dyn[i].btn)
+        {
+            return 0;
+        }
+    }
+    for (size_t i = 0; i < EBTN_ARRAY_SIZE(unused); i++)
+    {
+        if (ebtn_get_btn_index_by_key_id_ex(&test_group, unused[i]) != -1 || ebtn_get_btn_by_key_id_ex(&test_group, unused[i]) != NULL)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void prv_test_unregister(int n)
+{
+    ASSERT(ebtn_unregister_ex(&test_group, &test_dyn[n]));
+    for (int i = 0; i < test_reg_cnt; i++)
+    {
+        if (test_reg[i] == &test_dyn[n])
+        {
+            memmove(&test_reg[i], &test_reg[i + 1], (test_reg_cnt - i - 1) * sizeof(test_reg[0]));
+            test_reg_cnt--;
+            break;
+        }
+    }
+}
+
+static void prv_test_setup(void)
+{
+    ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_INIT(0x100, &test_param);
+
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(prv_test_key_id(i), &test_param);
+        test_btns[i] = btn;
+    }
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(prv_test_dyn_key_id(i), &test_param);
+        test_dyn[i] = btn;
+    }
+    test_combos[0] = combo;
+    ebtn_init_ex(&test_group, test_btns, TEST_BTN_NUM, test_combos, 1, NULL, prv_test_event);
+    test_reg_cnt = 0;
+    prv_test_clear_events();
+}
+
+static void test_lookup(void)
+{
+    SUITE_START("keyindex: lookup of static and dynamic buttons");
+    prv_test_setup();
+    ASSERT(ebtn_set_key_index_storage_ex(&test_group, test_hash, TEST_HASH_SIZE));
+    ASSERT(prv_test_lookup_all());
+
+    /* Registered dynamic buttons are found, in direct and hash range */
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ASSERT(ebtn_register_ex(&test_group, &test_dyn[i]));
+        test_reg[test_reg_cnt++] = &test_dyn[i];
+    }
+    ASSERT(prv_test_lookup_all());
+    ASSERT(!test_group.key_hash_overflow);
+
+    /* Unregister from head, middle and tail, key_idx of later buttons moves */
+    prv_test_unregister(0);
+    prv_test_unregister(15);
+    prv_test_unregister(TEST_DYN_NUM - 1);
+    prv_test_unregister(5);
+    ASSERT(prv_test_lookup_all());
+
+    /* Register again, appended at tail */
+    ASSERT(ebtn_register_ex(&test_group, &test_dyn[15]));
+    test_reg[test_reg_cnt++] = &test_dyn[15];
+    ASSERT(ebtn_register_ex(&test_group, &test_dyn[0]));
+    test_reg[test_reg_cnt++] = &test_dyn[0];
+    ASSERT(prv_test_lookup_all());
+
+    /* Index of button instance and edge feeding by key_id in hash range */
+    ASSERT(ebtn_get_btn_index_by_btn_ex(&test_group, &test_btns[30]) == 30);
+    ASSERT(ebtn_get_btn_index_by_btn_dyn_ex(&test_group, &test_dyn[0]) == TEST_BTN_NUM + test_reg_cnt - 1);
+    ASSERT(ebtn_feed_edge_ex(&test_group, prv_test_key_id(30), 1, 0));
+    ASSERT(ebtn_feed_edge_ex(&test_group, prv_test_dyn_key_id(15), 1, 0));
+    ASSERT(ebtn_feed_edge_ex(&test_group, 999, 1, 0) == 0);
+    ebtn_feed_time_ex(&test_group, 20);
+    ASSERT(prv_test_count_event(TEST_KEY_ANY, EBTN_EVT_ONPRESS) == 2);
+
+    /* Combo-button keys by key_id */
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], prv_test_key_id(3));
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], prv_test_key_id(35));
+    ASSERT(bit_array_get(test_combos[0].comb_key, 3) && bit_array_get(test_combos[0].comb_key, 35));
+    ASSERT(bit_array_num_bits_set(test_combos[0].comb_key, EBTN_MAX_KEYNUM) == 2);
+
+    SUITE_END();
+}
+
+static void test_overflow(void)
+{
+    SUITE_START("keyindex: full hash table falls back to linear search");
+    prv_test_setup();
+
+    /* More key_id in hash range than entries */
+    ASSERT(ebtn_set_key_index_storage_ex(&test_group, test_hash_small, EBTN_ARRAY_SIZE(test_hash_small)));
+    ASSERT(test_group.key_hash_overflow);
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ASSERT(ebtn_register_ex(&test_group, &test_dyn[i]));
+        test_reg[test_reg_cnt++] = &test_dyn[i];
+    }
+    prv_test_unregister(12);
+    ASSERT(prv_test_lookup_all());
+
+    /* Rebuilt into large enough storage */
+    ASSERT(ebtn_set_key_index_storage_ex(&test_group, test_hash, TEST_HASH_SIZE));
+    ASSERT(!test_group.key_hash_overflow);
+    ASSERT(prv_test_lookup_all());
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_lookup();
+    test_overflow();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of button group larger than EBTN_MAX_KEYNUM: state bitmaps in caller storage sized for the group,
+ * buttons and combo-buttons over the built-in size work like the first EBTN_MAX_KEYNUM ones.
+ */
+
+#define TEST_BTN_NUM    (1000)
+#define TEST_DYN_NUM    (24)
+#define TEST_MAX_KEYNUM (TEST_BTN_NUM + TEST_DYN_NUM)
+#define TEST_COMBO_ID   (0x1000)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_BTN_NUM];
+static ebtn_btn_dyn_t test_dyn[TEST_DYN_NUM + 1];
+static ebtn_btn_combo_t test_combos[1];
+static BIT_ARRAY_DEFINE(test_combo_key, TEST_MAX_KEYNUM);
+static EBTN_STATE_STORAGE_DEFINE(test_state_storage, TEST_MAX_KEYNUM);
+static BIT_ARRAY_DEFINE(test_curr_state, TEST_MAX_KEYNUM);
+
+/* Time of the first event of key_id and type, `0xFFFF...` if not sent */
+static ebtn_time_t prv_test_event_time(uint16_t key_id, ebtn_evt_t evt)
+{
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        if (test_evt[i].key_id == key_id && test_evt[i].evt == evt)
+        {
+            return test_evt[i].time;
+        }
+    }
+    return (ebtn_time_t)-1;
+}
+
+/* Process every ms of [test_now, until) with the current state bitmap */
+static void prv_test_run(ebtn_time_t until)
+{
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_EXT_INIT(TEST_COMBO_ID, &test_param, test_combo_key);
+
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    for (int i = 0; i < TEST_DYN_NUM + 1; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(TEST_BTN_NUM + i, &test_param);
+        test_dyn[i] = btn;
+    }
+    memset(test_combo_key, 0x00, sizeof(test_combo_key));
+    test_combos[0] = combo;
+    ebtn_init_ex(&test_group, test_btns, TEST_BTN_NUM, test_combos, 1, NULL, prv_test_event);
+
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+static void test_storage(void)
+{
+    ebtn_time_t deadline;
+
+    SUITE_START("keynum: caller state storage");
+    prv_test_setup();
+
+    /* Built-in storage is too small, group is not processed */
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(100);
+    ASSERT(test_evt_cnt == 0);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    ASSERT(ebtn_get_next_deadline_ex(&test_group, test_now, &deadline) == 0);
+
+    /* Storage must hold all static buttons */
+    ASSERT(ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_BTN_NUM - 1) == 0);
+    ASSERT(ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM) == 1);
+    prv_test_run(200);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_ONPRESS) == 100 + 20);
+
+    /* Dynamic buttons up to storage size */
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ASSERT(ebtn_register_ex(&test_group, &test_dyn[i]));
+    }
+    ASSERT(ebtn_register_ex(&test_group, &test_dyn[TEST_DYN_NUM]) == 0);
+    ASSERT(ebtn_get_total_btn_cnt_ex(&test_group) == TEST_MAX_KEYNUM);
+    ASSERT(ebtn_get_btn_index_by_key_id_ex(&test_group, TEST_MAX_KEYNUM - 1) == TEST_MAX_KEYNUM - 1);
+
+    /* Storage can not be changed after dynamic buttons are registered */
+    ASSERT(ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM) == 0);
+
+    SUITE_END();
+}
+
+static void test_large(void)
+{
+    SUITE_START("keynum: buttons and combo-button over EBTN_MAX_KEYNUM");
+    prv_test_setup();
+    ASSERT(ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM));
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ASSERT(ebtn_register_ex(&test_group, &test_dyn[i]));
+    }
+
+    /* Combo-button of keys in first word, middle and last dynamic button */
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 3);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], 500);
+    ebtn_combo_btn_add_btn_ex(&test_group, &test_combos[0], TEST_MAX_KEYNUM - 1);
+
+    /* Last static button and last dynamic button clicked */
+    bit_array_set(test_curr_state, TEST_BTN_NUM - 1);
+    bit_array_set(test_curr_state, TEST_MAX_KEYNUM - 1);
+    prv_test_run(100);
+    bit_array_clear(test_curr_state, TEST_BTN_NUM - 1);
+    bit_array_clear(test_curr_state, TEST_MAX_KEYNUM - 1);
+    prv_test_run(1000);
+    ASSERT(prv_test_event_time(TEST_BTN_NUM - 1, EBTN_EVT_ONPRESS) == 20);
+    ASSERT(prv_test_event_time(TEST_BTN_NUM - 1, EBTN_EVT_ONCLICK) == 100 + 200);
+    ASSERT(prv_test_event_time(TEST_MAX_KEYNUM - 1, EBTN_EVT_ONCLICK) == 100 + 200);
+    ASSERT(prv_test_event_time(TEST_COMBO_ID, EBTN_EVT_ONPRESS) == (ebtn_time_t)-1);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    /* All keys of combo-button pressed */
+    prv_test_clear_events();
+    bit_array_set(test_curr_state, 3);
+    bit_array_set(test_curr_state, 500);
+    bit_array_set(test_curr_state, TEST_MAX_KEYNUM - 1);
+    prv_test_run(1100);
+    bit_array_clear(test_curr_state, 3);
+    bit_array_clear(test_curr_state, 500);
+    bit_array_clear(test_curr_state, TEST_MAX_KEYNUM - 1);
+    prv_test_run(2000);
+    ASSERT(prv_test_event_time(TEST_COMBO_ID, EBTN_EVT_ONPRESS) == 1000 + 20);
+    ASSERT(prv_test_event_time(TEST_COMBO_ID, EBTN_EVT_ONCLICK) == 1100 + 200);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    /* Only involved buttons got events */
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        ASSERT(test_evt[i].key_id == TEST_COMBO_ID || test_evt[i].key_id == 3 || test_evt[i].key_id == 500 ||
+               test_evt[i].key_id == TEST_MAX_KEYNUM - 1);
+    }
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_storage();
+    test_large();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_matrix.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of keyboard matrix scanner on a simulated matrix without diodes,
+ * pressed keys connect rows and columns, so three corners of a rectangle make the fourth one read active.
+ * Matrix keys start at key_idx 27 and cross a bitmap word boundary.
+ */
+
+#define TEST_ROWS       (4)
+#define TEST_COLS       (10)
+#define TEST_KEY_BASE   (27)
+#define TEST_BTN_NUM    (100)
+#define TEST_MAX_KEYNUM (128)
+
+/* key_idx of key at row and column */
+#define TEST_KEY(r, c) (TEST_KEY_BASE + (r) * TEST_COLS + (c))
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_BTN_NUM];
+static EBTN_STATE_STORAGE_DEFINE(test_state_storage, TEST_MAX_KEYNUM);
+static BIT_ARRAY_DEFINE(test_curr_state, TEST_MAX_KEYNUM);
+static EBTN_MATRIX_STORAGE_DEFINE(test_matrix_storage, TEST_ROWS);
+static ebtn_matrix_t test_matrix;
+
+static uint32_t test_pressed[TEST_ROWS]; /* Keys really pressed */
+static int test_selected;
+static int test_select_cnt, test_read_cnt;
+
+static void prv_test_select(struct ebtn_matrix *matrix, uint16_t row)
+{
+    (void)matrix;
+    test_selected = row == EBTN_MATRIX_ROW_NONE ? -1 : row;
+    test_select_cnt++;
+}
+
+/* Columns connected to the selected row through pressed keys, unused high bits read active */
+static uint32_t prv_test_read(struct ebtn_matrix *matrix, uint16_t row)
+{
+    uint32_t cols;
+
+    (void)matrix;
+    test_read_cnt++;
+    if (test_selected != row)
+    {
+        return 0xDEAD; /* Row is not selected */
+    }
+
+    cols = test_pressed[row];
+    for (int r = 0; r < TEST_ROWS; r++)
+    {
+        if (r != row && (test_pressed[r] & cols))
+        {
+            cols |= test_pressed[r];
+        }
+    }
+    return cols | ~((1U << TEST_COLS) - 1);
+}
+
+static void prv_test_setup(void)
+{
+    for (int i = 0; i < TEST_BTN_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, TEST_BTN_NUM, NULL, 0, NULL, prv_test_event);
+    ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM);
+
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    memset(test_pressed, 0x00, sizeof(test_pressed));
+    test_selected = -1;
+    test_select_cnt = 0;
+    test_read_cnt = 0;
+    prv_test_clear_events();
+}
+
+static void test_scan(void)
+{
+    SUITE_START("matrix: scan writes rows to state bitmap");
+    prv_test_setup();
+    ASSERT(ebtn_matrix_init(&test_matrix, &test_group, test_curr_state, TEST_KEY_BASE, TEST_ROWS, TEST_COLS, test_matrix_storage, prv_test_select,
+                            prv_test_read) == 1);
+
+    /* Keys out of matrix keep their bits */
+    bit_array_set(test_curr_state, TEST_KEY_BASE - 1);
+    bit_array_set(test_curr_state, TEST_KEY(TEST_ROWS, 0));
+
+    test_pressed[0] = 0x003;
+    test_pressed[2] = 0x200;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 0);
+    ASSERT(test_select_cnt == TEST_ROWS + 1 && test_read_cnt == TEST_ROWS);
+    ASSERT(test_selected == -1); /* All rows released after scan */
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(0, 0)));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(0, 1)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(0, 2)));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(2, 9)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(3, 0)));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY_BASE - 1));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(TEST_ROWS, 0)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(TEST_ROWS, 1)));
+
+    /* Columns above cols are masked in raw storage */
+    for (int r = 0; r < TEST_ROWS; r++)
+    {
+        ASSERT((test_matrix.raw[r] & ~((1U << TEST_COLS) - 1)) == 0);
+    }
+
+    SUITE_END();
+}
+
+static void test_ghost(void)
+{
+    SUITE_START("matrix: ghost rectangle is masked");
+    prv_test_setup();
+    ebtn_matrix_init(&test_matrix, &test_group, test_curr_state, TEST_KEY_BASE, TEST_ROWS, TEST_COLS, test_matrix_storage, prv_test_select,
+                     prv_test_read);
+
+    /* (0,0) and (0,1) held */
+    test_pressed[0] = 0x003;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 0);
+
+    /* (3,0) pressed makes (3,1) read active too, both keys of row 3 are ambiguous and keep last state */
+    test_pressed[3] = 0x001;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 1);
+    ASSERT(test_matrix.ghost_scans == 1);
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(0, 0)));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(0, 1)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(3, 0)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(3, 1)));
+
+    /* Key of a third row out of the rectangle is not ambiguous */
+    test_pressed[2] = 0x200;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 1);
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(2, 9)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(3, 1)));
+
+    /* Rectangle gone, real key of row 3 is seen, ghost is not */
+    test_pressed[0] = 0x000;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 0);
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(0, 0)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(0, 1)));
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(3, 0)));
+    ASSERT(!bit_array_get(test_curr_state, TEST_KEY(3, 1)));
+    ASSERT(test_matrix.ghost_scans == 2);
+
+    /* Matrix with diodes reads all keys as they are */
+    test_matrix.flags |= EBTN_MATRIX_FLAG_NO_GHOST;
+    test_pressed[0] = 0x003;
+    ASSERT(ebtn_matrix_scan(&test_matrix) == 0);
+    ASSERT(bit_array_get(test_curr_state, TEST_KEY(3, 1)));
+
+    SUITE_END();
+}
+
+static void test_poll(void)
+{
+    int processed = 0;
+
+    SUITE_START("matrix: poll scan rate and events");
+    prv_test_setup();
+    ebtn_matrix_init(&test_matrix, &test_group, test_curr_state, TEST_KEY_BASE, TEST_ROWS, TEST_COLS, test_matrix_storage, prv_test_select,
+                     prv_test_read);
+    ebtn_matrix_set_scan_rate(&test_matrix, 5, 50);
+
+    /* Idle matrix is scanned at idle rate */
+    for (ebtn_time_t t = 0; t < 1000; t++)
+    {
+        processed += ebtn_matrix_poll(&test_matrix, t);
+    }
+    ASSERT(test_read_cnt / TEST_ROWS == 20);
+    ASSERT(processed == 20);
+    ASSERT(ebtn_matrix_get_next_time(&test_matrix, 1000) == 1000);
+
+    /* Keys of row 0 held, then a key under one of them makes a ghost, which never gets an event through poll */
+    test_pressed[0] = 0x003;
+    test_read_cnt = 0;
+    for (ebtn_time_t t = 1000; t < 1100; t++)
+    {
+        ebtn_matrix_poll(&test_matrix, t);
+    }
+    ASSERT(test_read_cnt / TEST_ROWS >= 100 / 5);
+    ASSERT(prv_test_count_event(TEST_KEY(0, 0), EBTN_EVT_ONPRESS) == 1);
+    ASSERT(prv_test_count_event(TEST_KEY(0, 1), EBTN_EVT_ONPRESS) == 1);
+
+    test_pressed[3] = 0x001;
+    for (ebtn_time_t t = 1100; t < 1200; t++)
+    {
+        ebtn_matrix_poll(&test_matrix, t);
+    }
+    ASSERT(test_matrix.ghosting);
+    ASSERT(prv_test_count_event(TEST_KEY(3, 1), EBTN_EVT_ONPRESS) == 0);
+
+    memset(test_pressed, 0x00, sizeof(test_pressed));
+    for (ebtn_time_t t = 1200; t < 3000; t++)
+    {
+        ebtn_matrix_poll(&test_matrix, t);
+    }
+    ASSERT(prv_test_count_event(TEST_KEY(3, 1), EBTN_EVT_ONPRESS) == 0);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_scan();
+    test_ghost();
+    test_poll();
+
+    return TEST_RESULT();
+}
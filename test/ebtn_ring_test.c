@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+
+#define TEST_EVT_NUM (256) /* Events got by callback of reference button group */
+#include "ebtn_test.h"
+
+/*
+ * Test of event ring, built with EBTN_CONFIG_EVT_RING.
+ * A button group without evt_fn queues the same events a callback gets, oldest first, full ring drops by policy
+ * and counters follow.
+ */
+
+#define TEST_RING_SIZE  (128)
+#define TEST_COMBO_ID   (0x100)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 10, 10);
+
+static ebtn_t test_group, test_ref_group;
+static ebtn_btn_t test_btns[2][3];
+static ebtn_btn_combo_t test_combos[2][1];
+static BIT_ARRAY_DEFINE(test_curr_state, EBTN_MAX_KEYNUM);
+static ebtn_evt_record_t test_ring[TEST_RING_SIZE];
+
+static ebtn_evt_record_t test_buf[TEST_EVT_NUM];
+
+/* Record of event ring equals event got by callback */
+static int prv_test_record_equal(const ebtn_evt_record_t *a, const test_evt_t *b)
+{
+    return a->time == b->time && a->key_id == b->key_id && a->click_cnt == b->click_cnt && a->keepalive_cnt == b->keepalive_cnt && a->evt == b->evt &&
+           a->combo == (b->key_id == TEST_COMBO_ID);
+}
+
+/* Process both button groups every ms of [test_now, until) */
+static void prv_test_run(ebtn_time_t until)
+{
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+        ebtn_process_with_curr_state_ex(&test_ref_group, test_curr_state, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    ebtn_t *groups[2] = {&test_group, &test_ref_group};
+
+    for (int g = 0; g < 2; g++)
+    {
+        ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_INIT(TEST_COMBO_ID, &test_param);
+
+        for (int i = 0; i < 3; i++)
+        {
+            ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+            test_btns[g][i] = btn;
+        }
+        test_combos[g][0] = combo;
+        ASSERT(ebtn_init_ex(groups[g], test_btns[g], 3, test_combos[g], 1, NULL, g == 0 ? NULL : prv_test_event));
+        ebtn_combo_btn_add_btn_ex(groups[g], &test_combos[g][0], 1);
+        ebtn_combo_btn_add_btn_ex(groups[g], &test_combos[g][0], 2);
+    }
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+/* Button 0 clicked twice, combo-button pressed and button 0 held for keep alive events */
+static void prv_test_input(void)
+{
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(50);
+    bit_array_clear(test_curr_state, 0);
+    prv_test_run(100);
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(150);
+    bit_array_clear(test_curr_state, 0);
+    bit_array_set(test_curr_state, 1);
+    bit_array_set(test_curr_state, 2);
+    prv_test_run(200);
+    bit_array_clear(test_curr_state, 1);
+    bit_array_clear(test_curr_state, 2);
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(500);
+    bit_array_clear(test_curr_state, 0);
+    prv_test_run(1000);
+}
+
+static void test_order(void)
+{
+    ebtn_evt_ring_stats_t stats;
+    int n = 0, got;
+
+    SUITE_START("ring: events queued oldest first");
+    prv_test_setup();
+    ASSERT(ebtn_set_evt_ring_storage_ex(&test_group, test_ring, 100) == 0); /* Not power of 2 */
+    ASSERT(ebtn_set_evt_ring_storage_ex(&test_group, test_ring, TEST_RING_SIZE));
+    prv_test_input();
+    ASSERT(test_evt_cnt > 32 && test_evt_cnt < TEST_RING_SIZE);
+    ASSERT(ebtn_events_pending_ex(&test_group) == test_evt_cnt);
+
+    /* Drained in parts, same records as callback */
+    while ((got = ebtn_events_drain_ex(&test_group, &test_buf[n], 5)) > 0)
+    {
+        ASSERT(got <= 5);
+        n += got;
+        ASSERT(ebtn_events_pending_ex(&test_group) == test_evt_cnt - n);
+    }
+    ASSERT(n == test_evt_cnt);
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT(prv_test_record_equal(&test_buf[i], &test_evt[i]));
+    }
+
+    ebtn_events_get_stats_ex(&test_group, &stats, 1);
+    ASSERT(stats.queued == (uint32_t)test_evt_cnt && stats.dropped == 0 && stats.peak == test_evt_cnt);
+    ebtn_events_get_stats_ex(&test_group, &stats, 0);
+    ASSERT(stats.queued == 0 && stats.dropped == 0 && stats.peak == 0);
+
+    SUITE_END();
+}
+
+static void test_policy(void)
+{
+    ebtn_evt_ring_stats_t stats;
+    int n;
+
+    SUITE_START("ring: full built-in ring drops by policy");
+
+    /* Newest dropped, first EBTN_EVT_RING_SIZE events kept */
+    prv_test_setup();
+    prv_test_input();
+    ASSERT(ebtn_events_pending_ex(&test_group) == EBTN_EVT_RING_SIZE);
+    n = ebtn_events_drain_ex(&test_group, test_buf, TEST_EVT_NUM);
+    ASSERT(n == EBTN_EVT_RING_SIZE);
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT(prv_test_record_equal(&test_buf[i], &test_evt[i]));
+    }
+    ebtn_events_get_stats_ex(&test_group, &stats, 0);
+    ASSERT(stats.queued == EBTN_EVT_RING_SIZE && stats.dropped == (uint32_t)(test_evt_cnt - EBTN_EVT_RING_SIZE) && stats.peak == EBTN_EVT_RING_SIZE);
+
+    /* Oldest overwritten, last EBTN_EVT_RING_SIZE events kept */
+    prv_test_setup();
+    ebtn_events_set_policy_ex(&test_group, EBTN_EVT_RING_DROP_OLDEST);
+    prv_test_input();
+    n = ebtn_events_drain_ex(&test_group, test_buf, TEST_EVT_NUM);
+    ASSERT(n == EBTN_EVT_RING_SIZE);
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT(prv_test_record_equal(&test_buf[i], &test_evt[test_evt_cnt - EBTN_EVT_RING_SIZE + i]));
+    }
+    ebtn_events_get_stats_ex(&test_group, &stats, 0);
+    ASSERT(stats.queued == (uint32_t)test_evt_cnt && stats.dropped == (uint32_t)(test_evt_cnt - EBTN_EVT_RING_SIZE));
+    ASSERT(ebtn_events_pending_ex(&test_group) == 0);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_order();
+    test_policy();
+
+    return TEST_RESULT();
+}
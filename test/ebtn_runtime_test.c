@@ -0,0 +1,211 @@
+#define _GNU_SOURCE /* pipe with -std=c99 */
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "ebtn.h"
+#include "ebtn_evdev.h"
+#include "ebtn_runtime.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of Linux tickless runtime, with a pipe standing in for an input device.
+ * Time is CLOCK_MONOTONIC, every case takes a few hundred ms.
+ */
+
+#define TEST_MAX_WAIT (100) /* Max number of waits of a case, against hang on failure */
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 0, 300, 100, 500, 10);
+static const ebtn_btn_param_t test_param_keepalive = EBTN_PARAMS_INIT(20, 0, 20, 300, 100, 100, 10);
+static const ebtn_evdev_keymap_t test_keymap[] = {
+    {KEY_A, 1},
+};
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[1];
+static ebtn_evdev_dev_t test_devs[1];
+static ebtn_evdev_t test_ev;
+static ebtn_runtime_t test_rt;
+
+static int test_stop_evt = -1; /* Event stopping the runtime, `-1` for none */
+
+static void prv_test_stop_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    prv_test_event(btn, evt);
+    if ((int)evt == test_stop_evt)
+    {
+        ebtn_runtime_stop(&test_rt);
+    }
+}
+
+static void prv_test_put(int fd, uint16_t code, int32_t value)
+{
+    struct input_event e;
+
+    memset(&e, 0x00, sizeof(e));
+    e.type = EV_KEY;
+    e.code = code;
+    e.value = value;
+    if (write(fd, &e, sizeof(e)) != (ssize_t)sizeof(e))
+    {
+        ASSERT(0);
+    }
+}
+
+static void prv_test_setup(const ebtn_btn_param_t *param)
+{
+    ebtn_btn_t btn = EBTN_BUTTON_INIT(1, param);
+
+    test_btns[0] = btn;
+    ebtn_init_ex(&test_group, test_btns, 1, NULL, 0, NULL, prv_test_stop_event);
+    prv_test_clear_events();
+    test_stop_evt = -1;
+}
+
+/* Run until an event is got, `0` if it is not got after TEST_MAX_WAIT waits */
+static int prv_test_run_until(ebtn_evt_t evt)
+{
+    for (int i = 0; i < TEST_MAX_WAIT; i++)
+    {
+        if (prv_test_count_event(TEST_KEY_ANY, evt) > 0)
+        {
+            return 1;
+        }
+        if (ebtn_runtime_run_once(&test_rt, 1000) <= 0)
+        {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+/* Run until all buttons are idle and no wakeup comes */
+static void prv_test_run_idle(void)
+{
+    for (int i = 0; i < TEST_MAX_WAIT && ebtn_runtime_run_once(&test_rt, 300) > 0; i++) {}
+}
+
+static void test_evdev(void)
+{
+    int fds[2];
+    uint32_t wakeups;
+
+    SUITE_START("runtime: evdev input and deadlines");
+    prv_test_setup(&test_param_keepalive);
+    ASSERT(pipe(fds) == 0);
+    ASSERT(ebtn_evdev_init(&test_ev, &test_group, test_devs, 1, test_keymap, EBTN_ARRAY_SIZE(test_keymap)) == 1);
+    ASSERT(ebtn_evdev_add_fd(&test_ev, fds[0]) == 1);
+    ASSERT(ebtn_runtime_init(&test_rt, &test_group, &test_ev, NULL) == 1);
+    ASSERT(ebtn_runtime_get_fd(&test_rt) >= 0);
+
+    /* All buttons idle, timer is not armed and there is no wakeup */
+    ASSERT(ebtn_runtime_arm(&test_rt) == 1);
+    ASSERT(!test_rt.armed);
+    ASSERT(ebtn_runtime_run_once(&test_rt, 50) == 0);
+    ASSERT(test_rt.wakeups == 0);
+
+    /* Press is got from input, debounce and keep alive expire by timer */
+    prv_test_put(fds[1], KEY_A, 1);
+    ASSERT(ebtn_runtime_run_once(&test_rt, 1000) == 1);
+    ASSERT(test_rt.armed);
+    ASSERT(prv_test_run_until(EBTN_EVT_ONPRESS));
+    ASSERT(prv_test_run_until(EBTN_EVT_KEEPALIVE));
+    ASSERT(test_rt.timer_wakeups >= 2);
+
+    prv_test_put(fds[1], KEY_A, 0);
+    ASSERT(prv_test_run_until(EBTN_EVT_ONRELEASE));
+
+    /* Back to idle, no more timer wakeups */
+    prv_test_run_idle();
+    ASSERT(!test_rt.armed);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    wakeups = test_rt.wakeups;
+    ASSERT(ebtn_runtime_run_once(&test_rt, 100) == 0);
+    ASSERT(test_rt.wakeups == wakeups);
+    ASSERT(test_rt.wakeups < 20);
+
+    ebtn_runtime_deinit(&test_rt);
+    ebtn_evdev_deinit(&test_ev);
+    close(fds[0]);
+    close(fds[1]);
+    SUITE_END();
+}
+
+static void test_feed(void)
+{
+    ebtn_time_t now;
+
+    SUITE_START("runtime: edges fed by caller and stop");
+    prv_test_setup(&test_param);
+    ASSERT(ebtn_runtime_init(&test_rt, &test_group, NULL, NULL) == 1);
+
+    /* Press fed out of runtime, run returns when ONPRESS is got after debounce */
+    now = test_rt.get_tick();
+    ASSERT(ebtn_feed_edge_ex(&test_group, 1, 1, now) == 1);
+    test_stop_evt = EBTN_EVT_ONPRESS;
+    ASSERT(ebtn_runtime_run(&test_rt) == 1);
+    ASSERT(prv_test_count_event(TEST_KEY_ANY, EBTN_EVT_ONPRESS) == 1);
+    ASSERT(test_rt.timer_wakeups >= 1);
+
+    /* Release, click is got when multi click time expired */
+    now = test_rt.get_tick();
+    ASSERT(ebtn_feed_edge_ex(&test_group, 1, 0, now) == 1);
+    ASSERT(ebtn_runtime_arm(&test_rt) == 1);
+    ASSERT(test_rt.armed);
+    test_stop_evt = EBTN_EVT_ONCLICK;
+    ASSERT(ebtn_runtime_run(&test_rt) == 1);
+    ASSERT(prv_test_count_event(TEST_KEY_ANY, EBTN_EVT_ONRELEASE) == 1);
+    ASSERT(prv_test_count_event(TEST_KEY_ANY, EBTN_EVT_ONCLICK) == 1);
+    ASSERT((ebtn_time_sign_t)(test_rt.get_tick() - now) >= 100);
+
+    prv_test_run_idle();
+    ASSERT(!test_rt.armed);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    ebtn_runtime_deinit(&test_rt);
+    SUITE_END();
+}
+
+static void *prv_test_stop_thread(void *arg)
+{
+    (void)arg;
+    usleep(50 * 1000);
+    ebtn_runtime_stop(&test_rt);
+    return NULL;
+}
+
+static void test_stop(void)
+{
+    pthread_t thread;
+    ebtn_time_t now;
+
+    SUITE_START("runtime: stop from another thread while idle");
+    prv_test_setup(&test_param);
+    ASSERT(ebtn_runtime_init(&test_rt, &test_group, NULL, NULL) == 1);
+
+    /* All buttons idle, run blocks without timer until stop wakes it up */
+    now = test_rt.get_tick();
+    ASSERT(pthread_create(&thread, NULL, prv_test_stop_thread, NULL) == 0);
+    ASSERT(ebtn_runtime_run(&test_rt) == 1);
+    ASSERT(pthread_join(thread, NULL) == 0);
+    ASSERT((ebtn_time_sign_t)(test_rt.get_tick() - now) >= 50);
+    ASSERT(test_rt.wakeups == 0);
+
+    /* Stop requested before run returns at once, and does not wake up next wait */
+    ebtn_runtime_stop(&test_rt);
+    ASSERT(ebtn_runtime_run(&test_rt) == 1);
+    now = test_rt.get_tick();
+    ASSERT(ebtn_runtime_run_once(&test_rt, 30) == 0);
+    ASSERT((ebtn_time_sign_t)(test_rt.get_tick() - now) >= 30);
+
+    ebtn_runtime_deinit(&test_rt);
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_evdev();
+    test_feed();
+    test_stop();
+
+    return TEST_RESULT();
+}
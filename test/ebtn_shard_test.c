@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of sharded processing, built with EBTN_CONFIG_SHARD.
+ * Shards run in caller thread or on worker threads give the same events as processing the whole button group,
+ * and a full shard event buffer drops and counts.
+ */
+
+#define TEST_SHARD_NUM     (4)
+#define TEST_SHARD_EVT_NUM (256)
+#define TEST_THREAD_TICKS  (5000)
+
+static sim_t test_sim[2];
+static ebtn_shard_t test_shards[TEST_SHARD_NUM];
+static ebtn_shard_evt_t test_shard_evts[TEST_SHARD_NUM * TEST_SHARD_EVT_NUM];
+
+typedef struct
+{
+    ebtn_t *group;
+    int shard;
+} test_worker_t;
+
+static void *prv_test_worker(void *arg)
+{
+    test_worker_t *w = arg;
+
+    ebtn_process_shard_ex(w->group, w->shard);
+    return NULL;
+}
+
+/* Shard 0 in caller thread, others on worker threads, a shard without thread runs in caller thread */
+static void prv_test_run_threads(struct ebtn *ebtobj, int shard_cnt, void *arg)
+{
+    pthread_t threads[TEST_SHARD_NUM];
+    test_worker_t workers[TEST_SHARD_NUM];
+    int started[TEST_SHARD_NUM] = {0};
+    int *fail = arg;
+
+    for (int i = 1; i < shard_cnt; i++)
+    {
+        workers[i].group = ebtobj;
+        workers[i].shard = i;
+        started[i] = pthread_create(&threads[i], NULL, prv_test_worker, &workers[i]) == 0;
+        if (!started[i])
+        {
+            (*fail)++;
+            ebtn_process_shard_ex(ebtobj, i);
+        }
+    }
+    ebtn_process_shard_ex(ebtobj, 0);
+    for (int i = 1; i < shard_cnt; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+static void prv_test_reference(int ticks)
+{
+    sim_init(&test_sim[0], 21);
+    ASSERT(sim_setup(&test_sim[0]));
+    sim_run(&test_sim[0], SIM_MODE_TICK, ticks);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+}
+
+static void test_caller(void)
+{
+    SUITE_START("shard: shards in caller thread equal whole group");
+    prv_test_reference(SIM_TICKS);
+
+    /* No shards falls back to whole group, shards of 1 or more cache lines, empty shards */
+    for (int n = 0; n <= TEST_SHARD_NUM; n++)
+    {
+        sim_init(&test_sim[1], 21);
+        ASSERT(sim_setup(&test_sim[1]));
+        ASSERT(ebtn_set_shards_ex(&test_sim[1].group, test_shards, n, test_shard_evts, TEST_SHARD_EVT_NUM));
+        sim_run(&test_sim[1], SIM_MODE_SHARDED, SIM_TICKS);
+        if (!sim_equal(&test_sim[0], &test_sim[1]))
+        {
+            printf("shard: %d shards\n", n);
+            ASSERT(0);
+        }
+        for (int i = 0; i < n; i++)
+        {
+            ASSERT(test_shards[i].evt_dropped == 0);
+        }
+    }
+    ASSERT(ebtn_set_shards_ex(&test_sim[1].group, NULL, 2, test_shard_evts, TEST_SHARD_EVT_NUM) == 0);
+    ASSERT(ebtn_set_shards_ex(&test_sim[1].group, test_shards, 2, test_shard_evts, 0) == 0);
+
+    SUITE_END();
+}
+
+static void test_threads(void)
+{
+    int fail = 0;
+
+    SUITE_START("shard: shards on worker threads equal whole group");
+    prv_test_reference(TEST_THREAD_TICKS);
+
+    sim_init(&test_sim[1], 21);
+    ASSERT(sim_setup(&test_sim[1]));
+    ASSERT(ebtn_set_shards_ex(&test_sim[1].group, test_shards, 2, test_shard_evts, TEST_SHARD_EVT_NUM));
+    test_sim[1].shard_run = prv_test_run_threads;
+    test_sim[1].shard_arg = &fail;
+    sim_run(&test_sim[1], SIM_MODE_SHARDED, TEST_THREAD_TICKS);
+
+    ASSERT(fail == 0);
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+
+    SUITE_END();
+}
+
+static void test_dropped(void)
+{
+    uint32_t dropped = 0;
+
+    SUITE_START("shard: full event buffer drops and counts");
+    prv_test_reference(SIM_TICKS);
+
+    /* Dropped events are only not delivered, buttons process the same */
+    sim_init(&test_sim[1], 21);
+    ASSERT(sim_setup(&test_sim[1]));
+    ASSERT(ebtn_set_shards_ex(&test_sim[1].group, test_shards, 2, test_shard_evts, 1));
+    sim_run(&test_sim[1], SIM_MODE_SHARDED, SIM_TICKS);
+    for (int i = 0; i < 2; i++)
+    {
+        dropped += test_shards[i].evt_dropped;
+    }
+    ASSERT(dropped > 0);
+    ASSERT(test_sim[1].evt_cnt + (int)dropped == test_sim[0].evt_cnt);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_caller();
+    test_threads();
+    test_dropped();
+
+    return TEST_RESULT();
+}
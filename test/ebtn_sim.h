@@ -0,0 +1,339 @@
+#ifndef _EBTN_SIM_H
+#define _EBTN_SIM_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ebtn.h"
+
+/*
+ * Random input scenario shared by the equivalence tests.
+ * A button group of static buttons, dynamic buttons and combo-buttons with a mix of params gets the same random input,
+ * with bounces, clicks and long holds, through different processing paths, and the event logs must be equal.
+ * key_id of a button is its key_idx, combo-buttons have key_id `0x1000 + n`.
+ */
+
+#ifndef SIM_STATIC_NUM
+#define SIM_STATIC_NUM (100)
+#endif
+#ifndef SIM_DYN_NUM
+#define SIM_DYN_NUM (28)
+#endif
+#ifndef SIM_TICKS
+#define SIM_TICKS (20000)
+#endif
+
+#define SIM_KEY_NUM   (SIM_STATIC_NUM + SIM_DYN_NUM)
+#define SIM_COMBO_NUM (4)
+#define SIM_COMBO_ID  (0x1000)
+#define SIM_EVT_NUM   (1 << 16)
+
+/**
+ * \brief           Way the random input is delivered to the button group
+ */
+typedef enum
+{
+    SIM_MODE_TICK = 0, /*!< ebtn_process_with_curr_state_ex() every ms */
+    SIM_MODE_TICKLESS, /*!< ebtn_process_with_curr_state_ex() only on input change and at ebtn_get_next_deadline_ex() */
+    SIM_MODE_FEED,     /*!< ebtn_feed_edge_ex() per changed key, ebtn_feed_time_ex() at deadline */
+#ifdef EBTN_CONFIG_SHARD
+    SIM_MODE_SHARDED, /*!< ebtn_process_sharded_ex() every ms, shards run by shard_run */
+#endif
+} sim_mode_t;
+
+typedef struct sim_evt
+{
+    ebtn_time_t time;
+    uint16_t key_id;
+    uint8_t evt;
+    uint8_t cnt; /*!< keepalive_cnt of keep alive event, click_cnt otherwise */
+} sim_evt_t;
+
+struct sim;
+typedef void (*sim_hook_fn)(struct sim *sim, ebtn_time_t mstime);
+
+typedef struct sim
+{
+    ebtn_t group;
+    ebtn_btn_t btns[SIM_STATIC_NUM];
+    ebtn_btn_dyn_t dyn[SIM_DYN_NUM];
+    ebtn_btn_combo_t combos[SIM_COMBO_NUM];
+    bit_array_t combo_key[SIM_COMBO_NUM][BIT_ARRAY_BITMAP_SIZE(SIM_KEY_NUM)];
+    EBTN_STATE_STORAGE_DEFINE(state_storage, SIM_KEY_NUM);
+#ifdef EBTN_CONFIG_SOA
+    EBTN_SOA_STORAGE_DEFINE(soa_storage, SIM_KEY_NUM);
+#endif
+    BIT_ARRAY_DEFINE(curr_state, SIM_KEY_NUM);
+    uint8_t in[SIM_KEY_NUM]; /*!< Input of every key_idx */
+    uint32_t seed;
+    int last_key;      /*!< Last toggled key, toggled again to make a bounce */
+    sim_hook_fn tick;  /*!< Called every ms before input is delivered, can be `NULL` */
+#ifdef EBTN_CONFIG_SHARD
+    ebtn_shard_run_fn shard_run; /*!< Run function of SIM_MODE_SHARDED, `NULL` runs shards in caller thread */
+    void *shard_arg;             /*!< Argument of shard_run */
+#endif
+    uint8_t one_edge;  /*!< At most one key changes per ms, rest is delayed. Needed to compare with SIM_MODE_FEED,
+                            where a timeout due in the ms of an edge is sent before edges fed later */
+    sim_evt_t evt[SIM_EVT_NUM];
+    int evt_cnt;
+} sim_t;
+
+static const ebtn_btn_param_t sim_params[] = {
+    EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10),
+    EBTN_PARAMS_INIT(0, 0, 0, 100, 50, 50, 3),
+    EBTN_PARAMS_INIT(5, 10, 10, 1000, 300, 100, 5),
+};
+
+/* Keys of combo-buttons, across words and dynamic buttons */
+static const uint16_t sim_combo_keys[SIM_COMBO_NUM][3] = {
+    {1, 2, 0xFFFF},
+    {10, 70, 0xFFFF},
+    {63, 64, SIM_STATIC_NUM + 1},
+    {5, SIM_STATIC_NUM + 3, SIM_KEY_NUM - 1},
+};
+
+static sim_t *sim_curr; /* Scenario receiving events */
+
+static inline uint32_t sim_rand(sim_t *sim)
+{
+    sim->seed = sim->seed * 1103515245U + 12345U;
+    return sim->seed >> 16;
+}
+
+static inline void sim_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    sim_evt_t *e;
+
+    if (sim_curr == NULL || sim_curr->evt_cnt >= SIM_EVT_NUM)
+    {
+        return;
+    }
+    e = &sim_curr->evt[sim_curr->evt_cnt++];
+    e->time = 0; /* Set by sim_run(), time of process */
+    e->key_id = btn->key_id;
+    e->evt = (uint8_t)evt;
+    e->cnt = (uint8_t)(evt == EBTN_EVT_KEEPALIVE ? ebtn_keepalive_get_count(btn) : ebtn_click_get_count(btn));
+}
+
+/**
+ * \brief           Initialize scenario, buttons are not registered to the group yet
+ *
+ * \param[in]       sim: Scenario
+ * \param[in]       seed: Seed of random input
+ */
+static inline void sim_init(sim_t *sim, uint32_t seed)
+{
+    memset(sim, 0x00, sizeof(*sim));
+    for (int i = 0; i < SIM_STATIC_NUM; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &sim_params[i % EBTN_ARRAY_SIZE(sim_params)]);
+        sim->btns[i] = btn;
+    }
+    for (int i = 0; i < SIM_DYN_NUM; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(SIM_STATIC_NUM + i, &sim_params[i % EBTN_ARRAY_SIZE(sim_params)]);
+        sim->dyn[i] = btn;
+    }
+    for (int i = 0; i < SIM_COMBO_NUM; i++)
+    {
+        ebtn_btn_combo_t combo = EBTN_BUTTON_COMBO_EXT_INIT(SIM_COMBO_ID + i, &sim_params[i % EBTN_ARRAY_SIZE(sim_params)], sim->combo_key[i]);
+        sim->combos[i] = combo;
+    }
+    sim->seed = seed;
+    sim->last_key = -1;
+}
+
+/**
+ * \brief           Initialize button group of scenario with all buttons, default group storage is not used
+ *
+ * \param[in]       sim: Scenario
+ * \return          `1` on success, `0` otherwise
+ */
+static inline int sim_setup(sim_t *sim)
+{
+    int ok = 1;
+
+    ok &= ebtn_init_ex(&sim->group, sim->btns, SIM_STATIC_NUM, sim->combos, SIM_COMBO_NUM, NULL, sim_event);
+    ok &= ebtn_set_state_storage_ex(&sim->group, sim->state_storage, SIM_KEY_NUM);
+#ifdef EBTN_CONFIG_SOA
+    {
+        ebtn_soa_t soa = EBTN_SOA_INIT(sim->soa_storage);
+        ok &= ebtn_set_soa_storage_ex(&sim->group, &soa, SIM_KEY_NUM);
+    }
+#endif
+    ok &= ebtn_register_bulk_ex(&sim->group, sim->dyn, SIM_DYN_NUM);
+    for (int i = 0; i < SIM_COMBO_NUM; i++)
+    {
+        for (int k = 0; k < 3 && sim_combo_keys[i][k] != 0xFFFF; k++)
+        {
+            ebtn_combo_btn_add_btn_ex(&sim->group, &sim->combos[i], sim_combo_keys[i][k]);
+        }
+    }
+    return ok;
+}
+
+/* Next ms of random input: a key toggles now and then, sometimes the last one bounces back */
+static inline void sim_input_step(sim_t *sim)
+{
+    uint32_t r = sim_rand(sim);
+
+    switch (r & 0x07)
+    {
+        case 0:
+            sim->last_key = (int)((r >> 3) % SIM_KEY_NUM);
+            sim->in[sim->last_key] = !sim->in[sim->last_key];
+            break;
+        case 1:
+            if (sim->last_key >= 0 && ((r >> 3) & 0x03) == 0)
+            {
+                sim->in[sim->last_key] = !sim->in[sim->last_key];
+            }
+            break;
+        case 2:
+            /* Combo keys pressed together */
+            if (((r >> 3) & 0x0F) == 0)
+            {
+                const uint16_t *keys = sim_combo_keys[(r >> 7) % SIM_COMBO_NUM];
+                uint8_t state = (uint8_t)((r >> 9) & 0x01);
+
+                for (int k = 0; k < 3 && keys[k] != 0xFFFF; k++)
+                {
+                    sim->in[keys[k]] = state;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static inline void sim_set_evt_time(sim_t *sim, int from, ebtn_time_t mstime)
+{
+    for (int i = from; i < sim->evt_cnt; i++)
+    {
+        sim->evt[i].time = mstime;
+    }
+}
+
+/**
+ * \brief           Run scenario for ticks ms from time `0`
+ *
+ * \param[in]       sim: Scenario set up by sim_setup()
+ * \param[in]       mode: Way the input is delivered
+ * \param[in]       ticks: Number of ms to run
+ */
+static inline void sim_run(sim_t *sim, sim_mode_t mode, int ticks)
+{
+    ebtn_time_t deadline = 0;
+    int deadline_valid = 0;
+    int changed, from;
+
+    sim_curr = sim;
+    for (int t = 0; t < ticks; t++)
+    {
+        ebtn_time_t now = (ebtn_time_t)t;
+
+        if (sim->tick != NULL)
+        {
+            sim->tick(sim, now);
+        }
+        sim_input_step(sim);
+        from = sim->evt_cnt;
+
+        changed = 0;
+        for (int i = 0; i < SIM_KEY_NUM; i++)
+        {
+            if (bit_array_get(sim->curr_state, i) != sim->in[i])
+            {
+                bit_array_assign(sim->curr_state, i, sim->in[i]);
+                changed = 1;
+                if (mode == SIM_MODE_FEED)
+                {
+                    ebtn_feed_edge_ex(&sim->group, (uint16_t)i, sim->in[i], now);
+                }
+                if (sim->one_edge)
+                {
+                    break;
+                }
+            }
+        }
+
+        switch (mode)
+        {
+            case SIM_MODE_TICKLESS:
+                if (changed || (deadline_valid && (ebtn_time_sign_t)(now - deadline) >= 0))
+                {
+                    ebtn_process_with_curr_state_ex(&sim->group, sim->curr_state, now);
+                }
+                deadline_valid = ebtn_get_next_deadline_ex(&sim->group, now, &deadline);
+                break;
+            case SIM_MODE_FEED:
+                if (!changed && deadline_valid && (ebtn_time_sign_t)(now - deadline) >= 0)
+                {
+                    ebtn_feed_time_ex(&sim->group, now);
+                }
+                deadline_valid = ebtn_get_next_deadline_ex(&sim->group, now, &deadline);
+                break;
+#ifdef EBTN_CONFIG_SHARD
+            case SIM_MODE_SHARDED:
+                ebtn_process_sharded_ex(&sim->group, sim->curr_state, now, sim->shard_run, sim->shard_arg);
+                break;
+#endif
+            default:
+                ebtn_process_with_curr_state_ex(&sim->group, sim->curr_state, now);
+                break;
+        }
+        sim_set_evt_time(sim, from, now);
+    }
+    sim_curr = NULL;
+}
+
+/**
+ * \brief           Compare event logs of two scenarios, first difference is printed
+ *
+ * \param[in]       a: First scenario
+ * \param[in]       b: Second scenario
+ * \return          `1` if logs are equal, `0` otherwise
+ */
+static inline int sim_equal(const sim_t *a, const sim_t *b)
+{
+    int n = a->evt_cnt < b->evt_cnt ? a->evt_cnt : b->evt_cnt;
+
+    for (int i = 0; i < n; i++)
+    {
+        const sim_evt_t *x = &a->evt[i], *y = &b->evt[i];
+
+        if (x->time != y->time || x->key_id != y->key_id || x->evt != y->evt || x->cnt != y->cnt)
+        {
+            printf("event %d differs: time %u key_id 0x%X evt %u cnt %u, time %u key_id 0x%X evt %u cnt %u\n", i, (unsigned)x->time, x->key_id, x->evt,
+                   x->cnt, (unsigned)y->time, y->key_id, y->evt, y->cnt);
+            return 0;
+        }
+    }
+    if (a->evt_cnt != b->evt_cnt)
+    {
+        printf("event count differs: %d, %d\n", a->evt_cnt, b->evt_cnt);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Count events of a type in the log of scenario
+ *
+ * \param[in]       sim: Scenario
+ * \param[in]       evt: Event type
+ * \return          Number of events
+ */
+static inline int sim_count(const sim_t *sim, ebtn_evt_t evt)
+{
+    int cnt = 0;
+
+    for (int i = 0; i < sim->evt_cnt; i++)
+    {
+        cnt += sim->evt[i].evt == evt;
+    }
+    return cnt;
+}
+
+#endif /* _EBTN_SIM_H */
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of SIMD timeout check, built with EBTN_CONFIG_SOA and EBTN_CONFIG_SIMD.
+ * Every kernel supported by CPU gives the same due mask as a reference, and button groups of different kernels
+ * give the same events as a button group without bulk check. Kernels not supported are skipped.
+ */
+
+#define TEST_ROUNDS (2000)
+
+static const ebtn_simd_kernel_t test_kernels[] = {EBTN_SIMD_SCALAR, EBTN_SIMD_SSE2, EBTN_SIMD_AVX2, EBTN_SIMD_NEON};
+static const char *const test_kernel_names[] = {"scalar", "sse2", "avx2", "neon"};
+
+static ebtn_t test_group;
+static ebtn_time_t test_deadline[BIT_ARRAY_BITS];
+static sim_t test_sim[2];
+
+/* Reference of timeout check kernel */
+static bit_array_val_t prv_test_due(const ebtn_time_t *deadline, int num, ebtn_time_t mstime)
+{
+    bit_array_val_t mask = 0;
+
+    for (int i = 0; i < num; i++)
+    {
+        if (ebtn_timer_sub(mstime, deadline[i]) >= 0)
+        {
+            mask |= (bit_array_val_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+static void test_kernel(void)
+{
+    SUITE_START("simd: due mask of every kernel");
+    ebtn_init_ex(&test_group, NULL, 0, NULL, 0, NULL, prv_test_event);
+
+    /* Auto selects a real kernel, unknown kernel is refused */
+    ASSERT(ebtn_simd_select_ex(&test_group, EBTN_SIMD_AUTO));
+    ASSERT(ebtn_simd_get_ex(&test_group) != EBTN_SIMD_AUTO && test_group.due_kernel != NULL);
+    ASSERT(ebtn_simd_select_ex(&test_group, (ebtn_simd_kernel_t)99) == 0);
+    ASSERT(ebtn_simd_select_ex(&test_group, EBTN_SIMD_OFF));
+    ASSERT(test_group.due_kernel == NULL);
+
+    for (size_t k = 0; k < EBTN_ARRAY_SIZE(test_kernels); k++)
+    {
+        if (!ebtn_simd_select_ex(&test_group, test_kernels[k]))
+        {
+            printf("simd: %s kernel not supported, skipped\n", test_kernel_names[k]);
+            continue;
+        }
+        ASSERT(ebtn_simd_get_ex(&test_group) == test_kernels[k]);
+
+        /* Any number of buttons, deadlines around now and across time wrap */
+        for (int r = 0; r < TEST_ROUNDS; r++)
+        {
+            int num = 1 + (int)(prv_test_rand() % BIT_ARRAY_BITS);
+            ebtn_time_t now = (ebtn_time_t)((r & 1) ? prv_test_rand() : MAX_TIME_VALUE - (prv_test_rand() & 0x3F));
+
+            for (int i = 0; i < num; i++)
+            {
+                uint32_t v = prv_test_rand();
+
+                test_deadline[i] = (ebtn_time_t)((v & 0x100) ? now + (v & 0x7F) - 0x40 : now + (v << 8));
+            }
+            if (test_group.due_kernel(test_deadline, num, now) != prv_test_due(test_deadline, num, now))
+            {
+                ASSERT(0);
+                break;
+            }
+        }
+    }
+
+    SUITE_END();
+}
+
+static void test_events(void)
+{
+    SUITE_START("simd: events of every kernel equal no bulk check");
+    sim_init(&test_sim[0], 9);
+    ASSERT(sim_setup(&test_sim[0]));
+    ASSERT(ebtn_simd_select_ex(&test_sim[0].group, EBTN_SIMD_OFF));
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_KEEPALIVE) > 0);
+
+    for (size_t k = 0; k < EBTN_ARRAY_SIZE(test_kernels); k++)
+    {
+        /* Processing every ms and tickless */
+        for (int mode = SIM_MODE_TICK; mode <= SIM_MODE_TICKLESS; mode++)
+        {
+            sim_init(&test_sim[1], 9);
+            ASSERT(sim_setup(&test_sim[1]));
+            if (!ebtn_simd_select_ex(&test_sim[1].group, test_kernels[k]))
+            {
+                break;
+            }
+            sim_run(&test_sim[1], (sim_mode_t)mode, SIM_TICKS);
+            if (!sim_equal(&test_sim[0], &test_sim[1]))
+            {
+                printf("simd: %s kernel, mode %d\n", test_kernel_names[k], mode);
+                ASSERT(0);
+            }
+        }
+    }
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_kernel();
+    test_events();
+
+    return TEST_RESULT();
+}
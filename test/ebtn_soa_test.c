@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of structure-of-arrays button state, built with EBTN_CONFIG_SOA.
+ * Buttons whose param is not in the full shared param table, state moved to larger caller storage mid-press,
+ * public state of buttons kept up to date, and tickless processing equal to processing every ms.
+ */
+
+#define TEST_PARAM_NUM  (EBTN_SOA_PARAM_NUM + 2)
+#define TEST_DYN_NUM    (70)
+#define TEST_MAX_KEYNUM (TEST_PARAM_NUM + TEST_DYN_NUM)
+
+static ebtn_btn_param_t test_params[TEST_PARAM_NUM];
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[TEST_PARAM_NUM];
+static ebtn_btn_dyn_t test_dyn[TEST_DYN_NUM];
+static EBTN_STATE_STORAGE_DEFINE(test_state_storage, TEST_MAX_KEYNUM);
+static EBTN_SOA_STORAGE_DEFINE(test_soa_storage, TEST_MAX_KEYNUM);
+static BIT_ARRAY_DEFINE(test_curr_state, TEST_MAX_KEYNUM);
+static sim_t test_sim[2];
+
+/* Process every ms of [test_now, until) with the current state bitmap */
+static void prv_test_run(ebtn_time_t until)
+{
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    /* Every button has a param of its own debounce time */
+    for (int i = 0; i < TEST_PARAM_NUM; i++)
+    {
+        ebtn_btn_param_t param = EBTN_PARAMS_INIT(10 + i * 5, 0, 20, 300, 200, 500, 10);
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_params[i]);
+
+        test_params[i] = param;
+        test_btns[i] = btn;
+    }
+    for (int i = 0; i < TEST_DYN_NUM; i++)
+    {
+        ebtn_btn_dyn_t btn = EBTN_BUTTON_DYN_INIT(TEST_PARAM_NUM + i, &test_params[0]);
+        test_dyn[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, TEST_PARAM_NUM, NULL, 0, NULL, prv_test_event);
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+static void test_param_table(void)
+{
+    int idx;
+
+    SUITE_START("soa: params beyond shared param table");
+    prv_test_setup();
+
+    /* First EBTN_SOA_PARAM_NUM params are in the table, others use param of button */
+    for (int i = 0; i < TEST_PARAM_NUM; i++)
+    {
+        ASSERT(test_group.soa.param_idx[i] == (i < EBTN_SOA_PARAM_NUM ? i : EBTN_SOA_PARAM_NONE));
+    }
+
+    for (int i = 0; i < TEST_PARAM_NUM; i++)
+    {
+        bit_array_set(test_curr_state, i);
+    }
+    prv_test_run(200);
+    for (int i = 0; i < TEST_PARAM_NUM; i++)
+    {
+        idx = prv_test_find_event((uint16_t)i, EBTN_EVT_ONPRESS);
+        ASSERT(idx >= 0 && test_evt[idx].time == (ebtn_time_t)(10 + i * 5));
+    }
+
+    /* Click of button out of table */
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    prv_test_run(600);
+    idx = prv_test_find_event(TEST_PARAM_NUM - 1, EBTN_EVT_ONCLICK);
+    ASSERT(idx >= 0 && test_evt[idx].time == 200 + 200 && test_evt[idx].click_cnt == 1);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+
+    SUITE_END();
+}
+
+static void test_storage(void)
+{
+    ebtn_soa_t soa = EBTN_SOA_INIT(test_soa_storage);
+    int idx;
+
+    SUITE_START("soa: state moved to caller storage");
+    prv_test_setup();
+    ASSERT(ebtn_set_state_storage_ex(&test_group, test_state_storage, TEST_MAX_KEYNUM));
+
+    /* Button 0 clicked once and held, in process when storage is changed */
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(50);
+    bit_array_clear(test_curr_state, 0);
+    prv_test_run(100);
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(150);
+    ASSERT(ebtn_click_get_count(&test_btns[0]) == 1);
+    ASSERT(ebtn_is_btn_active(&test_btns[0]));
+
+    ASSERT(ebtn_set_soa_storage_ex(&test_group, &soa, TEST_PARAM_NUM - 1) == 0);
+    ASSERT(ebtn_set_soa_storage_ex(&test_group, &soa, TEST_MAX_KEYNUM));
+
+    /* Dynamic buttons beyond built-in storage */
+    ASSERT(ebtn_register_bulk_ex(&test_group, test_dyn, TEST_DYN_NUM));
+    bit_array_set(test_curr_state, TEST_MAX_KEYNUM - 1);
+    prv_test_run(700);
+
+    /* Keep alive period and click count kept across the move */
+    idx = prv_test_find_event(0, EBTN_EVT_KEEPALIVE);
+    ASSERT(idx >= 0 && test_evt[idx].time == 100 + 10 + 500);
+    idx = prv_test_find_event(0, EBTN_EVT_ONCLICK);
+    ASSERT(idx >= 0 && test_evt[idx].click_cnt == 1); /* Long press ends the click sequence */
+    idx = prv_test_find_event(TEST_MAX_KEYNUM - 1, EBTN_EVT_ONPRESS);
+    ASSERT(idx >= 0 && test_evt[idx].time == 150 + 10);
+    ASSERT(ebtn_is_btn_active(&test_dyn[TEST_DYN_NUM - 1].btn));
+    ASSERT(ebtn_is_btn_in_process(&test_dyn[TEST_DYN_NUM - 1].btn));
+
+    SUITE_END();
+}
+
+static void test_tickless(void)
+{
+    SUITE_START("soa: tickless processing equals processing every ms");
+    for (int i = 0; i < 2; i++)
+    {
+        sim_init(&test_sim[i], 8);
+        ASSERT(sim_setup(&test_sim[i]));
+    }
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    sim_run(&test_sim[1], SIM_MODE_TICKLESS, SIM_TICKS);
+
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_KEEPALIVE) > 0);
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_param_table();
+    test_storage();
+    test_tickless();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of input channel: edges come out in push order, full channel drops and counts,
+ * drained edges set current state of buttons by key_id without losing a short press, fed edges keep their time,
+ * and a producer thread loses or reorders nothing.
+ */
+
+#define TEST_CH_SIZE     (8)
+#define TEST_THREAD_SIZE (64)
+#define TEST_THREAD_NUM  (200000)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+
+static ebtn_input_channel_t test_ch;
+static ebtn_input_edge_t test_edges[TEST_THREAD_SIZE];
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[4];
+static BIT_ARRAY_DEFINE(test_curr_state, EBTN_MAX_KEYNUM);
+
+static void test_fifo(void)
+{
+    ebtn_input_edge_t edge;
+    int ok = 1;
+
+    SUITE_START("spsc: edges in push order, full channel drops");
+    ASSERT(ebtn_input_channel_init(&test_ch, test_edges, 6) == 0); /* Not power of 2 */
+    ASSERT(ebtn_input_channel_init(&test_ch, test_edges, TEST_CH_SIZE));
+    ASSERT(ebtn_input_channel_pop(&test_ch, &edge) == 0);
+
+    for (int i = 0; i < TEST_CH_SIZE; i++)
+    {
+        ASSERT(ebtn_input_channel_push(&test_ch, (uint16_t)i, (uint8_t)(i & 1), (ebtn_time_t)(100 + i)));
+    }
+    ASSERT(ebtn_input_channel_push(&test_ch, 99, 1, 200) == 0);
+    ASSERT(test_ch.dropped == 1);
+    for (int i = 0; i < TEST_CH_SIZE; i++)
+    {
+        ASSERT(ebtn_input_channel_pop(&test_ch, &edge));
+        ASSERT(edge.key_id == i && edge.state == (i & 1) && edge.time == (ebtn_time_t)(100 + i));
+    }
+    ASSERT(ebtn_input_channel_pop(&test_ch, &edge) == 0);
+
+    /* Free running indexes wrap */
+    for (int i = 0; i < 70000 && ok; i++)
+    {
+        ok &= ebtn_input_channel_push(&test_ch, (uint16_t)i, 1, (ebtn_time_t)i);
+        ok &= ebtn_input_channel_pop(&test_ch, &edge) && edge.key_id == (uint16_t)i;
+    }
+    ASSERT(ok);
+    ASSERT(test_ch.dropped == 1);
+
+    SUITE_END();
+}
+
+static void test_drain(void)
+{
+    SUITE_START("spsc: drain into current state");
+    for (int i = 0; i < 4; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(10 + i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 4, NULL, 0, NULL, prv_test_event);
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    ASSERT(ebtn_input_channel_init(&test_ch, test_edges, TEST_CH_SIZE));
+    prv_test_clear_events();
+
+    /* Second edge of a key stays for the next drain, unknown key_id is ignored */
+    ebtn_input_channel_push(&test_ch, 11, 1, 0);
+    ebtn_input_channel_push(&test_ch, 13, 1, 0);
+    ebtn_input_channel_push(&test_ch, 13, 0, 1);
+    ebtn_input_channel_push(&test_ch, 50, 1, 1);
+    ebtn_input_channel_push(&test_ch, 12, 1, 2);
+    ASSERT(ebtn_input_channel_drain_ex(&test_group, &test_ch, test_curr_state) == 2);
+    ASSERT(!bit_array_get(test_curr_state, 0) && bit_array_get(test_curr_state, 1) && !bit_array_get(test_curr_state, 2) &&
+           bit_array_get(test_curr_state, 3));
+    ebtn_process_with_curr_state_ex(&test_group, test_curr_state, 0);
+    ASSERT(ebtn_input_channel_drain_ex(&test_group, &test_ch, test_curr_state) == 3);
+    ASSERT(!bit_array_get(test_curr_state, 0) && bit_array_get(test_curr_state, 1) && bit_array_get(test_curr_state, 2) &&
+           !bit_array_get(test_curr_state, 3));
+    ASSERT(ebtn_input_channel_drain_ex(&test_group, &test_ch, test_curr_state) == 0);
+
+    for (ebtn_time_t t = 1; t <= 21; t++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, t);
+    }
+    ASSERT(prv_test_count_event(TEST_KEY_ANY, EBTN_EVT_ONPRESS) == 2);
+
+    SUITE_END();
+}
+
+static void test_feed(void)
+{
+    SUITE_START("spsc: short press fed with edge time");
+    for (int i = 0; i < 4; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(10 + i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 4, NULL, 0, NULL, prv_test_event);
+    ASSERT(ebtn_input_channel_init(&test_ch, test_edges, TEST_CH_SIZE));
+    prv_test_clear_events();
+
+    /* Press and release pushed before one feed */
+    ebtn_input_channel_push(&test_ch, 11, 1, 100);
+    ebtn_input_channel_push(&test_ch, 11, 0, 180);
+    ebtn_input_channel_push(&test_ch, 50, 1, 190);
+    ASSERT(ebtn_input_channel_feed_ex(&test_group, &test_ch) == 3);
+    ASSERT(test_evt_cnt == 2);
+    ASSERT(test_evt[0].evt == EBTN_EVT_ONPRESS && test_evt[0].time_state_change == 100);
+    ASSERT(test_evt[1].evt == EBTN_EVT_ONRELEASE && test_evt[1].time_state_change == 180);
+
+    ebtn_feed_time_ex(&test_group, 180 + 200);
+    ASSERT(test_evt_cnt == 3 && test_evt[2].evt == EBTN_EVT_ONCLICK);
+
+    SUITE_END();
+}
+
+/* Producer pushes sequence numbers, retries when channel is full */
+static void *prv_test_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t seq = 0; seq < TEST_THREAD_NUM; seq++)
+    {
+        while (!ebtn_input_channel_push(&test_ch, (uint16_t)seq, (uint8_t)(seq & 1), (ebtn_time_t)seq))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_thread(void)
+{
+    pthread_t producer;
+    ebtn_input_edge_t edge;
+    uint32_t expect = 0;
+    int ok = 1;
+
+    SUITE_START("spsc: producer thread and consumer");
+    ASSERT(ebtn_input_channel_init(&test_ch, test_edges, TEST_THREAD_SIZE));
+    ASSERT(pthread_create(&producer, NULL, prv_test_producer, NULL) == 0);
+
+    /* Every edge once, in push order, drained to the end so producer never blocks */
+    while (expect < TEST_THREAD_NUM)
+    {
+        if (!ebtn_input_channel_pop(&test_ch, &edge))
+        {
+            sched_yield();
+            continue;
+        }
+        ok &= edge.time == (ebtn_time_t)expect && edge.key_id == (uint16_t)expect && edge.state == (expect & 1);
+        expect++;
+    }
+    pthread_join(producer, NULL);
+    ASSERT(ok);
+    ASSERT(expect == TEST_THREAD_NUM);
+    ASSERT(ebtn_input_channel_pop(&test_ch, &edge) == 0);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_fifo();
+    test_drain();
+    test_feed();
+    test_thread();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ebtn.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of button runtime statistics, built with EBTN_CONFIG_STATS.
+ * Counters and histograms of a scripted input, reset, and snapshots read by another thread while processing runs.
+ */
+
+#define TEST_THREAD_TICKS (200000)
+
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 200, 500, 10);
+static const ebtn_btn_param_t test_fast_param = EBTN_PARAMS_INIT(0, 0, 0, 100, 1, 1, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[1];
+static uint8_t test_in;
+static volatile int test_done;
+
+static uint8_t prv_test_get_state(struct ebtn_btn *btn)
+{
+    (void)btn;
+    return test_in;
+}
+
+/* Process every ms of [test_now, until) with input state */
+static void prv_test_hold(uint8_t state, ebtn_time_t until)
+{
+    test_in = state;
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_ex(&test_group, test_now);
+    }
+}
+
+static void prv_test_setup(const ebtn_btn_param_t *param)
+{
+    ebtn_btn_t btn = EBTN_BUTTON_INIT(0, param);
+
+    test_btns[0] = btn;
+    ebtn_init_ex(&test_group, test_btns, 1, NULL, 0, prv_test_get_state, prv_test_event);
+    test_in = 0;
+    test_now = 0;
+}
+
+static int prv_test_hist_sum(const uint32_t *hist)
+{
+    int sum = 0;
+
+    for (int i = 0; i < EBTN_STATS_HIST_NUM; i++)
+    {
+        sum += (int)hist[i];
+    }
+    return sum;
+}
+
+static void test_counters(void)
+{
+    ebtn_btn_stats_t stats;
+
+    SUITE_START("stats: counters and histograms");
+    prv_test_setup(&test_param);
+    ASSERT(ebtn_get_btn_stats(NULL, &stats) == 0);
+
+    /* Bounce, click pressed 100 ms, second click 50 ms after first one pressed 30 ms */
+    prv_test_hold(1, 5);
+    prv_test_hold(0, 100);
+    prv_test_hold(1, 220);
+    prv_test_hold(0, 250);
+    prv_test_hold(1, 300);
+    prv_test_hold(0, 1000);
+
+    ASSERT(ebtn_get_btn_stats(&test_btns[0], &stats));
+    ASSERT(stats.transitions == 6);
+    ASSERT(stats.bounces == 1);
+    ASSERT(stats.evt_cnt[EBTN_EVT_ONPRESS] == 2 && stats.evt_cnt[EBTN_EVT_ONRELEASE] == 2);
+    ASSERT(stats.evt_cnt[EBTN_EVT_ONCLICK] == 1 && stats.evt_cnt[EBTN_EVT_KEEPALIVE] == 0);
+
+    /* Bucket `i` counts [2^(i-1), 2^i) ms */
+    ASSERT(stats.press_hist[7] == 1 && stats.press_hist[5] == 1 && prv_test_hist_sum(stats.press_hist) == 2);
+    ASSERT(stats.click_gap_hist[6] == 1 && prv_test_hist_sum(stats.click_gap_hist) == 1);
+    ASSERT((stats.seq & 1) == 0);
+
+    /* Long hold, longest bucket counts everything longer */
+    prv_test_hold(1, 1000 + 100000);
+    prv_test_hold(0, 1000 + 100100);
+    ASSERT(ebtn_get_btn_stats(&test_btns[0], &stats));
+    ASSERT(stats.press_hist[EBTN_STATS_HIST_NUM - 1] == 1);
+    ASSERT(stats.evt_cnt[EBTN_EVT_KEEPALIVE] == (100000 - 20) / 500);
+
+    ebtn_reset_btn_stats(&test_btns[0]);
+    ASSERT(ebtn_get_btn_stats(&test_btns[0], &stats));
+    ASSERT(stats.transitions == 0 && stats.bounces == 0 && stats.evt_cnt[EBTN_EVT_ONPRESS] == 0);
+    ASSERT(prv_test_hist_sum(stats.press_hist) == 0 && prv_test_hist_sum(stats.click_gap_hist) == 0);
+
+    SUITE_END();
+}
+
+/* Reader thread, snapshots are never torn and counters never go back */
+static void *prv_test_reader(void *arg)
+{
+    ebtn_btn_stats_t stats, last;
+    int *bad = arg;
+    int reads = 0;
+    int pending;
+
+    memset(&last, 0x00, sizeof(last));
+    do
+    {
+        ebtn_get_btn_stats(&test_btns[0], &stats);
+
+        /* Press histogram is updated right before on-release is counted */
+        pending = prv_test_hist_sum(stats.press_hist) - (int)stats.evt_cnt[EBTN_EVT_ONRELEASE];
+        if ((stats.seq & 1) != 0 || pending < 0 || pending > 1 || stats.transitions < last.transitions ||
+            stats.evt_cnt[EBTN_EVT_KEEPALIVE] < last.evt_cnt[EBTN_EVT_KEEPALIVE] || stats.bounces > stats.transitions)
+        {
+            (*bad)++;
+        }
+        last = stats;
+        reads++;
+        sched_yield();
+    } while (!test_done);
+    return (void *)(long)reads;
+}
+
+static void test_thread(void)
+{
+    pthread_t reader;
+    void *reads;
+    int bad = 0;
+
+    SUITE_START("stats: snapshot read by another thread");
+    prv_test_setup(&test_fast_param);
+    test_done = 0;
+    ASSERT(pthread_create(&reader, NULL, prv_test_reader, &bad) == 0);
+
+    /* Toggle every few ms, every event type */
+    for (int i = 0; i < TEST_THREAD_TICKS; i++)
+    {
+        prv_test_hold((uint8_t)((i % 7) < 4), test_now + 1);
+    }
+    test_done = 1;
+    pthread_join(reader, &reads);
+
+    ASSERT(bad == 0);
+    ASSERT((long)reads > 0);
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_counters();
+    test_thread();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+#ifndef _EBTN_TEST_H
+#define _EBTN_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+
+/*
+ * Minimal test helpers shared by the feature tests, same output as example_test.c.
+ * Every test is a standalone program, exit code is `0` if all asserts pass.
+ * Tests log events with prv_test_event() and check them with prv_test_find_event(), and keep only their scenario.
+ */
+
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0;
+static int tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            printf("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                                \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+}
+
+static void SUITE_END(void)
+{
+    size_t suite_i;
+
+    printf("Testing %s ", suite_name);
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+    {
+        printf(".");
+    }
+    printf("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+    {
+        suites_failed++;
+    }
+}
+
+/**
+ * \brief           Print result of all suites
+ *
+ * \return          `0` if all tests pass, `1` otherwise
+ */
+static int TEST_RESULT(void)
+{
+    printf("%d suites, %d failed, %d asserts, %d failed\n", suites_run, suites_failed, tests_run, tests_failed);
+    return tests_failed != 0;
+}
+
+#ifndef TEST_EVT_NUM
+#define TEST_EVT_NUM (64) /* Max number of events logged, more are dropped */
+#endif
+
+#define TEST_KEY_ANY (0xFFFF) /* key_id matching events of all buttons */
+
+/**
+ * \brief           Event logged by prv_test_event()
+ */
+typedef struct test_evt
+{
+    ebtn_time_t time;              /* test_now when event was sent */
+    ebtn_time_t time_state_change; /* Time of last state change of button when event was sent */
+    uint16_t key_id;               /* key_id of button */
+    uint16_t click_cnt;            /* click_cnt of button */
+    uint16_t keepalive_cnt;        /* keepalive_cnt of button */
+    uint8_t evt;                   /* Event type */
+} test_evt_t;
+
+static ebtn_time_t test_now;              /* Time of the test, set by test before process */
+static test_evt_t test_evt[TEST_EVT_NUM]; /* Event log */
+static int test_evt_cnt;                  /* Number of logged events */
+static uint32_t test_seed = 1;            /* Seed of prv_test_rand() */
+
+/**
+ * \brief           Event callback logging every event
+ */
+static void prv_test_event(struct ebtn_btn *btn, ebtn_evt_t evt)
+{
+    test_evt_t *e;
+
+    if (test_evt_cnt >= TEST_EVT_NUM)
+    {
+        return;
+    }
+
+    /* Padding is cleared, logs of two runs can be compared with memcmp() */
+    e = &test_evt[test_evt_cnt++];
+    memset(e, 0x00, sizeof(*e));
+    e->time = test_now;
+    e->time_state_change = btn->time_state_change;
+    e->key_id = btn->key_id;
+    e->click_cnt = ebtn_click_get_count(btn);
+    e->keepalive_cnt = ebtn_keepalive_get_count(btn);
+    e->evt = (uint8_t)evt;
+}
+
+/**
+ * \brief           Clear event log
+ */
+static void prv_test_clear_events(void)
+{
+    test_evt_cnt = 0;
+}
+
+/**
+ * \brief           Find first logged event of a button
+ *
+ * \param[in]       key_id: key_id of button, `TEST_KEY_ANY` for all buttons
+ * \param[in]       evt: Event type
+ * \return          Index in log, `-1` if not found
+ */
+static int prv_test_find_event(uint16_t key_id, ebtn_evt_t evt)
+{
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        if ((key_id == TEST_KEY_ANY || test_evt[i].key_id == key_id) && test_evt[i].evt == (uint8_t)evt)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * \brief           Count logged events of a button
+ *
+ * \param[in]       key_id: key_id of button, `TEST_KEY_ANY` for all buttons
+ * \param[in]       evt: Event type
+ * \return          Number of events
+ */
+static int prv_test_count_event(uint16_t key_id, ebtn_evt_t evt)
+{
+    int cnt = 0;
+
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        cnt += (key_id == TEST_KEY_ANY || test_evt[i].key_id == key_id) && test_evt[i].evt == (uint8_t)evt;
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Pseudo random number of 15 bits, same sequence for the same test_seed
+ */
+static uint32_t prv_test_rand(void)
+{
+    test_seed = test_seed * 1103515245U + 12345U;
+    return test_seed >> 16;
+}
+
+#endif /* _EBTN_TEST_H */
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_vdebounce.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of vertical counter debounce: stable state toggles after exactly `1 << planes` consecutive differing samples,
+ * and random input matches a per-line counter reference.
+ * Built with EBTN_CONFIG_SOA and EBTN_CONFIG_SIMD, every kernel supported by CPU is run.
+ */
+
+#define TEST_MAX_LINES (1000) /* Not a multiple of any kernel step, lines left by vector kernels are counted too */
+#define TEST_TICKS     (2000)
+
+static EBTN_VDEBOUNCE_STORAGE_DEFINE(test_storage, TEST_MAX_LINES);
+static BIT_ARRAY_DEFINE(test_raw, TEST_MAX_LINES);
+static ebtn_vdebounce_t test_vd;
+
+static uint8_t test_in[TEST_MAX_LINES];
+static uint8_t test_ref[TEST_MAX_LINES];
+static uint8_t test_ref_cnt[TEST_MAX_LINES];
+
+/* Raw bitmap of input, bits above num_bits are set to check they are masked */
+static void prv_test_raw(int num_bits)
+{
+    memset(test_raw, 0xFF, sizeof(test_raw));
+    for (int i = 0; i < num_bits; i++)
+    {
+        bit_array_assign(test_raw, i, test_in[i]);
+    }
+}
+
+static int prv_test_stable_padding_clear(int num_bits)
+{
+    for (int i = num_bits; i < test_vd.words * (int)BIT_ARRAY_BITS; i++)
+    {
+        if (bit_array_get(ebtn_vdebounce_get_state(&test_vd), i))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void prv_test_threshold(int samples)
+{
+    int num_bits = 3;
+
+    ASSERT(ebtn_vdebounce_init(&test_vd, test_storage, num_bits, (uint8_t)samples) == 1);
+    memset(test_in, 0x00, sizeof(test_in));
+
+    /* Line 0 pressed, stable after exactly samples samples */
+    test_in[0] = 1;
+    prv_test_raw(num_bits);
+    for (int i = 0; i < samples - 1; i++)
+    {
+        ASSERT(ebtn_vdebounce_update(&test_vd, test_raw) == 0);
+    }
+    ASSERT(!bit_array_get(ebtn_vdebounce_get_state(&test_vd), 0));
+    ASSERT(ebtn_vdebounce_update(&test_vd, test_raw) == 1);
+    ASSERT(bit_array_get(ebtn_vdebounce_get_state(&test_vd), 0));
+    ASSERT(!bit_array_get(ebtn_vdebounce_get_state(&test_vd), 1));
+    ASSERT(prv_test_stable_padding_clear(num_bits));
+
+    /* Bounce on release, a sample equal to stable state restarts the count */
+    test_in[0] = 0;
+    prv_test_raw(num_bits);
+    for (int i = 0; i < samples - 1; i++)
+    {
+        ebtn_vdebounce_update(&test_vd, test_raw);
+    }
+    test_in[0] = 1;
+    prv_test_raw(num_bits);
+    ASSERT(ebtn_vdebounce_update(&test_vd, test_raw) == 0);
+    test_in[0] = 0;
+    prv_test_raw(num_bits);
+    for (int i = 0; i < samples - 1; i++)
+    {
+        ASSERT(ebtn_vdebounce_update(&test_vd, test_raw) == 0);
+    }
+    ASSERT(bit_array_get(ebtn_vdebounce_get_state(&test_vd), 0));
+    ASSERT(ebtn_vdebounce_update(&test_vd, test_raw) == 1);
+    ASSERT(!bit_array_get(ebtn_vdebounce_get_state(&test_vd), 0));
+}
+
+static void prv_test_random(int samples, int num_bits)
+{
+    int changed, ok = 1;
+
+    ASSERT(ebtn_vdebounce_init(&test_vd, test_storage, num_bits, (uint8_t)samples) == 1);
+    memset(test_in, 0x00, sizeof(test_in));
+    memset(test_ref, 0x00, sizeof(test_ref));
+    memset(test_ref_cnt, 0x00, sizeof(test_ref_cnt));
+    test_seed = (uint32_t)(samples * 7919 + num_bits);
+
+    for (int t = 0; t < TEST_TICKS && ok; t++)
+    {
+        changed = 0;
+        for (int i = 0; i < num_bits; i++)
+        {
+            if (prv_test_rand() % 100 < 8)
+            {
+                test_in[i] = !test_in[i];
+            }
+            if (test_in[i] == test_ref[i])
+            {
+                test_ref_cnt[i] = 0;
+            }
+            else if (++test_ref_cnt[i] == samples)
+            {
+                test_ref[i] = test_in[i];
+                test_ref_cnt[i] = 0;
+                changed = 1;
+            }
+        }
+        prv_test_raw(num_bits);
+
+        ok = ebtn_vdebounce_update(&test_vd, test_raw) == changed;
+        for (int i = 0; i < num_bits && ok; i++)
+        {
+            ok = bit_array_get(ebtn_vdebounce_get_state(&test_vd), i) == test_ref[i];
+        }
+        ok = ok && prv_test_stable_padding_clear(num_bits);
+    }
+    ASSERT(ok);
+}
+
+static void test_vdebounce(const char *name)
+{
+    static const int lines[] = {1, 63, 333, TEST_MAX_LINES};
+
+    SUITE_START(name);
+    for (int samples = 2; samples <= (1 << EBTN_VDEBOUNCE_MAX_PLANES); samples *= 2)
+    {
+        prv_test_threshold(samples);
+        for (size_t i = 0; i < EBTN_ARRAY_SIZE(lines); i++)
+        {
+            prv_test_random(samples, lines[i]);
+        }
+    }
+
+    /* Only powers of 2 up to 2^EBTN_VDEBOUNCE_MAX_PLANES samples */
+    ASSERT(ebtn_vdebounce_init(&test_vd, test_storage, 10, 3) == 0);
+    ASSERT(ebtn_vdebounce_init(&test_vd, test_storage, 10, 1 << (EBTN_VDEBOUNCE_MAX_PLANES + 1)) == 0);
+    SUITE_END();
+}
+
+int main(void)
+{
+#ifdef EBTN_CONFIG_SIMD
+    static const ebtn_simd_kernel_t kernels[] = {EBTN_SIMD_SCALAR, EBTN_SIMD_SSE2, EBTN_SIMD_AVX2};
+    static const char *const names[] = {"vdebounce: scalar kernel", "vdebounce: sse2 kernel", "vdebounce: avx2 kernel"};
+
+    for (size_t i = 0; i < EBTN_ARRAY_SIZE(kernels); i++)
+    {
+        /* Kernel is taken by ebtn_vdebounce_init(), skipped when not supported by CPU */
+        if (ebtn_simd_select(kernels[i]))
+        {
+            test_vdebounce(names[i]);
+        }
+    }
+#else
+    test_vdebounce("vdebounce: scalar");
+#endif
+
+    return TEST_RESULT();
+}
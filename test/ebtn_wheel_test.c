@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <string.h>
+#include "ebtn.h"
+#include "ebtn_sim.h"
+#include "ebtn_test.h"
+
+/*
+ * Test of timer wheel scheduling, built with EBTN_CONFIG_TIMER_WHEEL.
+ * Timeouts of every wheel level fire at the same ms as the per-process scan would send them,
+ * a late process sends all elapsed timeouts, and processing only at the deadline gives the same events.
+ */
+
+/* Multi-click time crosses level 1, keep alive period crosses level 2 */
+static const ebtn_btn_param_t test_param = EBTN_PARAMS_INIT(20, 0, 20, 300, 5000, 60000, 10);
+
+static ebtn_t test_group;
+static ebtn_btn_t test_btns[2];
+static BIT_ARRAY_DEFINE(test_curr_state, EBTN_MAX_KEYNUM);
+static sim_t test_sim[3];
+
+/* Time of the n-th event of key_id and type, `0xFFFF...` if not sent */
+static ebtn_time_t prv_test_event_time(uint16_t key_id, ebtn_evt_t evt, int n)
+{
+    for (int i = 0; i < test_evt_cnt; i++)
+    {
+        if (test_evt[i].key_id == key_id && test_evt[i].evt == evt && n-- == 0)
+        {
+            return test_evt[i].time;
+        }
+    }
+    return (ebtn_time_t)-1;
+}
+
+/* Process every ms of [test_now, until) with the current state bitmap */
+static void prv_test_run(ebtn_time_t until)
+{
+    for (; test_now < until; test_now++)
+    {
+        ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+    }
+}
+
+static void prv_test_setup(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        ebtn_btn_t btn = EBTN_BUTTON_INIT(i, &test_param);
+        test_btns[i] = btn;
+    }
+    ebtn_init_ex(&test_group, test_btns, 2, NULL, 0, NULL, prv_test_event);
+    memset(test_curr_state, 0x00, sizeof(test_curr_state));
+    test_now = 0;
+    prv_test_clear_events();
+}
+
+static void test_levels(void)
+{
+    SUITE_START("wheel: timeouts of every level fire in time");
+    prv_test_setup();
+
+    /* Button 0 held, button 1 clicked */
+    bit_array_set(test_curr_state, 0);
+    bit_array_set(test_curr_state, 1);
+    prv_test_run(100);
+    bit_array_clear(test_curr_state, 1);
+    prv_test_run(131000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_ONPRESS, 0) == 20);
+    ASSERT(prv_test_event_time(1, EBTN_EVT_ONRELEASE, 0) == 100);
+    ASSERT(prv_test_event_time(1, EBTN_EVT_ONCLICK, 0) == 100 + 5000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_KEEPALIVE, 0) == 20 + 60000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_KEEPALIVE, 1) == 20 + 120000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_KEEPALIVE, 2) == (ebtn_time_t)-1);
+    ASSERT(test_group.timer_wheel.cnt == 1);
+
+    /* Released after long press, no click and no timer left */
+    bit_array_clear(test_curr_state, 0);
+    prv_test_run(132000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_ONRELEASE, 0) == 131000);
+    ASSERT(prv_test_event_time(0, EBTN_EVT_ONCLICK, 0) == (ebtn_time_t)-1);
+    ASSERT(!ebtn_is_in_process_ex(&test_group));
+    ASSERT(test_group.timer_wheel.cnt == 0);
+
+    SUITE_END();
+}
+
+static void test_late(void)
+{
+    SUITE_START("wheel: late process sends all elapsed timeouts");
+    prv_test_setup();
+
+    bit_array_set(test_curr_state, 0);
+    prv_test_run(30);
+    ASSERT(test_evt_cnt == 1);
+
+    /* Processing stalls past three keep alive periods */
+    test_now = 200030;
+    ebtn_process_with_curr_state_ex(&test_group, test_curr_state, test_now);
+    ASSERT(test_evt_cnt == 4);
+    for (int i = 1; i < 4; i++)
+    {
+        ASSERT(test_evt[i].evt == EBTN_EVT_KEEPALIVE && test_evt[i].time == 200030 && test_evt[i].keepalive_cnt == i);
+    }
+
+    /* Next keep alive keeps the period phase */
+    test_now++;
+    prv_test_run(240020);
+    ASSERT(test_evt_cnt == 4);
+    prv_test_run(240021);
+    ASSERT(test_evt_cnt == 5 && test_evt[4].keepalive_cnt == 4);
+
+    SUITE_END();
+}
+
+static void test_tickless(void)
+{
+    SUITE_START("wheel: tickless and feed processing equal processing every ms");
+    for (int i = 0; i < 3; i++)
+    {
+        sim_init(&test_sim[i], 4);
+        test_sim[i].one_edge = 1;
+        ASSERT(sim_setup(&test_sim[i]));
+    }
+    sim_run(&test_sim[0], SIM_MODE_TICK, SIM_TICKS);
+    sim_run(&test_sim[1], SIM_MODE_TICKLESS, SIM_TICKS);
+    sim_run(&test_sim[2], SIM_MODE_FEED, SIM_TICKS);
+
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_ONCLICK) > 0);
+    ASSERT(sim_count(&test_sim[0], EBTN_EVT_KEEPALIVE) > 0);
+    ASSERT(sim_equal(&test_sim[0], &test_sim[1]));
+    ASSERT(sim_equal(&test_sim[0], &test_sim[2]));
+
+    SUITE_END();
+}
+
+int main(void)
+{
+    test_levels();
+    test_late();
+    test_tickless();
+
+    return TEST_RESULT();
+}